@@ -0,0 +1,10 @@
+#version 330 core
+
+uniform sampler2D layerTexture;
+in vec2 uv;
+out vec4 fragmentColor;
+
+void main(void)
+{
+    fragmentColor = texture(layerTexture, uv);
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#version 330 core
+
+uniform vec2 viewportSize;
+uniform vec3 selectionColor;
+uniform bool hasOutline;
+uniform bool outlineOverride;   // Whether the outline has the selection color (otherwise the point color)
+uniform float outlineOpacity;
+uniform bool haloEnabled;       // Whether the outline fades out
+
+flat in vec2 center;
+flat in float radius;
+flat in float outerRadius;
+flat in vec3 pointColor;
+flat in float opacity;
+flat in int selected;
+
+out vec4 fragmentColor;
+
+// Anti-aliased coverage of a disk (the same as the software point renderer)
+float getCoverage(float diskRadius, float distanceToCenter) {
+	return clamp(diskRadius + 0.5 - distanceToCenter, 0.0, 1.0);
+}
+
+void main(void)
+{
+	// Distance of the pixel center to the point center (top-left origin)
+	float distanceToCenter = length(vec2(gl_FragCoord.x, viewportSize.y - gl_FragCoord.y) - center);
+
+	if (distanceToCenter >= outerRadius + 0.5)
+		discard;
+
+	float diskAlpha = opacity * getCoverage(radius, distanceToCenter);
+
+	// Unselected points, or selected points in the selection color
+	if (selected == 0 || !hasOutline) {
+		fragmentColor = vec4((selected == 0 ? pointColor : selectionColor) * diskAlpha, diskAlpha);
+		return;
+	}
+
+	// Selected points have an outline ring under the disk
+	float ringWidth		= outerRadius - radius;
+	float ringCoverage	= getCoverage(outerRadius, distanceToCenter) - (radius > 0.0 ? getCoverage(radius, distanceToCenter) : 0.0);
+
+	if (haloEnabled && ringWidth > 0.0)
+		ringCoverage *= clamp(1.0 - (distanceToCenter - radius) / ringWidth, 0.0, 1.0);
+
+	float ringAlpha = outlineOpacity * max(0.0, ringCoverage);
+
+	// Premultiplied disk over ring
+	fragmentColor = vec4(pointColor * diskAlpha + (1.0 - diskAlpha) * ringAlpha * (outlineOverride ? selectionColor : pointColor), diskAlpha + (1.0 - diskAlpha) * ringAlpha);
+}
@@ -0,0 +1,80 @@
+#version 330 core
+
+// Per-point attributes (one instance of the quad per point)
+layout(location = 0) in vec2 position;
+layout(location = 1) in float colorScalar;
+layout(location = 2) in vec4 packedColor;
+layout(location = 3) in float highlight;
+layout(location = 4) in float sizeSource;
+layout(location = 5) in float opacitySource;
+
+uniform vec4 bounds;            // Data bounds (left, top, width, height)
+uniform vec4 dataRectangle;     // Rectangle which covers the data bounds (left, top, width, height in pixels, top-left origin)
+uniform vec2 viewportSize;
+uniform float pointScale;
+uniform vec3 sizeMapping;       // Point size mapping (offset, scale, selection offset)
+uniform vec3 opacityMapping;    // Point opacity mapping (offset, scale, selection offset)
+uniform int effect;             // Point colors (0: colors, 1: color map, 2: 2D color map)
+uniform bool hasColorScalars;
+uniform vec3 colorMapRange;     // Minimum, maximum and length
+uniform sampler2D colorMap;
+uniform ivec2 colorMapSize;
+uniform bool hasOutline;
+uniform float outlineScale;
+uniform int selectionPass;      // Draw the unselected (0) or the selected (1) points
+
+flat out vec2 center;           // Point center (in pixels, top-left origin)
+flat out float radius;
+flat out float outerRadius;     // Radius including the selection outline
+flat out vec3 pointColor;
+flat out float opacity;
+flat out int selected;
+
+float mapScalar(vec3 mapping, float source, bool isSelected) {
+	return mapping.x + mapping.y * source + (isSelected ? mapping.z : 0.0);
+}
+
+vec3 getPointColor() {
+	if (colorMapSize.x <= 0 && effect != 0)
+		return vec3(0.0);
+
+	// Without scalars the color map is sampled at the start
+	if (effect == 1) {
+		float normalizedValue = hasColorScalars ? clamp((colorScalar - colorMapRange.x) * (colorMapRange.z > 0.0 ? 1.0 / colorMapRange.z : 0.0), 0.0, 1.0) : 0.0;
+
+		return texelFetch(colorMap, ivec2(min(colorMapSize.x - 1, int(normalizedValue * float(colorMapSize.x))), colorMapSize.y / 2), 0).rgb;
+	}
+
+	if (effect == 2) {
+		vec2 uv = clamp(vec2(position.x - bounds.x, position.y - (bounds.y - bounds.w)) / bounds.zw, 0.0, 1.0);
+
+		return texelFetch(colorMap, ivec2(min(colorMapSize.x - 1, int(uv.x * float(colorMapSize.x))), min(colorMapSize.y - 1, int((1.0 - uv.y) * float(colorMapSize.y)))), 0).rgb;
+	}
+
+	// Packed 0xRRGGBB colors are read as (blue, green, red, zero)
+	return packedColor.zyx;
+}
+
+void main() {
+	bool isSelected = highlight != 0.0;
+
+	center		= dataRectangle.xy + vec2(position.x - bounds.x, bounds.y - position.y) * (dataRectangle.zw / bounds.zw);
+	radius		= 0.5 * pointScale * max(0.0, mapScalar(sizeMapping, sizeSource, isSelected));
+	outerRadius	= hasOutline && isSelected ? radius * (1.0 + max(0.0, outlineScale)) : radius;
+
+	// Points of the other pass, empty and invalid points are moved outside the clip volume
+	if (int(isSelected) != selectionPass || !(outerRadius > 0.0) || isnan(center.x) || isnan(center.y) || isinf(center.x) || isinf(center.y)) {
+		gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+		return;
+	}
+
+	pointColor	= getPointColor();
+	opacity		= clamp(mapScalar(opacityMapping, opacitySource, isSelected), 0.0, 1.0);
+	selected	= int(isSelected);
+
+	// The quad covers the anti-aliased border of the point
+	vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 2.0 - 1.0;
+	vec2 pixel	= center + corner * (outerRadius + 1.0);
+
+	gl_Position = vec4(2.0 * pixel.x / viewportSize.x - 1.0, 1.0 - 2.0 * pixel.y / viewportSize.y, 0.0, 1.0);
+}
@@ -0,0 +1,197 @@
+#include "AggregatePlotAction.h"
+#include "Application.h"
+
+#include "ViewerScatterplotPlugin.h"
+#include "ViewerScatterplotWidget.h"
+
+#include <algorithm>
+
+using namespace hdps::gui;
+
+AggregatePlotAction::AggregatePlotAction(PlotAction* plotAction, ViewerScatterplotPlugin* viewerscatterplotPlugin) :
+    PluginAction(plotAction, viewerscatterplotPlugin, "Aggregate"),
+    _shapeAction(this, "Shape", { "Hexagon", "Square" }),
+    _resolutionAction(this, "Bins", 8, 256, DEFAULT_RESOLUTION, DEFAULT_RESOLUTION),
+    _statisticAction(this, "Statistic", { "Count", "Mean", "Median" }),
+    _valueDatasetPickerAction(this, "Value data"),
+    _valueDimensionAction(this, "Value dim"),
+    _valueDataset()
+{
+    setToolTip("Aggregate plot settings");
+    setSerializationName("AggregatePlot");
+
+    _shapeAction.setSerializationName("Shape");
+    _resolutionAction.setSerializationName("Resolution");
+    _statisticAction.setSerializationName("Statistic");
+    _valueDatasetPickerAction.setSerializationName("ValueDataset");
+    _valueDimensionAction.setSerializationName("ValueDimension");
+
+    _shapeAction.setToolTip("Shape of the bins");
+    _resolutionAction.setToolTip("Number of bins along the horizontal axis");
+    _statisticAction.setToolTip("Color the bins by the number of points, or by the mean/median of a dimension");
+    _valueDatasetPickerAction.setToolTip("Dataset which contains the value dimension");
+    _valueDimensionAction.setToolTip("Dimension of which the bins take the mean/median");
+
+    _viewerscatterplotPlugin->getWidget().addAction(&_shapeAction);
+    _viewerscatterplotPlugin->getWidget().addAction(&_resolutionAction);
+    _viewerscatterplotPlugin->getWidget().addAction(&_statisticAction);
+
+    // Only points datasets with one point per position can provide bin values
+    _valueDatasetPickerAction.setDatasetsFilterFunction([this](const hdps::Datasets& datasets) -> Datasets {
+        Datasets valueDatasets;
+
+        const auto& positionDataset = _viewerscatterplotPlugin->getPositionDataset();
+
+        if (!positionDataset.isValid())
+            return valueDatasets;
+
+        for (auto dataset : datasets)
+            if (dataset->getDataType() == PointType && Dataset<Points>(dataset)->getNumPoints() == positionDataset->getNumPoints())
+                valueDatasets << dataset;
+
+        return valueDatasets;
+    });
+
+    // Adjust the color map range to the value range of the new bins
+    connect(&getViewerScatterplotWidget(), &ViewerScatterplotWidget::binsChanged, this, [this]() -> void {
+        if (getViewerScatterplotWidget().getRenderMode() != ViewerScatterplotWidget::BINNED)
+            return;
+
+        const auto range = getViewerScatterplotWidget().getColorMapRange();
+
+        if (range.y > range.x)
+            _viewerscatterplotPlugin->getSettingsAction().getColoringAction().getColorMapAction().getRangeAction(ColorMapAction::Axis::X).setRange({ range.x, range.y });
+    });
+
+    connect(&_shapeAction, &OptionAction::currentIndexChanged, this, [this](const std::int32_t& currentIndex) -> void {
+        getViewerScatterplotWidget().setBinShape(static_cast<Bins::Shape>(currentIndex));
+    });
+
+    connect(&_resolutionAction, &IntegralAction::valueChanged, this, [this](const std::int32_t& value) -> void {
+        getViewerScatterplotWidget().setBinResolution(static_cast<std::uint32_t>(std::max(1, value)));
+    });
+
+    connect(&_statisticAction, &OptionAction::currentIndexChanged, this, [this](const std::int32_t& currentIndex) -> void {
+        const auto isCount = currentIndex == 0;
+
+        _valueDatasetPickerAction.setEnabled(!isCount);
+        _valueDimensionAction.setEnabled(!isCount);
+
+        getViewerScatterplotWidget().setBinStatistic(static_cast<BinAggregator::Statistic>(currentIndex));
+
+        updateBinValues();
+    });
+
+    connect(&_valueDatasetPickerAction, &DatasetPickerAction::datasetPicked, this, [this](Dataset<DatasetImpl> pickedDataset) -> void {
+        _valueDataset = pickedDataset;
+
+        _valueDimensionAction.setPointsDataset(_valueDataset);
+
+        updateBinValues();
+    });
+
+    connect(&_valueDimensionAction, &DimensionPickerAction::currentDimensionIndexChanged, this, &AggregatePlotAction::updateBinValues);
+
+    // Extract the values again when the value data changes
+    connect(&_valueDataset, &Dataset<Points>::dataChanged, this, &AggregatePlotAction::updateBinValues);
+
+    // The number of positions might no longer match the value dataset
+    connect(&_viewerscatterplotPlugin->getPositionDataset(), &Dataset<Points>::dataChanged, this, [this]() -> void {
+        if (_statisticAction.getCurrentIndex() != 0 && getViewerScatterplotWidget().hasBinValues() != isValueDatasetValid())
+            updateBinValues();
+    });
+
+    _valueDatasetPickerAction.setEnabled(false);
+    _valueDimensionAction.setEnabled(false);
+}
+
+QMenu* AggregatePlotAction::getContextMenu()
+{
+    auto menu = new QMenu("Plot settings");
+
+    const auto addActionToMenu = [menu](QAction* action) {
+        auto actionMenu = new QMenu(action->text());
+
+        actionMenu->addAction(action);
+
+        menu->addMenu(actionMenu);
+    };
+
+    addActionToMenu(&_shapeAction);
+    addActionToMenu(&_resolutionAction);
+    addActionToMenu(&_statisticAction);
+
+    return menu;
+}
+
+bool AggregatePlotAction::isValueDatasetValid() const
+{
+    const auto& positionDataset = _viewerscatterplotPlugin->getPositionDataset();
+
+    return _valueDataset.isValid() && positionDataset.isValid() && _valueDataset->getNumPoints() == positionDataset->getNumPoints();
+}
+
+void AggregatePlotAction::updateBinValues()
+{
+    const auto currentDimensionIndex = _valueDimensionAction.getCurrentDimensionIndex();
+
+    // Fall back to the point count when no (valid) value dimension is selected
+    if (_statisticAction.getCurrentIndex() == 0 || !isValueDatasetValid() || currentDimensionIndex < 0 || currentDimensionIndex >= static_cast<std::int32_t>(_valueDataset->getNumDimensions())) {
+        getViewerScatterplotWidget().clearBinValues();
+        return;
+    }
+
+    const auto numberOfPoints = _valueDataset->getNumPoints();
+
+    std::vector<float> values(numberOfPoints);
+
+    // Visit the points dataset to get access to the point values
+    _valueDataset->visitData([&values, numberOfPoints, currentDimensionIndex](auto pointData) {
+        for (std::uint32_t pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+            values[pointIndex] = static_cast<float>(pointData[pointIndex][currentDimensionIndex]);
+    });
+
+    getViewerScatterplotWidget().setBinValues(values);
+}
+
+void AggregatePlotAction::fromVariantMap(const QVariantMap& variantMap)
+{
+    WidgetAction::fromVariantMap(variantMap);
+
+    _shapeAction.fromParentVariantMap(variantMap);
+    _resolutionAction.fromParentVariantMap(variantMap);
+    _valueDatasetPickerAction.fromParentVariantMap(variantMap);
+    _valueDimensionAction.fromParentVariantMap(variantMap);
+    _statisticAction.fromParentVariantMap(variantMap);
+}
+
+QVariantMap AggregatePlotAction::toVariantMap() const
+{
+    QVariantMap variantMap = WidgetAction::toVariantMap();
+
+    _shapeAction.insertIntoVariantMap(variantMap);
+    _resolutionAction.insertIntoVariantMap(variantMap);
+    _statisticAction.insertIntoVariantMap(variantMap);
+    _valueDatasetPickerAction.insertIntoVariantMap(variantMap);
+    _valueDimensionAction.insertIntoVariantMap(variantMap);
+
+    return variantMap;
+}
+
+AggregatePlotAction::Widget::Widget(QWidget* parent, AggregatePlotAction* aggregatePlotAction) :
+    WidgetActionWidget(parent, aggregatePlotAction)
+{
+    auto layout = new QHBoxLayout();
+
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(aggregatePlotAction->_shapeAction.createLabelWidget(this));
+    layout->addWidget(aggregatePlotAction->_shapeAction.createWidget(this));
+    layout->addWidget(aggregatePlotAction->_resolutionAction.createLabelWidget(this));
+    layout->addWidget(aggregatePlotAction->_resolutionAction.createWidget(this));
+    layout->addWidget(aggregatePlotAction->_statisticAction.createLabelWidget(this));
+    layout->addWidget(aggregatePlotAction->_statisticAction.createWidget(this));
+    layout->addWidget(aggregatePlotAction->_valueDatasetPickerAction.createWidget(this));
+    layout->addWidget(aggregatePlotAction->_valueDimensionAction.createWidget(this));
+
+    setLayout(layout);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "PluginAction.h"
+
+#include "actions/DatasetPickerAction.h"
+#include <PointData/PointData.h>
+#include <PointData/DimensionPickerAction.h>
+
+using namespace hdps::gui;
+
+class PlotAction;
+
+class AggregatePlotAction : public PluginAction
+{
+protected:
+    class Widget : public WidgetActionWidget {
+    public:
+        Widget(QWidget* parent, AggregatePlotAction* aggregatePlotAction);
+    };
+
+    QWidget* getWidget(QWidget* parent, const std::int32_t& widgetFlags) override {
+        return new Widget(parent, this);
+    };
+
+public:
+    AggregatePlotAction(PlotAction* plotAction, ViewerScatterplotPlugin* viewerscatterplotPlugin);
+
+    QMenu* getContextMenu();
+
+protected:
+
+    /** Extract the values of the current value dimension and pass them to the scatter plot widget (or clear them) */
+    void updateBinValues();
+
+    /** Get whether the current value dataset is a points dataset with one point per position */
+    bool isValueDatasetValid() const;
+
+public: // Serialization
+
+    /**
+     * Load widget action from variant map
+     * @param Variant map representation of the widget action
+     */
+    void fromVariantMap(const QVariantMap& variantMap) override;
+
+    /**
+     * Save widget action to variant map
+     * @return Variant map representation of the widget action
+     */
+    QVariantMap toVariantMap() const override;
+
+protected:
+    OptionAction            _shapeAction;                   /** Bin shape action */
+    IntegralAction          _resolutionAction;              /** Number of bins along the x-axis */
+    OptionAction            _statisticAction;               /** Value per bin action */
+    DatasetPickerAction     _valueDatasetPickerAction;      /** Dataset which contains the value dimension */
+    DimensionPickerAction   _valueDimensionAction;          /** Dimension of which the bins take the mean/median */
+    Dataset<Points>         _valueDataset;                  /** Current value dataset (to track data changes) */
+
+    static constexpr std::int32_t DEFAULT_RESOLUTION = 64;
+
+    friend class Widget;
+    friend class PlotAction;
+};
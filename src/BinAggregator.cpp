@@ -0,0 +1,259 @@
+#include "BinAggregator.h"
+#include "IndexRanges.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+Vector2f Bins::getCenter(const std::size_t& binIndex) const
+{
+    const auto column   = static_cast<float>(binIndex % _numberOfColumns);
+    const auto row      = static_cast<float>(binIndex / _numberOfColumns);
+
+    if (_shape == Shape::Square)
+        return Vector2f(_bounds.getLeft() + (column + 0.5f) * _columnSpacing, _bounds.getBottom() + (row + 0.5f) * _rowSpacing);
+
+    // Odd hexagon rows are shifted to the right by half a bin
+    const auto shift = (binIndex / _numberOfColumns) % 2 == 1 ? 0.5f : 0.0f;
+
+    return Vector2f(_bounds.getLeft() + (column + shift) * _columnSpacing, _bounds.getBottom() + row * _rowSpacing);
+}
+
+QPolygonF Bins::getPolygon(const std::size_t& binIndex) const
+{
+    const auto center = getCenter(binIndex);
+
+    QPolygonF polygon;
+
+    if (_shape == Shape::Square) {
+        const auto halfSize = 0.5 * _columnSpacing;
+
+        polygon << QPointF(center.x - halfSize, center.y - halfSize) << QPointF(center.x + halfSize, center.y - halfSize) << QPointF(center.x + halfSize, center.y + halfSize) << QPointF(center.x - halfSize, center.y + halfSize);
+
+        return polygon;
+    }
+
+    // The corners of the pointy-top hexagon lie half a bin to the left/right and half/one radius above/below the center
+    const auto halfWidth    = 0.5 * _columnSpacing;
+    const auto radius       = _columnSpacing / std::sqrt(3.0);
+
+    polygon << QPointF(center.x + halfWidth, center.y + 0.5 * radius) << QPointF(center.x, center.y + radius) << QPointF(center.x - halfWidth, center.y + 0.5 * radius);
+    polygon << QPointF(center.x - halfWidth, center.y - 0.5 * radius) << QPointF(center.x, center.y - radius) << QPointF(center.x + halfWidth, center.y - 0.5 * radius);
+
+    return polygon;
+}
+
+void BinAggregator::aggregate(const std::vector<Vector2f>& positions, const Bounds& bounds, const Bins::Shape& shape, const std::uint32_t& resolution, Statistic statistic, const std::vector<float>* values, Bins& bins)
+{
+    layout(bounds, shape, resolution, bins);
+
+    if (!bins.isValid() || positions.empty())
+        return;
+
+    // The mean and median fall back to the count when there are no (matching) values
+    if (values == nullptr || values->size() != positions.size())
+        statistic = Statistic::Count;
+
+    const auto numberOfBins = bins._counts.size();
+    const auto pointRanges  = common::getIndexRanges(positions.size(), 65536);
+
+    // Each task bins a range of points into private counts and sums to avoid write contention
+    std::vector<std::vector<std::uint32_t>> partialCounts(pointRanges.size());
+    std::vector<std::vector<double>> partialSums(pointRanges.size());
+
+    auto rangeIndices = common::getIndices(pointRanges.size());
+
+    QtConcurrent::blockingMap(rangeIndices, [&](const std::size_t& rangeIndex) -> void {
+        auto& counts    = partialCounts[rangeIndex];
+        auto& sums      = partialSums[rangeIndex];
+
+        counts.assign(numberOfBins, 0);
+
+        if (statistic == Statistic::Mean)
+            sums.assign(numberOfBins, 0.0);
+
+        for (auto pointIndex = pointRanges[rangeIndex].first; pointIndex < pointRanges[rangeIndex].second; pointIndex++) {
+            std::size_t binIndex = 0;
+
+            if (!getBinIndex(positions[pointIndex], bins, binIndex))
+                continue;
+
+            counts[binIndex]++;
+
+            if (statistic == Statistic::Mean)
+                sums[binIndex] += (*values)[pointIndex];
+        }
+    });
+
+    // Reduce the partial counts (and sums)
+    std::vector<double> sums(statistic == Statistic::Mean ? numberOfBins : 0, 0.0);
+
+    for (std::size_t rangeIndex = 0; rangeIndex < pointRanges.size(); rangeIndex++) {
+        for (std::size_t binIndex = 0; binIndex < numberOfBins; binIndex++) {
+            bins._counts[binIndex] += partialCounts[rangeIndex][binIndex];
+
+            if (statistic == Statistic::Mean)
+                sums[binIndex] += partialSums[rangeIndex][binIndex];
+        }
+    }
+
+    switch (statistic)
+    {
+        case Statistic::Count:
+        {
+            for (std::size_t binIndex = 0; binIndex < numberOfBins; binIndex++)
+                bins._values[binIndex] = static_cast<float>(bins._counts[binIndex]);
+
+            break;
+        }
+
+        case Statistic::Mean:
+        {
+            for (std::size_t binIndex = 0; binIndex < numberOfBins; binIndex++)
+                if (bins._counts[binIndex] > 0)
+                    bins._values[binIndex] = static_cast<float>(sums[binIndex] / bins._counts[binIndex]);
+
+            break;
+        }
+
+        case Statistic::Median:
+        {
+            // Offset of each bin in the bucketed values
+            std::vector<std::size_t> binOffsets(numberOfBins + 1, 0);
+
+            for (std::size_t binIndex = 0; binIndex < numberOfBins; binIndex++)
+                binOffsets[binIndex + 1] = binOffsets[binIndex] + bins._counts[binIndex];
+
+            // Each task writes into its own part of every bucket, which follows the parts of the preceding tasks
+            std::vector<std::vector<std::size_t>> partialOffsets(pointRanges.size(), std::vector<std::size_t>(binOffsets.begin(), binOffsets.end() - 1));
+
+            for (std::size_t rangeIndex = 1; rangeIndex < pointRanges.size(); rangeIndex++)
+                for (std::size_t binIndex = 0; binIndex < numberOfBins; binIndex++)
+                    partialOffsets[rangeIndex][binIndex] = partialOffsets[rangeIndex - 1][binIndex] + partialCounts[rangeIndex - 1][binIndex];
+
+            std::vector<float> bucketedValues(binOffsets.back());
+
+            QtConcurrent::blockingMap(rangeIndices, [&](const std::size_t& rangeIndex) -> void {
+                auto& offsets = partialOffsets[rangeIndex];
+
+                for (auto pointIndex = pointRanges[rangeIndex].first; pointIndex < pointRanges[rangeIndex].second; pointIndex++) {
+                    std::size_t binIndex = 0;
+
+                    if (getBinIndex(positions[pointIndex], bins, binIndex))
+                        bucketedValues[offsets[binIndex]++] = (*values)[pointIndex];
+                }
+            });
+
+            std::vector<std::size_t> binIndices(numberOfBins);
+
+            std::iota(binIndices.begin(), binIndices.end(), 0);
+
+            // Select the median of each bin (the mean of the two middle values for an even count)
+            QtConcurrent::blockingMap(binIndices, [&](const std::size_t& binIndex) -> void {
+                const auto count = bins._counts[binIndex];
+
+                if (count == 0)
+                    return;
+
+                const auto first    = bucketedValues.begin() + binOffsets[binIndex];
+                const auto middle   = first + count / 2;
+                const auto last     = bucketedValues.begin() + binOffsets[binIndex + 1];
+
+                std::nth_element(first, middle, last);
+
+                bins._values[binIndex] = count % 2 == 1 ? *middle : 0.5f * (*middle + *std::max_element(first, middle));
+            });
+
+            break;
+        }
+    }
+
+    // Establish the range of the non-empty bins
+    auto isFirst = true;
+
+    for (std::size_t binIndex = 0; binIndex < numberOfBins; binIndex++) {
+        if (bins._counts[binIndex] == 0)
+            continue;
+
+        bins._minimum   = isFirst ? bins._values[binIndex] : std::min(bins._minimum, bins._values[binIndex]);
+        bins._maximum   = isFirst ? bins._values[binIndex] : std::max(bins._maximum, bins._values[binIndex]);
+        isFirst         = false;
+    }
+}
+
+bool BinAggregator::getBinIndex(const Vector2f& position, const Bins& bins, std::size_t& binIndex)
+{
+    const auto& bounds = bins._bounds;
+
+    if (!bins.isValid() || position.x < bounds.getLeft() || position.x > bounds.getRight() || position.y < bounds.getBottom() || position.y > bounds.getTop())
+        return false;
+
+    const auto x = position.x - bounds.getLeft();
+    const auto y = position.y - bounds.getBottom();
+
+    std::int64_t column = 0, row = 0;
+
+    if (bins._shape == Bins::Shape::Square) {
+        column  = static_cast<std::int64_t>(std::floor(x / bins._columnSpacing));
+        row     = static_cast<std::int64_t>(std::floor(y / bins._rowSpacing));
+    }
+    else {
+
+        // The even and odd hexagon rows each form a rectangular lattice, the nearest center of both lattices is the bin
+        const auto evenRow      = 2 * static_cast<std::int64_t>(std::round(y / (2.0f * bins._rowSpacing)));
+        const auto evenColumn   = static_cast<std::int64_t>(std::round(x / bins._columnSpacing));
+        const auto oddRow       = 2 * static_cast<std::int64_t>(std::round((y - bins._rowSpacing) / (2.0f * bins._rowSpacing))) + 1;
+        const auto oddColumn    = static_cast<std::int64_t>(std::round(x / bins._columnSpacing - 0.5f));
+
+        const auto evenDeltaX   = x - evenColumn * bins._columnSpacing;
+        const auto evenDeltaY   = y - evenRow * bins._rowSpacing;
+        const auto oddDeltaX    = x - (oddColumn + 0.5f) * bins._columnSpacing;
+        const auto oddDeltaY    = y - oddRow * bins._rowSpacing;
+
+        const auto isEven = evenDeltaX * evenDeltaX + evenDeltaY * evenDeltaY <= oddDeltaX * oddDeltaX + oddDeltaY * oddDeltaY;
+
+        column  = isEven ? evenColumn : oddColumn;
+        row     = isEven ? evenRow : oddRow;
+    }
+
+    // Points on the far edges of the bounds belong to the last column/row
+    column  = std::clamp<std::int64_t>(column, 0, bins._numberOfColumns - 1);
+    row     = std::clamp<std::int64_t>(row, 0, bins._numberOfRows - 1);
+
+    binIndex = static_cast<std::size_t>(row) * bins._numberOfColumns + static_cast<std::size_t>(column);
+
+    return true;
+}
+
+void BinAggregator::layout(const Bounds& bounds, const Bins::Shape& shape, const std::uint32_t& resolution, Bins& bins)
+{
+    bins = Bins();
+
+    bins._shape     = shape;
+    bins._bounds    = bounds;
+
+    if (resolution == 0 || bounds.getWidth() <= 0.0f || bounds.getHeight() <= 0.0f)
+        return;
+
+    bins._columnSpacing = bounds.getWidth() / static_cast<float>(resolution);
+
+    if (shape == Bins::Shape::Square) {
+        bins._rowSpacing        = bins._columnSpacing;
+        bins._numberOfColumns   = resolution;
+        bins._numberOfRows      = static_cast<std::uint32_t>(std::max(1.0f, std::ceil(bounds.getHeight() / bins._rowSpacing)));
+    }
+    else {
+
+        // Hexagon centers lie on the bounds, so one extra column and row cover the far edges
+        bins._rowSpacing        = 1.5f * bins._columnSpacing / std::sqrt(3.0f);
+        bins._numberOfColumns   = resolution + 1;
+        bins._numberOfRows      = static_cast<std::uint32_t>(std::ceil(bounds.getHeight() / bins._rowSpacing)) + 1;
+    }
+
+    const auto numberOfBins = static_cast<std::size_t>(bins._numberOfColumns) * bins._numberOfRows;
+
+    bins._counts.assign(numberOfBins, 0);
+    bins._values.assign(numberOfBins, 0.0f);
+}
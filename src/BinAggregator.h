@@ -0,0 +1,109 @@
+#pragma once
+
+#include "graphics/Vector2f.h"
+#include "graphics/Bounds.h"
+
+#include <QPolygonF>
+
+#include <cstdint>
+#include <vector>
+
+using namespace hdps;
+
+/** Aggregated points on a regular grid of hexagonal or square bins */
+struct Bins
+{
+    /** Shape of the bins */
+    enum class Shape {
+        Hexagon,        /** Pointy-top hexagons, odd rows are shifted by half a bin */
+        Square,         /** Axis aligned squares */
+    };
+
+    /**
+     * Get whether there are bins
+     * @return Whether there are bins
+     */
+    bool isValid() const {
+        return !_counts.empty();
+    }
+
+    /**
+     * Get the center of a bin in data coordinates
+     * @param binIndex Bin index (row major)
+     * @return Bin center
+     */
+    Vector2f getCenter(const std::size_t& binIndex) const;
+
+    /**
+     * Get the outline of a bin in data coordinates
+     * @param binIndex Bin index (row major)
+     * @return Bin outline
+     */
+    QPolygonF getPolygon(const std::size_t& binIndex) const;
+
+    Shape                       _shape = Shape::Hexagon;    /** Shape of the bins */
+    Bounds                      _bounds;                    /** Data bounds covered by the bins */
+    std::uint32_t               _numberOfColumns = 0;       /** Number of bins along the x-axis */
+    std::uint32_t               _numberOfRows = 0;          /** Number of bins along the y-axis */
+    float                       _columnSpacing = 0.0f;      /** Horizontal distance between neighboring bin centers */
+    float                       _rowSpacing = 0.0f;         /** Vertical distance between neighboring bin centers */
+    std::vector<std::uint32_t>  _counts;                    /** Number of points per bin (row major) */
+    std::vector<float>          _values;                    /** Aggregated value per bin (row major) */
+    float                       _minimum = 0.0f;            /** Smallest value of the non-empty bins */
+    float                       _maximum = 0.0f;            /** Largest value of the non-empty bins */
+};
+
+/**
+ * Bin aggregator class
+ *
+ * Aggregates points into a regular grid of a few thousand hexagonal or square bins, so that the
+ * cost of drawing them no longer depends on the number of points. Bins hold the number of points
+ * or the mean/median of a per-point value. Points are binned in one parallel pass in which each
+ * task accumulates a private set of bins; the median additionally buckets the values per bin
+ * (counting sort) and selects the median of each bin in parallel.
+ */
+class BinAggregator
+{
+public:
+
+    /** Value per bin */
+    enum class Statistic {
+        Count,          /** Number of points */
+        Mean,           /** Mean of the point values */
+        Median,         /** Median of the point values */
+    };
+
+public:
+
+    /**
+     * Aggregate \p positions into bins which cover \p bounds (points outside the bounds are ignored)
+     * @param positions Point positions
+     * @param bounds Data bounds covered by the bins
+     * @param shape Shape of the bins
+     * @param resolution Number of bins along the x-axis
+     * @param statistic Value per bin (the mean and median require \p values)
+     * @param values Optional per-point values (same size as \p positions)
+     * @param bins Bins to populate
+     */
+    static void aggregate(const std::vector<Vector2f>& positions, const Bounds& bounds, const Bins::Shape& shape, const std::uint32_t& resolution, Statistic statistic, const std::vector<float>* values, Bins& bins);
+
+    /**
+     * Get the bin which contains \p position
+     * @param position Point position
+     * @param bins Bins (only the layout is used)
+     * @param binIndex Bin index (row major)
+     * @return Whether the position lies inside a bin
+     */
+    static bool getBinIndex(const Vector2f& position, const Bins& bins, std::size_t& binIndex);
+
+protected:
+
+    /**
+     * Lay out the bins over \p bounds and reset their counts and values
+     * @param bounds Data bounds covered by the bins
+     * @param shape Shape of the bins
+     * @param resolution Number of bins along the x-axis
+     * @param bins Bins to lay out
+     */
+    static void layout(const Bounds& bounds, const Bins::Shape& shape, const std::uint32_t& resolution, Bins& bins);
+};
@@ -19,7 +19,8 @@ ColoringAction::ColoringAction(ViewerScatterplotPlugin* viewerscatterplotPlugin)
     _constantColorAction(this, "Constant color", DEFAULT_CONSTANT_COLOR, DEFAULT_CONSTANT_COLOR),
     _dimensionAction(this, "Dim"),
     _colorMapAction(this, "Color map"),
-    _colorMap2DAction(this, "Color map 2D", ColorMap::Type::TwoDimensional, "example_c", "example_c")
+    _colorMap2DAction(this, "Color map 2D", ColorMap::Type::TwoDimensional, "example_c", "example_c"),
+    _colorDatasetSubscriptions(this)
 {
     _colorMapAction.getSettingsAction().setDisabled(true);
     _colorMapAction.getSettingsAction().setVisible(false);
@@ -53,6 +54,26 @@ ColoringAction::ColoringAction(ViewerScatterplotPlugin* viewerscatterplotPlugin)
 
     _colorMapAction.setConnectionPermissionsFlag(ConnectionPermissionFlag::All);
 
+    // Point colors are updated at most once per update pass
+    _viewerscatterplotPlugin->getUpdateScheduler().setUpdateFunction(UpdateScheduler::Buffer::Colors, [this]() -> void {
+        updateScatterPlotWidgetColors();
+    });
+
+    // Update the scatter plot colors (once per batch) when the data of the current color dataset changed
+    connect(&_colorDatasetSubscriptions, &DatasetSubscriptions::datasetsChanged, this, [this](const Datasets& datasets) -> void {
+
+        // Get smart pointer to current color dataset
+        const auto currentColorDataset = getCurrentColorDataset();
+
+        // Only proceed if we have a valid dataset for coloring
+        if (!currentColorDataset.isValid())
+            return;
+
+        // Update colors if the current color dataset changed
+        if (datasets.contains(currentColorDataset))
+            scheduleScatterPlotWidgetColorsUpdate();
+    });
+
     // Update dataset picker when the position dataset changes
     connect(&_viewerscatterplotPlugin->getPositionDataset(), &Dataset<Points>::changed, this, [this]() {
 
@@ -65,6 +86,7 @@ ColoringAction::ColoringAction(ViewerScatterplotPlugin* viewerscatterplotPlugin)
 
         // Reset the color datasets
         _colorByModel.removeAllDatasets();
+        _colorDatasetSubscriptions.unsubscribeAll();
 
         // Add the position dataset
         addColorDataset(positionDataset);
@@ -134,7 +156,7 @@ ColoringAction::ColoringAction(ViewerScatterplotPlugin* viewerscatterplotPlugin)
             _dimensionAction.setVisible(false);
         }
 
-        updateScatterPlotWidgetColors();
+        scheduleScatterPlotWidgetColorsUpdate();
         updateViewerScatterplotWidgetColorMap();
         updateColorMapActionScalarRange();
         updateColorMapActionReadOnly();
@@ -144,12 +166,13 @@ ColoringAction::ColoringAction(ViewerScatterplotPlugin* viewerscatterplotPlugin)
     connect(&_viewerscatterplotPlugin->getPositionDataset(), &Dataset<Points>::dataChildAdded, this, &ColoringAction::updateColorByActionOptions);
     connect(&_viewerscatterplotPlugin->getPositionDataset(), &Dataset<Points>::dataChildRemoved, this, &ColoringAction::updateColorByActionOptions);
 
-    // Update scatter plot widget colors when the scatter plot widget coloring/rendering mode changes
-    connect(&_viewerscatterplotPlugin->getViewerScatterplotWidget(), &ViewerScatterplotWidget::renderModeChanged, this, &ColoringAction::updateScatterPlotWidgetColors);
-    connect(&_viewerscatterplotPlugin->getViewerScatterplotWidget(), &ViewerScatterplotWidget::coloringModeChanged, this, &ColoringAction::updateScatterPlotWidgetColors);
+    // Update scatter plot widget colors when the scatter plot widget coloring/rendering mode changes (or it needs copies of the colors again)
+    connect(&_viewerscatterplotPlugin->getViewerScatterplotWidget(), &ViewerScatterplotWidget::renderModeChanged, this, &ColoringAction::scheduleScatterPlotWidgetColorsUpdate);
+    connect(&_viewerscatterplotPlugin->getViewerScatterplotWidget(), &ViewerScatterplotWidget::coloringModeChanged, this, &ColoringAction::scheduleScatterPlotWidgetColorsUpdate);
+    connect(&_viewerscatterplotPlugin->getViewerScatterplotWidget(), &ViewerScatterplotWidget::pointDataRequired, this, &ColoringAction::scheduleScatterPlotWidgetColorsUpdate);
 
     // Update scatter plot widget colors and color map range when the current dimension changes
-    connect(&_dimensionAction, &DimensionPickerAction::currentDimensionIndexChanged, this, &ColoringAction::updateScatterPlotWidgetColors);
+    connect(&_dimensionAction, &DimensionPickerAction::currentDimensionIndexChanged, this, &ColoringAction::scheduleScatterPlotWidgetColorsUpdate);
     connect(&_dimensionAction, &DimensionPickerAction::currentDimensionIndexChanged, this, &ColoringAction::updateColorMapActionScalarRange);
 
     // Update scatter plot widget color map when actions change
@@ -196,26 +219,8 @@ void ColoringAction::addColorDataset(const Dataset<DatasetImpl>& colorDataset)
     // Add the dataset to the model
     _colorByModel.addDataset(colorDataset);
 
-    // Get smart pointer to added dataset
-    auto& addedDataset = _colorByModel.getDatasets().last();
-
-    for (const auto& dataset : _colorByModel.getDatasets()) {
-
-        // Connect to the data changed signal so that we can update the scatter plot colors appropriately
-        connect(&dataset, &Dataset<DatasetImpl>::dataChanged, this, [this, dataset]() {
-
-            // Get smart pointer to current color dataset
-            const auto currentColorDataset = getCurrentColorDataset();
-
-            // Only proceed if we have a valid dataset for coloring
-            if (!currentColorDataset.isValid())
-                return;
-
-            // Update colors if the dataset matches
-            if (currentColorDataset == dataset)
-                updateScatterPlotWidgetColors();
-        });
-    }
+    // Subscribe to data changes of the added dataset only (no-op if already subscribed)
+    _colorDatasetSubscriptions.subscribe(colorDataset);
 }
 
 bool ColoringAction::hasColorDataset(const Dataset<DatasetImpl>& colorDataset) const
@@ -302,6 +307,11 @@ void ColoringAction::updateScatterPlotWidgetColors()
     }
 }
 
+void ColoringAction::scheduleScatterPlotWidgetColorsUpdate()
+{
+    _viewerscatterplotPlugin->getUpdateScheduler().markDirty(UpdateScheduler::Buffer::Colors);
+}
+
 void ColoringAction::updateColorMapActionScalarRange()
 {
     const auto colorMapRange    = _viewerscatterplotPlugin->getViewerScatterplotWidget().getColorMapRange();
@@ -322,6 +332,7 @@ void ColoringAction::updateViewerScatterplotWidgetColorMap()
     switch (_viewerscatterplotPlugin->getViewerScatterplotWidget().getRenderMode())
     {
         case ViewerScatterplotWidget::SCATTERPLOT:
+        case ViewerScatterplotWidget::SHADED:
         {
             if (_colorByAction.getCurrentIndex() == 0) {
                 
@@ -356,6 +367,7 @@ void ColoringAction::updateViewerScatterplotWidgetColorMap()
             break;
 
         case ViewerScatterplotWidget::LANDSCAPE:
+        case ViewerScatterplotWidget::BINNED:
         {
             // Update the scatter plot widget with the color map
             getViewerScatterplotWidget().setColorMap(_colorMapAction.getColorMapImage());
@@ -434,7 +446,9 @@ ColoringAction::Widget::Widget(QWidget* parent, ColoringAction* coloringAction,
 
     // Enable/disable the widget depending on the render mode
     const auto renderModeChanged = [this, coloringAction]() {
-        setEnabled(coloringAction->getViewerScatterplotWidget().getRenderMode() == ViewerScatterplotWidget::SCATTERPLOT);
+        const auto renderMode = coloringAction->getViewerScatterplotWidget().getRenderMode();
+
+        setEnabled(renderMode == ViewerScatterplotWidget::SCATTERPLOT || renderMode == ViewerScatterplotWidget::SHADED);
     };
 
     // Enable/disable depending on the render mode
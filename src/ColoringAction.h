@@ -2,6 +2,7 @@
 
 #include "PluginAction.h"
 #include "ColorSourceModel.h"
+#include "DatasetSubscriptions.h"
 
 #include <PointData/DimensionPickerAction.h>
 
@@ -88,6 +89,9 @@ protected:
     /** Update the colors of the points in the scatter plot widget */
     void updateScatterPlotWidgetColors();
 
+    /** Schedule an update of the colors of the points in the scatter plot widget (coalesces multiple requests) */
+    void scheduleScatterPlotWidgetColorsUpdate();
+
 protected: // Color map
 
     /** Updates the scalar range in the color map */
@@ -137,6 +141,7 @@ protected:
     DimensionPickerAction   _dimensionAction;           /** Dimension picker action */
     ColorMapAction          _colorMapAction;            /** Color map action */
     ColorMapAction          _colorMap2DAction;          /** Color map 2D action */
+    DatasetSubscriptions    _colorDatasetSubscriptions; /** One data changed subscription per color dataset */
 
     /** Default constant color */
     static const QColor DEFAULT_CONSTANT_COLOR;
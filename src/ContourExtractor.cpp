@@ -0,0 +1,258 @@
+#include "ContourExtractor.h"
+
+#include <QtConcurrent>
+
+#include <array>
+#include <deque>
+#include <numeric>
+#include <unordered_map>
+
+namespace
+{
+    /** Line segment between two grid edges (identified by edge index) */
+    using Segment = std::pair<std::uint64_t, std::uint64_t>;
+
+    /** Intersection of the contour with a grid edge */
+    struct EdgeCrossing {
+        Vector2f                    _position;                  /** Position in data coordinates */
+        std::array<std::int64_t, 2> _segments = { -1, -1 };     /** Indices of the (at most two) segments which share the edge */
+    };
+}
+
+Contour ContourExtractor::extract(const DensityGrid& grid, const Bounds& bounds, const float& level)
+{
+    Contour contour;
+
+    contour._level = level;
+
+    const auto resolution = static_cast<std::int64_t>(grid.getResolution());
+
+    if (resolution == 0)
+        return contour;
+
+    // Number of samples along each axis of the padded grid
+    const auto numberOfSamples = resolution + 2;
+
+    // Get the value of a padded grid sample (the border is zero)
+    const auto getValue = [&grid, resolution](const std::int64_t& x, const std::int64_t& y) -> float {
+        if (x < 0 || y < 0 || x >= resolution || y >= resolution)
+            return 0.0f;
+
+        return grid.getValue(static_cast<std::uint32_t>(x), static_cast<std::uint32_t>(y));
+    };
+
+    // Samples are located at the cell centers
+    const auto cellWidth    = bounds.getWidth() / static_cast<float>(resolution);
+    const auto cellHeight   = bounds.getHeight() / static_cast<float>(resolution);
+
+    const auto getPosition = [&bounds, cellWidth, cellHeight](const float& x, const float& y) -> Vector2f {
+        return Vector2f(bounds.getLeft() + (x + 0.5f) * cellWidth, bounds.getBottom() + (y + 0.5f) * cellHeight);
+    };
+
+    // Horizontal edges come first, vertical edges second (padded sample coordinates)
+    const auto getHorizontalEdge = [numberOfSamples](const std::int64_t& x, const std::int64_t& y) -> std::uint64_t {
+        return static_cast<std::uint64_t>((y + 1) * numberOfSamples + (x + 1));
+    };
+
+    const auto getVerticalEdge = [numberOfSamples](const std::int64_t& x, const std::int64_t& y) -> std::uint64_t {
+        return static_cast<std::uint64_t>(numberOfSamples * numberOfSamples + (y + 1) * numberOfSamples + (x + 1));
+    };
+
+    std::vector<Segment> segments;
+    std::unordered_map<std::uint64_t, EdgeCrossing> edgeCrossings;
+
+    // Register a segment and the positions where it crosses the grid edges
+    const auto addSegment = [&segments, &edgeCrossings](const std::uint64_t& edgeA, const Vector2f& positionA, const std::uint64_t& edgeB, const Vector2f& positionB) -> void {
+        const auto segmentIndex = static_cast<std::int64_t>(segments.size());
+
+        segments.emplace_back(edgeA, edgeB);
+
+        for (const auto& [edge, position] : { std::make_pair(edgeA, positionA), std::make_pair(edgeB, positionB) }) {
+            auto& edgeCrossing = edgeCrossings[edge];
+
+            edgeCrossing._position = position;
+            edgeCrossing._segments[edgeCrossing._segments[0] < 0 ? 0 : 1] = segmentIndex;
+        }
+    };
+
+    // Interpolate the crossing along the edge between two samples
+    const auto interpolate = [level](const float& valueA, const float& valueB) -> float {
+        return valueB != valueA ? (level - valueA) / (valueB - valueA) : 0.5f;
+    };
+
+    // March over the squares between the samples of the padded grid
+    for (std::int64_t y = -1; y < resolution; y++) {
+        for (std::int64_t x = -1; x < resolution; x++) {
+            const auto bottomLeft   = getValue(x, y);
+            const auto bottomRight  = getValue(x + 1, y);
+            const auto topRight     = getValue(x + 1, y + 1);
+            const auto topLeft      = getValue(x, y + 1);
+
+            const auto squareCase = (bottomLeft > level ? 1 : 0) | (bottomRight > level ? 2 : 0) | (topRight > level ? 4 : 0) | (topLeft > level ? 8 : 0);
+
+            if (squareCase == 0 || squareCase == 15)
+                continue;
+
+            const auto fx = static_cast<float>(x);
+            const auto fy = static_cast<float>(y);
+
+            const auto bottom   = std::make_pair(getHorizontalEdge(x, y), getPosition(fx + interpolate(bottomLeft, bottomRight), fy));
+            const auto top      = std::make_pair(getHorizontalEdge(x, y + 1), getPosition(fx + interpolate(topLeft, topRight), fy + 1.0f));
+            const auto left     = std::make_pair(getVerticalEdge(x, y), getPosition(fx, fy + interpolate(bottomLeft, topLeft)));
+            const auto right    = std::make_pair(getVerticalEdge(x + 1, y), getPosition(fx + 1.0f, fy + interpolate(bottomRight, topRight)));
+
+            const auto connect = [&addSegment](const std::pair<std::uint64_t, Vector2f>& a, const std::pair<std::uint64_t, Vector2f>& b) -> void {
+                addSegment(a.first, a.second, b.first, b.second);
+            };
+
+            // Saddles are resolved with the average of the four samples
+            const auto centerAbove = 0.25f * (bottomLeft + bottomRight + topRight + topLeft) > level;
+
+            switch (squareCase)
+            {
+                case 1:
+                case 14:
+                    connect(left, bottom);
+                    break;
+
+                case 2:
+                case 13:
+                    connect(bottom, right);
+                    break;
+
+                case 3:
+                case 12:
+                    connect(left, right);
+                    break;
+
+                case 4:
+                case 11:
+                    connect(right, top);
+                    break;
+
+                case 6:
+                case 9:
+                    connect(bottom, top);
+                    break;
+
+                case 7:
+                case 8:
+                    connect(left, top);
+                    break;
+
+                case 5:
+                {
+                    if (centerAbove) {
+                        connect(left, top);
+                        connect(bottom, right);
+                    }
+                    else {
+                        connect(left, bottom);
+                        connect(right, top);
+                    }
+
+                    break;
+                }
+
+                case 10:
+                {
+                    if (centerAbove) {
+                        connect(left, bottom);
+                        connect(right, top);
+                    }
+                    else {
+                        connect(left, top);
+                        connect(bottom, right);
+                    }
+
+                    break;
+                }
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    // Join the segments into polylines by following shared edges
+    std::vector<bool> used(segments.size(), false);
+
+    // Get the edge at the other end of an unused segment which shares edge, returns false when there is none
+    const auto followEdge = [&segments, &edgeCrossings, &used](std::uint64_t& edge) -> bool {
+        for (const auto& segmentIndex : edgeCrossings[edge]._segments) {
+            if (segmentIndex < 0 || used[segmentIndex])
+                continue;
+
+            used[segmentIndex] = true;
+
+            const auto& segment = segments[segmentIndex];
+
+            edge = segment.first == edge ? segment.second : segment.first;
+
+            return true;
+        }
+
+        return false;
+    };
+
+    for (std::size_t segmentIndex = 0; segmentIndex < segments.size(); segmentIndex++) {
+        if (used[segmentIndex])
+            continue;
+
+        used[segmentIndex] = true;
+
+        std::deque<std::uint64_t> chain{ segments[segmentIndex].first, segments[segmentIndex].second };
+
+        // Extend the chain at both ends
+        for (auto edge = chain.back(); followEdge(edge);)
+            chain.push_back(edge);
+
+        for (auto edge = chain.front(); followEdge(edge);)
+            chain.push_front(edge);
+
+        std::vector<Vector2f> polyline;
+
+        polyline.reserve(chain.size());
+
+        for (const auto& edge : chain)
+            polyline.push_back(edgeCrossings[edge]._position);
+
+        contour._polylines.push_back(std::move(polyline));
+    }
+
+    return contour;
+}
+
+Contours ContourExtractor::extract(const DensityGrid& grid, const Bounds& bounds, const std::vector<float>& levels)
+{
+    Contours contours(levels.size());
+
+    std::vector<std::size_t> levelIndices(levels.size());
+
+    std::iota(levelIndices.begin(), levelIndices.end(), 0);
+
+    // Levels are independent, so each one is extracted by a separate task
+    QtConcurrent::blockingMap(levelIndices, [&](const std::size_t& levelIndex) -> void {
+        contours[levelIndex] = extract(grid, bounds, levels[levelIndex]);
+    });
+
+    return contours;
+}
+
+std::vector<float> ContourExtractor::getLevels(const DensityGrid& grid, const std::uint32_t& numberOfLevels)
+{
+    std::vector<float> levels;
+
+    const auto minimum  = grid.getMinimum();
+    const auto maximum  = grid.getMaximum();
+
+    if (numberOfLevels == 0 || maximum <= minimum)
+        return levels;
+
+    const auto spacing = (maximum - minimum) / static_cast<float>(numberOfLevels + 1);
+
+    for (std::uint32_t levelIndex = 0; levelIndex < numberOfLevels; levelIndex++)
+        levels.push_back(minimum + static_cast<float>(levelIndex + 1) * spacing);
+
+    return levels;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "DensityGrid.h"
+
+#include "graphics/Vector2f.h"
+#include "graphics/Bounds.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace hdps;
+
+/** Iso-contour of a density grid at one level */
+struct Contour
+{
+    float                               _level = 0.0f;      /** Density level */
+    std::vector<std::vector<Vector2f>>  _polylines;         /** Polylines in data coordinates (closed polylines repeat their first point) */
+};
+
+/** Iso-contours of a density grid, one per level */
+using Contours = std::vector<Contour>;
+
+/**
+ * Contour extractor class
+ *
+ * Extracts iso-contours from a density grid with marching squares. The grid is padded with a
+ * border of zeros so that contours which reach the edge of the grid are closed as well. Each
+ * level is extracted by a separate task of the global thread pool.
+ */
+class ContourExtractor
+{
+public:
+
+    /**
+     * Extract the iso-contour of \p grid at \p level
+     * @param grid Density grid
+     * @param bounds Data bounds covered by the grid
+     * @param level Density level
+     * @return Contour
+     */
+    static Contour extract(const DensityGrid& grid, const Bounds& bounds, const float& level);
+
+    /**
+     * Extract the iso-contours of \p grid at \p levels (in parallel)
+     * @param grid Density grid
+     * @param bounds Data bounds covered by the grid
+     * @param levels Density levels
+     * @return Contours (in the order of \p levels)
+     */
+    static Contours extract(const DensityGrid& grid, const Bounds& bounds, const std::vector<float>& levels);
+
+    /**
+     * Get \p numberOfLevels evenly spaced levels between the minimum and maximum of \p grid (both excluded)
+     * @param grid Density grid (its range must be up to date)
+     * @param numberOfLevels Number of levels
+     * @return Levels in ascending order
+     */
+    static std::vector<float> getLevels(const DensityGrid& grid, const std::uint32_t& numberOfLevels);
+};
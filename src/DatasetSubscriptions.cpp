@@ -0,0 +1,82 @@
+#include "DatasetSubscriptions.h"
+
+#include <Set.h>
+
+DatasetSubscriptions::DatasetSubscriptions(QObject* parent /*= nullptr*/) :
+    QObject(parent),
+    _subscriptions(),
+    _changedDatasets(),
+    _notifyTimer()
+{
+    _notifyTimer.setSingleShot(true);
+    _notifyTimer.setInterval(0);
+
+    // Emit the batched notification once control returns to the event loop
+    connect(&_notifyTimer, &QTimer::timeout, this, &DatasetSubscriptions::notify);
+}
+
+bool DatasetSubscriptions::subscribe(const Dataset<DatasetImpl>& dataset)
+{
+    // Only subscribe to valid datasets which are not subscribed to yet
+    if (!dataset.isValid() || isSubscribed(dataset))
+        return false;
+
+    // The subscription owns its smart pointer, so the connection does not depend on the storage of the caller
+    auto& subscription = _subscriptions[dataset.get()];
+
+    subscription = std::make_unique<Dataset<DatasetImpl>>(dataset);
+
+    connect(subscription.get(), &Dataset<DatasetImpl>::dataChanged, this, [this, dataset]() -> void {
+        datasetDataChanged(dataset);
+    });
+
+    return true;
+}
+
+void DatasetSubscriptions::unsubscribe(const Dataset<DatasetImpl>& dataset)
+{
+    // Destroying the smart pointer also removes its connection
+    _subscriptions.erase(dataset.get());
+
+    _changedDatasets.removeAll(dataset);
+}
+
+void DatasetSubscriptions::unsubscribeAll()
+{
+    _subscriptions.clear();
+    _changedDatasets.clear();
+    _notifyTimer.stop();
+}
+
+bool DatasetSubscriptions::isSubscribed(const Dataset<DatasetImpl>& dataset) const
+{
+    return _subscriptions.count(dataset.get()) > 0;
+}
+
+std::uint32_t DatasetSubscriptions::getNumberOfSubscriptions() const
+{
+    return static_cast<std::uint32_t>(_subscriptions.size());
+}
+
+void DatasetSubscriptions::datasetDataChanged(const Dataset<DatasetImpl>& dataset)
+{
+    // Report each dataset at most once per notification
+    if (!_changedDatasets.contains(dataset))
+        _changedDatasets << dataset;
+
+    if (!_notifyTimer.isActive())
+        _notifyTimer.start();
+}
+
+void DatasetSubscriptions::notify()
+{
+    if (_changedDatasets.isEmpty())
+        return;
+
+    // Swap out the pending datasets so that handlers can safely trigger new notifications
+    Datasets changedDatasets;
+
+    changedDatasets.swap(_changedDatasets);
+
+    emit datasetsChanged(changedDatasets);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Dataset.h"
+
+#include <QObject>
+#include <QTimer>
+
+#include <map>
+#include <memory>
+
+using namespace hdps;
+
+/**
+ * Dataset subscriptions class
+ *
+ * Keeps exactly one data changed connection per subscribed dataset (subscribing to the same dataset
+ * twice is a no-op) and batches the notifications: all datasets that changed during one event loop
+ * iteration are reported with a single datasetsChanged signal.
+ *
+ * Each consumer (e.g. the coloring action or a scalar action) owns its own instance.
+ */
+class DatasetSubscriptions : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+     * Constructor
+     * @param parent Pointer to parent object
+     */
+    DatasetSubscriptions(QObject* parent = nullptr);
+
+    /**
+     * Subscribe to data changes of \p dataset
+     * @param dataset Smart pointer to dataset
+     * @return Whether a new subscription was made (false if invalid or already subscribed)
+     */
+    bool subscribe(const Dataset<DatasetImpl>& dataset);
+
+    /**
+     * Unsubscribe from data changes of \p dataset
+     * @param dataset Smart pointer to dataset
+     */
+    void unsubscribe(const Dataset<DatasetImpl>& dataset);
+
+    /** Unsubscribe from all datasets (pending notifications are discarded) */
+    void unsubscribeAll();
+
+    /**
+     * Get whether there is a subscription for \p dataset
+     * @param dataset Smart pointer to dataset
+     * @return Boolean indicating whether there is a subscription for the dataset
+     */
+    bool isSubscribed(const Dataset<DatasetImpl>& dataset) const;
+
+    /** Get the number of subscribed datasets */
+    std::uint32_t getNumberOfSubscriptions() const;
+
+protected:
+
+    /**
+     * Invoked when the data of \p dataset changed, adds it to the pending notifications
+     * @param dataset Smart pointer to dataset
+     */
+    void datasetDataChanged(const Dataset<DatasetImpl>& dataset);
+
+    /** Emit the batched notification for the datasets that changed */
+    void notify();
+
+signals:
+
+    /**
+     * Signals that the data of one or more subscribed datasets changed
+     * @param datasets Datasets whose data changed (each dataset occurs once)
+     */
+    void datasetsChanged(const Datasets& datasets);
+
+private:
+    std::map<DatasetImpl*, std::unique_ptr<Dataset<DatasetImpl>>>   _subscriptions;     /** Smart pointer (with one data changed connection) per subscribed dataset */
+    Datasets                                                        _changedDatasets;   /** Datasets which changed since the last notification */
+    QTimer                                                          _notifyTimer;       /** Single shot timer which emits the batched notification */
+};
@@ -0,0 +1,91 @@
+#include "DensityCache.h"
+#include "KernelDensityEstimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+bool DensityCache::Key::operator==(const Key& other) const
+{
+    return _positionsVersion == other._positionsVersion && _weightsVersion == other._weightsVersion && _source == other._source && _selectionVersion == other._selectionVersion && _resolution == other._resolution && std::abs(_sigma - other._sigma) < 1e-5f;
+}
+
+DensityCache::DensityCache(const std::size_t& capacity /*= DEFAULT_CAPACITY*/) :
+    _capacity(std::max<std::size_t>(1, capacity)),
+    _histogramVersion(0),
+    _histogramWeightsVersion(0),
+    _histogramBounds(),
+    _histograms(),
+    _densities()
+{
+}
+
+std::shared_ptr<const DensityGrid> DensityCache::getHistogram(const std::vector<Vector2f>& positions, const Bounds& bounds, const std::uint64_t& positionsVersion, const std::uint32_t& resolution, const std::vector<float>* weights /*= nullptr*/, const std::uint64_t& weightsVersion /*= 0*/)
+{
+    const auto boundsChanged = bounds.getLeft() != _histogramBounds.getLeft() || bounds.getRight() != _histogramBounds.getRight() || bounds.getBottom() != _histogramBounds.getBottom() || bounds.getTop() != _histogramBounds.getTop();
+
+    // Bin the points again when the positions, weights or bounds changed
+    if (_histograms.empty() || positionsVersion != _histogramVersion || weightsVersion != _histogramWeightsVersion || boundsChanged) {
+        auto histogram = std::make_shared<DensityGrid>();
+
+        KernelDensityEstimator::computeHistogram(positions, bounds, KernelDensityEstimator::DEFAULT_RESOLUTION, *histogram, weights);
+
+        _histogramVersion           = positionsVersion;
+        _histogramWeightsVersion    = weightsVersion;
+        _histogramBounds            = bounds;
+        _histograms                 = { histogram };
+    }
+
+    // Reuse a histogram with the requested resolution
+    for (const auto& histogram : _histograms)
+        if (histogram->getResolution() == resolution)
+            return histogram;
+
+    // Derive the histogram from the full resolution histogram
+    const auto& fullResolutionHistogram = _histograms.front();
+
+    if (resolution == 0 || fullResolutionHistogram->getResolution() % resolution != 0)
+        return fullResolutionHistogram;
+
+    auto histogram = std::make_shared<DensityGrid>();
+
+    KernelDensityEstimator::downsample(*fullResolutionHistogram, fullResolutionHistogram->getResolution() / resolution, *histogram);
+
+    _histograms.push_back(histogram);
+
+    return histogram;
+}
+
+std::shared_ptr<const DensityGrid> DensityCache::findDensity(const Key& key)
+{
+    const auto it = std::find_if(_densities.begin(), _densities.end(), [&key](const auto& entry) -> bool {
+        return entry.first == key;
+    });
+
+    if (it == _densities.end())
+        return nullptr;
+
+    // Mark as most recently used
+    _densities.splice(_densities.begin(), _densities, it);
+
+    return _densities.front().second;
+}
+
+void DensityCache::insertDensity(const Key& key, const std::shared_ptr<const DensityGrid>& density)
+{
+    // Replace an existing entry with the same key
+    _densities.remove_if([&key](const auto& entry) -> bool {
+        return entry.first == key;
+    });
+
+    _densities.emplace_front(key, density);
+
+    // Evict the least recently used density grids
+    while (_densities.size() > _capacity)
+        _densities.pop_back();
+}
+
+void DensityCache::clear()
+{
+    _histograms.clear();
+    _densities.clear();
+}
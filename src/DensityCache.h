@@ -0,0 +1,88 @@
+#pragma once
+
+#include "DensityGrid.h"
+
+#include "graphics/Vector2f.h"
+#include "graphics/Bounds.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <vector>
+
+using namespace hdps;
+
+/**
+ * Density cache class
+ *
+ * Caches the inputs and outputs of the CPU kernel density estimation:
+ *  - The histogram of the point positions, per positions version, weights version and data bounds. Histograms at
+ *    reduced resolutions are derived from the full resolution histogram instead of binning again.
+ *  - The most recently used density grids, keyed by positions version, weights version, density source,
+ *    selection version, resolution and sigma.
+ */
+class DensityCache
+{
+public:
+
+    /** Identifies a density grid */
+    struct Key {
+        std::uint64_t   _positionsVersion   = 0;        /** Version of the point positions */
+        std::uint64_t   _weightsVersion     = 0;        /** Version of the point weights (zero when unweighted) */
+        std::uint32_t   _source             = 0;        /** Which points contribute (see DensityComputation::Source) */
+        std::uint64_t   _selectionVersion   = 0;        /** Version of the selection (zero when the density does not depend on it) */
+        std::uint32_t   _resolution         = 0;        /** Number of grid cells along each axis */
+        float           _sigma              = 0.0f;     /** Kernel width as a fraction of the grid width */
+
+        /** Equality operator (sigma is compared with a small tolerance so that slider round-off still hits) */
+        bool operator==(const Key& other) const;
+    };
+
+public:
+
+    /**
+     * Constructor
+     * @param capacity Maximum number of cached density grids
+     */
+    DensityCache(const std::size_t& capacity = DEFAULT_CAPACITY);
+
+    /**
+     * Get the histogram of \p positions at \p resolution (computed at most once per positions version, weights version and bounds)
+     * @param positions Point positions
+     * @param bounds Data bounds covered by the grid
+     * @param positionsVersion Version of the point positions
+     * @param resolution Number of grid cells along each axis (must divide the full resolution)
+     * @param weights Optional per-point weights
+     * @param weightsVersion Version of the point weights (zero when unweighted)
+     * @return Histogram (counts are expressed per full resolution cell)
+     */
+    std::shared_ptr<const DensityGrid> getHistogram(const std::vector<Vector2f>& positions, const Bounds& bounds, const std::uint64_t& positionsVersion, const std::uint32_t& resolution, const std::vector<float>* weights = nullptr, const std::uint64_t& weightsVersion = 0);
+
+    /**
+     * Find a cached density grid (marks it as most recently used)
+     * @param key Density key
+     * @return Density grid, nullptr when not cached
+     */
+    std::shared_ptr<const DensityGrid> findDensity(const Key& key);
+
+    /**
+     * Add a density grid to the cache (evicts the least recently used grid when full)
+     * @param key Density key
+     * @param density Density grid
+     */
+    void insertDensity(const Key& key, const std::shared_ptr<const DensityGrid>& density);
+
+    /** Remove all histograms and density grids */
+    void clear();
+
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 8;     /** Default maximum number of cached density grids */
+
+private:
+    std::size_t                                                     _capacity;              /** Maximum number of cached density grids */
+    std::uint64_t                                                   _histogramVersion;      /** Positions version of the cached histograms */
+    std::uint64_t                                                   _histogramWeightsVersion;   /** Weights version of the cached histograms */
+    Bounds                                                          _histogramBounds;       /** Data bounds of the cached histograms */
+    std::vector<std::shared_ptr<const DensityGrid>>                 _histograms;            /** Cached histograms (full resolution first) */
+    std::list<std::pair<Key, std::shared_ptr<const DensityGrid>>>   _densities;             /** Cached density grids (most recently used first) */
+};
@@ -0,0 +1,452 @@
+#include "DensityComputation.h"
+#include "KernelDensityEstimator.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <numeric>
+
+DensityComputation::DensityComputation(QObject* parent /*= nullptr*/) :
+    QObject(parent),
+    _positions(nullptr),
+    _positionsVersion(0),
+    _bounds(),
+    _sigma(0.15f),
+    _weights(),
+    _weightsVersion(0),
+    _numberOfWeightsUpdates(0),
+    _source(Source::All),
+    _highlights(),
+    _selectionVersion(0),
+    _selectionHistogram(),
+    _selectionHistogramTotal(0.0f),
+    _selectionHistogramInputs(),
+    _density(),
+    _histogram(),
+    _watcher(),
+    _canceled(),
+    _generation(0),
+    _runningGeneration(0),
+    _pending(false),
+    _busy(false),
+    _cache(),
+    _requestedKey(),
+    _runningKey(),
+    _refineTimer()
+{
+    // Apply the density when the background computation finished
+    connect(&_watcher, &QFutureWatcherBase::finished, this, &DensityComputation::finished);
+
+    // Compute the full resolution density when the interaction (e.g. dragging the sigma slider) settles
+    _refineTimer.setSingleShot(true);
+    _refineTimer.setInterval(REFINE_INTERVAL);
+
+    connect(&_refineTimer, &QTimer::timeout, this, &DensityComputation::compute);
+}
+
+DensityComputation::~DensityComputation()
+{
+    // Stop the background computation
+    if (_watcher.isRunning()) {
+        *_canceled = true;
+        _watcher.waitForFinished();
+    }
+}
+
+void DensityComputation::setPositions(const std::vector<Vector2f>* positions, const std::uint64_t& positionsVersion, const Bounds& bounds)
+{
+    _positions  = positions;
+    _bounds     = bounds;
+
+    // Only invalidate the densities when the positions actually changed
+    if (positionsVersion == _positionsVersion)
+        return;
+
+    _positionsVersion = positionsVersion;
+
+    // Cached histograms and densities belong to the previous positions
+    _cache.clear();
+}
+
+void DensityComputation::setSigma(const float& sigma)
+{
+    _sigma = sigma;
+}
+
+void DensityComputation::setWeights(const std::vector<float>& weights)
+{
+    _weights = weights;
+
+    // Each set of weights gets a new version (version zero is reserved for the unweighted density)
+    _weightsVersion = ++_numberOfWeightsUpdates;
+}
+
+void DensityComputation::clearWeights()
+{
+    _weights.clear();
+    _weightsVersion = 0;
+}
+
+bool DensityComputation::hasWeights() const
+{
+    return _weightsVersion > 0;
+}
+
+std::uint64_t DensityComputation::getWeightsVersion() const
+{
+    return _weightsVersion;
+}
+
+DensityComputation::Source DensityComputation::getSource() const
+{
+    return _source;
+}
+
+void DensityComputation::setSource(const Source& source)
+{
+    _source = source;
+}
+
+std::uint64_t DensityComputation::getSelectionVersion() const
+{
+    return _source == Source::All ? 0 : _selectionVersion;
+}
+
+void DensityComputation::updateHighlights(const std::vector<char>& highlights, const std::vector<std::uint32_t>& changedIndices)
+{
+    // Changes can only be applied to a histogram of the same points
+    const auto incremental = _selectionHistogram.isValid() && getHistogramInputs() == _selectionHistogramInputs && _positions != nullptr && _positions->size() == highlights.size() && _highlights.size() == highlights.size();
+
+    if (incremental) {
+        const auto weights      = getWeights();
+        const auto resolution   = _selectionHistogram.getResolution();
+
+        auto& values = _selectionHistogram.getValues();
+
+        // Add newly selected points to the histogram and remove deselected ones
+        for (const auto& changedIndex : changedIndices) {
+            if (changedIndex >= highlights.size() || _highlights[changedIndex] == highlights[changedIndex])
+                continue;
+
+            _highlights[changedIndex] = highlights[changedIndex];
+
+            std::size_t cellIndex = 0;
+
+            if (!KernelDensityEstimator::getCellIndex((*_positions)[changedIndex], _bounds, resolution, cellIndex))
+                continue;
+
+            const auto weight       = weights != nullptr && weights->size() == highlights.size() ? (*weights)[changedIndex] : 1.0f;
+            const auto signedWeight = highlights[changedIndex] ? weight : -weight;
+
+            // Prevent round-off from producing negative counts
+            values[cellIndex]           = std::max(0.0f, values[cellIndex] + signedWeight);
+            _selectionHistogramTotal    = std::max(0.0f, _selectionHistogramTotal + signedWeight);
+        }
+    }
+    else {
+        _highlights = highlights;
+
+        // Rebuild the selection histogram when it is needed next
+        _selectionHistogram.reset(0);
+    }
+
+    _selectionVersion++;
+}
+
+void DensityComputation::compute()
+{
+    // A full resolution density supersedes a scheduled refinement
+    _refineTimer.stop();
+
+    request(KernelDensityEstimator::DEFAULT_RESOLUTION);
+}
+
+void DensityComputation::computeInteractive()
+{
+    // Use the full resolution density right away when it is cached
+    if (_cache.findDensity(getKey(KernelDensityEstimator::DEFAULT_RESOLUTION))) {
+        compute();
+        return;
+    }
+
+    // Compute a quick preview from the cached histogram at reduced resolution and refine once the interaction settles
+    request(KernelDensityEstimator::DEFAULT_RESOLUTION / INTERACTIVE_RESOLUTION_FACTOR);
+
+    _refineTimer.start();
+}
+
+void DensityComputation::waitForFinished()
+{
+    const auto isPreview = _density && _density->getResolution() != KernelDensityEstimator::DEFAULT_RESOLUTION;
+
+    if (!_watcher.isRunning() && !_pending && !_refineTimer.isActive() && !isPreview)
+        return;
+
+    _refineTimer.stop();
+
+    // Stop the running computation, its result is replaced below
+    if (_watcher.isRunning()) {
+        *_canceled = true;
+
+        _watcher.waitForFinished();
+    }
+
+    _pending = false;
+
+    // Discard the result of the running computation when its finished signal arrives
+    _generation++;
+
+    apply(getFullResolutionDensity());
+
+    setBusy(false);
+}
+
+void DensityComputation::reset()
+{
+    cancel();
+
+    _refineTimer.stop();
+    _cache.clear();
+    _histogram.reset();
+    _density.reset();
+
+    // The abandoned computation no longer counts as in progress
+    setBusy(false);
+}
+
+std::shared_ptr<const DensityGrid> DensityComputation::getDensity() const
+{
+    return _density;
+}
+
+std::shared_ptr<const DensityGrid> DensityComputation::getFullResolutionDensity()
+{
+    const auto key = getKey(KernelDensityEstimator::DEFAULT_RESOLUTION);
+
+    if (auto density = _cache.findDensity(key))
+        return density;
+
+    // Compute the full resolution density synchronously
+    auto density = std::make_shared<DensityGrid>();
+
+    KernelDensityEstimator::blur(*getHistogram(key._resolution), _sigma, *density);
+
+    _cache.insertDensity(key, density);
+
+    return density;
+}
+
+bool DensityComputation::isBusy() const
+{
+    return _busy;
+}
+
+DensityCache::Key DensityComputation::getKey(const std::uint32_t& resolution) const
+{
+    return { _positionsVersion, _weightsVersion, static_cast<std::uint32_t>(_source), getSelectionVersion(), resolution, _sigma };
+}
+
+const std::vector<float>* DensityComputation::getWeights() const
+{
+    return _weightsVersion > 0 ? &_weights : nullptr;
+}
+
+std::shared_ptr<const DensityGrid> DensityComputation::getHistogram(const std::uint32_t& resolution)
+{
+    if (_positions == nullptr)
+        return std::make_shared<const DensityGrid>();
+
+    const auto fullResolution = KernelDensityEstimator::DEFAULT_RESOLUTION;
+
+    if (_source == Source::All)
+        return _cache.getHistogram(*_positions, _bounds, _positionsVersion, resolution, getWeights(), _weightsVersion);
+
+    updateSelectionHistogram();
+
+    // Copy, the selection histogram keeps changing while the copy is convolved in the background
+    auto histogram = std::make_shared<DensityGrid>(_selectionHistogram);
+
+    if (_source == Source::Difference) {
+        auto& values = histogram->getValues();
+
+        // Without a selection there is nothing to compare
+        if (_selectionHistogramTotal <= 0.0f) {
+            histogram->reset(fullResolution);
+        }
+        else {
+            const auto& allValues   = _cache.getHistogram(*_positions, _bounds, _positionsVersion, fullResolution, getWeights(), _weightsVersion)->getValues();
+            const auto allTotal     = std::accumulate(allValues.begin(), allValues.end(), 0.0);
+
+            // Normalize both histograms to unit mass so that the difference is independent of the selection size
+            const auto selectionNormalization   = 1.0f / _selectionHistogramTotal;
+            const auto allNormalization         = allTotal > 0.0 ? static_cast<float>(1.0 / allTotal) : 0.0f;
+
+            for (std::size_t cellIndex = 0; cellIndex < values.size() && cellIndex < allValues.size(); cellIndex++)
+                values[cellIndex] = selectionNormalization * values[cellIndex] - allNormalization * allValues[cellIndex];
+        }
+    }
+
+    histogram->updateRange();
+
+    if (resolution == fullResolution || resolution == 0 || fullResolution % resolution != 0)
+        return histogram;
+
+    auto downsampled = std::make_shared<DensityGrid>();
+
+    KernelDensityEstimator::downsample(*histogram, fullResolution / resolution, *downsampled);
+
+    return downsampled;
+}
+
+void DensityComputation::updateSelectionHistogram()
+{
+    const auto histogramInputs = getHistogramInputs();
+
+    if (_selectionHistogram.isValid() && histogramInputs == _selectionHistogramInputs)
+        return;
+
+    _selectionHistogramInputs   = histogramInputs;
+    _selectionHistogramTotal    = 0.0f;
+
+    if (_positions == nullptr) {
+        _selectionHistogram.reset(KernelDensityEstimator::DEFAULT_RESOLUTION);
+        return;
+    }
+
+    const auto weights = getWeights();
+
+    // Bin the selected points only (unselected points get zero weight)
+    std::vector<float> selectionWeights(_positions->size(), 0.0f);
+
+    for (std::size_t pointIndex = 0; pointIndex < selectionWeights.size() && pointIndex < _highlights.size(); pointIndex++)
+        if (_highlights[pointIndex])
+            selectionWeights[pointIndex] = weights != nullptr && weights->size() == selectionWeights.size() ? (*weights)[pointIndex] : 1.0f;
+
+    KernelDensityEstimator::computeHistogram(*_positions, _bounds, KernelDensityEstimator::DEFAULT_RESOLUTION, _selectionHistogram, &selectionWeights);
+
+    const auto& values = _selectionHistogram.getValues();
+
+    _selectionHistogramTotal = static_cast<float>(std::accumulate(values.begin(), values.end(), 0.0));
+}
+
+void DensityComputation::request(const std::uint32_t& resolution)
+{
+    const auto key = getKey(resolution);
+
+    // Apply a cached density immediately and stop the computation in progress (if any)
+    if (const auto density = _cache.findDensity(key)) {
+        cancel();
+
+        _requestedKey = key;
+
+        apply(density);
+
+        // The canceled computation (if any) is abandoned
+        setBusy(false);
+
+        return;
+    }
+
+    // Each request supersedes the previous ones
+    _generation++;
+    _requestedKey = key;
+
+    setBusy(true);
+
+    // Binning reads the positions, so it happens here (the positions may change while the convolution runs)
+    _histogram = getHistogram(resolution);
+
+    // Cancel the superseded computation and start again when it has stopped
+    if (_watcher.isRunning()) {
+        *_canceled  = true;
+        _pending    = true;
+
+        return;
+    }
+
+    start();
+
+    // The last finished density stays available until the new one is ready
+}
+
+void DensityComputation::start()
+{
+    _runningGeneration  = _generation;
+    _runningKey         = _requestedKey;
+
+    // Each computation gets its own flag so that canceling does not affect the next one
+    _canceled = std::make_shared<std::atomic_bool>(false);
+
+    const auto histogram    = _histogram;
+    const auto sigma        = _runningKey._sigma;
+    const auto canceled     = _canceled;
+
+    _watcher.setFuture(QtConcurrent::run([histogram, sigma, canceled]() -> std::shared_ptr<DensityGrid> {
+        auto density = std::make_shared<DensityGrid>();
+
+        KernelDensityEstimator::blur(*histogram, sigma, *density, canceled.get());
+
+        return density;
+    }));
+}
+
+void DensityComputation::finished()
+{
+    // A newer request arrived while computing, so discard this result and compute the latest
+    if (_pending) {
+        _pending = false;
+
+        start();
+
+        return;
+    }
+
+    // The result was superseded in the meantime (e.g. by a cached density or a reset)
+    if (_runningGeneration != _generation)
+        return;
+
+    const std::shared_ptr<const DensityGrid> density = _watcher.result();
+
+    _cache.insertDensity(_runningKey, density);
+
+    apply(density);
+
+    setBusy(false);
+}
+
+void DensityComputation::cancel()
+{
+    if (_watcher.isRunning())
+        *_canceled = true;
+
+    _pending = false;
+
+    // Discard the result of the running computation when its finished signal arrives
+    _generation++;
+}
+
+void DensityComputation::apply(const std::shared_ptr<const DensityGrid>& density)
+{
+    _density = density;
+
+    emit densityChanged();
+}
+
+void DensityComputation::setBusy(const bool& busy)
+{
+    if (busy == _busy)
+        return;
+
+    _busy = busy;
+
+    // Started and ended are paired, however many computations are started, canceled or abandoned in between
+    if (_busy)
+        emit started();
+    else
+        emit ended();
+}
+
+DensityComputation::HistogramInputs DensityComputation::getHistogramInputs() const
+{
+    return { _positionsVersion, _weightsVersion, _bounds.getLeft(), _bounds.getRight(), _bounds.getBottom(), _bounds.getTop() };
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "DensityGrid.h"
+#include "DensityCache.h"
+
+#include "graphics/Vector2f.h"
+#include "graphics/Bounds.h"
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QTimer>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace hdps;
+
+/**
+ * Density computation class
+ *
+ * State machine of the CPU density backend. It bins the points (all points, the selected points or their difference),
+ * convolves the histogram in a background thread and cancels superseded requests. Recent results are cached and
+ * reduced resolution previews are refined once the interaction settles.
+ */
+class DensityComputation : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /** Which points contribute to the density */
+    enum class Source {
+        All,           /** All points */
+        Selection,     /** Selected points only */
+        Difference,    /** Normalized density of the selected points minus the normalized density of all points */
+    };
+
+public:
+
+    /**
+     * Constructor
+     * @param parent Pointer to parent object
+     */
+    DensityComputation(QObject* parent = nullptr);
+
+    /** Destructor (stops the background computation) */
+    ~DensityComputation() override;
+
+    /**
+     * Set the point positions
+     * @param positions Point positions (owned by the caller)
+     * @param positionsVersion Version of the positions (cached densities of other versions are discarded)
+     * @param bounds Data bounds covered by the density grid
+     */
+    void setPositions(const std::vector<Vector2f>* positions, const std::uint64_t& positionsVersion, const Bounds& bounds);
+
+    /**
+     * Set the kernel width
+     * @param sigma Kernel width as a fraction of the grid width
+     */
+    void setSigma(const float& sigma);
+
+    /**
+     * Weigh each point by a scalar (e.g. the expression of a gene)
+     * @param weights Per-point weights (same size as the positions)
+     */
+    void setWeights(const std::vector<float>& weights);
+
+    /** Compute the unweighted (point) density again */
+    void clearWeights();
+
+    /** Get whether the density is weighted */
+    bool hasWeights() const;
+
+    /** Get the version of the weights (zero when unweighted) */
+    std::uint64_t getWeightsVersion() const;
+
+    /** Get/set which points contribute to the density */
+    Source getSource() const;
+    void setSource(const Source& source);
+
+    /** Get the selection version the density depends on (zero for the density of all points) */
+    std::uint64_t getSelectionVersion() const;
+
+    /**
+     * Update the selection histogram incrementally (only the points for which the selection state changed are binned)
+     * @param highlights Selection state per point
+     * @param changedIndices Local indices of the points for which the selection state changed
+     */
+    void updateHighlights(const std::vector<char>& highlights, const std::vector<std::uint32_t>& changedIndices);
+
+    /** Request the full resolution density */
+    void compute();
+
+    /** Compute a reduced resolution density now and the full resolution density once the interaction settles */
+    void computeInteractive();
+
+    /** Wait for the computation in progress (if any) and apply the full resolution density (e.g. before a screenshot) */
+    void waitForFinished();
+
+    /** Stop the computation in progress and release the cached and computed densities (e.g. when the GPU backend takes over) */
+    void reset();
+
+    /** Get the most recently computed (or cached) density, nullptr when there is none */
+    std::shared_ptr<const DensityGrid> getDensity() const;
+
+    /**
+     * Get the full resolution density of the current positions, weights, source and sigma (computed synchronously when it
+     * is not cached, the computation in progress is not affected)
+     * @return Density grid which covers the data bounds
+     */
+    std::shared_ptr<const DensityGrid> getFullResolutionDensity();
+
+    /** Get whether a computation is in progress */
+    bool isBusy() const;
+
+signals:
+
+    /** Signals that the computation has started (not signaled again until it has ended) */
+    void started();
+
+    /** Signals that the computation has ended (exactly once after it started, also when it was canceled) */
+    void ended();
+
+    /** Signals that a new density was computed or taken from the cache */
+    void densityChanged();
+
+protected:
+
+    /**
+     * Get the density cache key of the current inputs at \p resolution
+     * @param resolution Number of grid cells along each axis
+     * @return Density cache key
+     */
+    DensityCache::Key getKey(const std::uint32_t& resolution) const;
+
+    /** Get the per-point weights, nullptr when the density is unweighted */
+    const std::vector<float>* getWeights() const;
+
+    /**
+     * Get the histogram of the current source at \p resolution
+     * @param resolution Number of grid cells along each axis (must divide the full resolution)
+     * @return Histogram (a copy which is not modified by subsequent selection changes)
+     */
+    std::shared_ptr<const DensityGrid> getHistogram(const std::uint32_t& resolution);
+
+    /** Bin the selected points again when the positions, weights or bounds changed since the selection histogram was built */
+    void updateSelectionHistogram();
+
+    /**
+     * Request the density at \p resolution (uses the density cache)
+     * @param resolution Number of grid cells along each axis
+     */
+    void request(const std::uint32_t& resolution);
+
+    /** Start convolving the current histogram in a background thread */
+    void start();
+
+    /** Invoked when the background computation finished */
+    void finished();
+
+    /** Cancel the running background computation (if any) and discard its result */
+    void cancel();
+
+    /**
+     * Apply a computed density grid
+     * @param density Density grid
+     */
+    void apply(const std::shared_ptr<const DensityGrid>& density);
+
+    /**
+     * Set whether a computation is in progress, signals the start on the first and the end after the last computation
+     * @param busy Whether a computation is in progress
+     */
+    void setBusy(const bool& busy);
+
+protected:
+
+    /** Inputs the selection histogram depends on */
+    struct HistogramInputs {
+        std::uint64_t   _positionsVersion   = 0;        /** Version of the point positions */
+        std::uint64_t   _weightsVersion     = 0;        /** Version of the point weights (zero when unweighted) */
+        float           _left               = 0.0f;     /** Left of the data bounds */
+        float           _right              = 0.0f;     /** Right of the data bounds */
+        float           _bottom             = 0.0f;     /** Bottom of the data bounds */
+        float           _top                = 0.0f;     /** Top of the data bounds */
+
+        bool operator==(const HistogramInputs& other) const {
+            return _positionsVersion == other._positionsVersion && _weightsVersion == other._weightsVersion && _left == other._left && _right == other._right && _bottom == other._bottom && _top == other._top;
+        }
+    };
+
+    /** Get the current selection histogram inputs */
+    HistogramInputs getHistogramInputs() const;
+
+private:
+    const std::vector<Vector2f>*                    _positions;                 /** Pointer to the point positions (owned by the plugin) */
+    std::uint64_t                                   _positionsVersion;          /** Version of the point positions */
+    Bounds                                          _bounds;                    /** Data bounds covered by the density grid */
+    float                                           _sigma;                     /** Kernel width as a fraction of the grid width */
+    std::vector<float>                              _weights;                   /** Per-point weights */
+    std::uint64_t                                   _weightsVersion;            /** Version of the weights (zero when unweighted) */
+    std::uint64_t                                   _numberOfWeightsUpdates;    /** Number of times weights were set (source of weights versions) */
+    Source                                          _source;                    /** Which points contribute to the density */
+    std::vector<char>                               _highlights;                /** Selection state per point */
+    std::uint64_t                                   _selectionVersion;          /** Incremented each time the selection changes */
+    DensityGrid                                     _selectionHistogram;        /** Full resolution histogram of the selected points (updated incrementally) */
+    float                                           _selectionHistogramTotal;   /** Sum of the selection histogram */
+    HistogramInputs                                 _selectionHistogramInputs;  /** Inputs the selection histogram was built for */
+    std::shared_ptr<const DensityGrid>              _density;                   /** Most recently computed density (shared with the density cache) */
+    std::shared_ptr<const DensityGrid>              _histogram;                 /** Histogram of the positions (input of the background convolution) */
+    QFutureWatcher<std::shared_ptr<DensityGrid>>    _watcher;                   /** Watches the background convolution */
+    std::shared_ptr<std::atomic_bool>               _canceled;                  /** Cancels the running background convolution */
+    std::uint64_t                                   _generation;                /** Incremented for each request (results of older requests are discarded) */
+    std::uint64_t                                   _runningGeneration;         /** Generation of the running background convolution */
+    bool                                            _pending;                   /** Whether a request arrived while a convolution was running */
+    bool                                            _busy;                      /** Whether started was signaled without ended */
+    DensityCache                                    _cache;                     /** Cached histograms and recently used density grids */
+    DensityCache::Key                               _requestedKey;              /** Key of the most recently requested density */
+    DensityCache::Key                               _runningKey;                /** Key of the density which is computed in the background */
+    QTimer                                          _refineTimer;               /** Triggers the full resolution density after interaction */
+
+    static constexpr std::uint32_t  INTERACTIVE_RESOLUTION_FACTOR   = 4;    /** Resolution reduction during interaction */
+    static constexpr std::int32_t   REFINE_INTERVAL                 = 250;  /** Delay (in ms) after the last interaction before the full resolution density is computed */
+};
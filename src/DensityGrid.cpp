@@ -0,0 +1,152 @@
+#include "DensityGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+DensityGrid::DensityGrid(const std::uint32_t& resolution /*= 0*/) :
+    _resolution(0),
+    _values(),
+    _minimum(0.0f),
+    _maximum(0.0f)
+{
+    reset(resolution);
+}
+
+void DensityGrid::reset(const std::uint32_t& resolution)
+{
+    _resolution = resolution;
+    _minimum    = 0.0f;
+    _maximum    = 0.0f;
+
+    _values.assign(static_cast<std::size_t>(resolution) * resolution, 0.0f);
+}
+
+std::uint32_t DensityGrid::getResolution() const
+{
+    return _resolution;
+}
+
+bool DensityGrid::isValid() const
+{
+    return _resolution > 0;
+}
+
+float DensityGrid::getValue(const std::uint32_t& x, const std::uint32_t& y) const
+{
+    return _values[static_cast<std::size_t>(y) * _resolution + x];
+}
+
+std::vector<float>& DensityGrid::getValues()
+{
+    return _values;
+}
+
+const std::vector<float>& DensityGrid::getValues() const
+{
+    return _values;
+}
+
+float DensityGrid::getMinimum() const
+{
+    return _minimum;
+}
+
+float DensityGrid::getMaximum() const
+{
+    return _maximum;
+}
+
+void DensityGrid::updateRange()
+{
+    if (_values.empty()) {
+        _minimum = 0.0f;
+        _maximum = 0.0f;
+        return;
+    }
+
+    const auto range = std::minmax_element(_values.begin(), _values.end());
+
+    _minimum = *range.first;
+    _maximum = *range.second;
+}
+
+QImage DensityGrid::toDensityImage(const QColor& color) const
+{
+    QImage image(_resolution, _resolution, QImage::Format_ARGB32);
+
+    // Prevent zero division for empty grids
+    const auto normalization = _maximum > 0.0f ? 1.0f / _maximum : 0.0f;
+
+    for (std::uint32_t y = 0; y < _resolution; y++) {
+
+        // Grid rows are stored bottom-up, image rows top-down
+        auto scanLine = reinterpret_cast<QRgb*>(image.scanLine(_resolution - 1 - y));
+
+        for (std::uint32_t x = 0; x < _resolution; x++)
+            scanLine[x] = qRgba(color.red(), color.green(), color.blue(), static_cast<int>(255.0f * std::min(1.0f, getValue(x, y) * normalization)));
+    }
+
+    return image;
+}
+
+QImage DensityGrid::toDifferenceImage(const QColor& negativeColor, const QColor& positiveColor) const
+{
+    QImage image(_resolution, _resolution, QImage::Format_ARGB32);
+
+    // Normalize by the largest absolute value so that zero is transparent (prevent zero division for empty grids)
+    const auto largestAbsoluteValue = std::max(std::abs(_minimum), std::abs(_maximum));
+    const auto normalization        = largestAbsoluteValue > 0.0f ? 1.0f / largestAbsoluteValue : 0.0f;
+
+    for (std::uint32_t y = 0; y < _resolution; y++) {
+
+        // Grid rows are stored bottom-up, image rows top-down
+        auto scanLine = reinterpret_cast<QRgb*>(image.scanLine(_resolution - 1 - y));
+
+        for (std::uint32_t x = 0; x < _resolution; x++) {
+            const auto value    = getValue(x, y);
+            const auto& color   = value < 0.0f ? negativeColor : positiveColor;
+
+            scanLine[x] = qRgba(color.red(), color.green(), color.blue(), static_cast<int>(255.0f * std::min(1.0f, std::abs(value) * normalization)));
+        }
+    }
+
+    return image;
+}
+
+QImage DensityGrid::toLandscapeImage(const QImage& colorMapImage, const float& minimum, const float& maximum) const
+{
+    QImage image(_resolution, _resolution, QImage::Format_ARGB32);
+
+    if (colorMapImage.isNull()) {
+        image.fill(Qt::transparent);
+        return image;
+    }
+
+    // Sample the color map along the center row
+    const auto colorMapWidth    = colorMapImage.width();
+    const auto colorMapRow      = colorMapImage.height() / 2;
+
+    // Look-up table so that the color map image is only sampled once per color map texel
+    std::vector<QRgb> lookupTable(colorMapWidth);
+
+    for (int colorMapIndex = 0; colorMapIndex < colorMapWidth; colorMapIndex++)
+        lookupTable[colorMapIndex] = colorMapImage.pixel(colorMapIndex, colorMapRow);
+
+    // Prevent zero division for an empty range
+    const auto rangeLength = maximum - minimum;
+    const auto normalization = rangeLength > 0.0f ? 1.0f / rangeLength : 0.0f;
+
+    for (std::uint32_t y = 0; y < _resolution; y++) {
+
+        // Grid rows are stored bottom-up, image rows top-down
+        auto scanLine = reinterpret_cast<QRgb*>(image.scanLine(_resolution - 1 - y));
+
+        for (std::uint32_t x = 0; x < _resolution; x++) {
+            const auto normalizedValue = std::clamp((getValue(x, y) - minimum) * normalization, 0.0f, 1.0f);
+
+            scanLine[x] = lookupTable[static_cast<int>(normalizedValue * (colorMapWidth - 1))];
+        }
+    }
+
+    return image;
+}
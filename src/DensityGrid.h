@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QColor>
+#include <QImage>
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Density grid class
+ *
+ * Square grid of (density) values which covers the data bounds of the scatter plot. Row zero
+ * corresponds to the bottom of the data bounds (the y-axis points up).
+ */
+class DensityGrid
+{
+public:
+
+    /**
+     * Constructor
+     * @param resolution Number of cells along each axis
+     */
+    DensityGrid(const std::uint32_t& resolution = 0);
+
+    /**
+     * Resize the grid and reset all values to zero
+     * @param resolution Number of cells along each axis
+     */
+    void reset(const std::uint32_t& resolution);
+
+    /** Get the number of cells along each axis */
+    std::uint32_t getResolution() const;
+
+    /** Get whether the grid contains any cells */
+    bool isValid() const;
+
+    /**
+     * Get the value of a cell
+     * @param x Column index
+     * @param y Row index
+     * @return Value of the cell
+     */
+    float getValue(const std::uint32_t& x, const std::uint32_t& y) const;
+
+    /** Get the cell values (row major) */
+    std::vector<float>& getValues();
+
+    /** Get the cell values (row major) */
+    const std::vector<float>& getValues() const;
+
+    /** Get the smallest cell value (as established by the last call to updateRange) */
+    float getMinimum() const;
+
+    /** Get the largest cell value (as established by the last call to updateRange) */
+    float getMaximum() const;
+
+    /** Establish the smallest and largest cell values */
+    void updateRange();
+
+    /**
+     * Convert to a monochrome image in which the opacity follows the normalized density
+     * @param color Color of the densest cells
+     * @return Image with the same resolution as the grid (top row first)
+     */
+    QImage toDensityImage(const QColor& color) const;
+
+    /**
+     * Convert to an image of signed values (e.g. a density difference) in which the opacity follows the absolute value
+     * @param negativeColor Color of negative cells
+     * @param positiveColor Color of positive cells
+     * @return Image with the same resolution as the grid (top row first)
+     */
+    QImage toDifferenceImage(const QColor& negativeColor, const QColor& positiveColor) const;
+
+    /**
+     * Convert to a color mapped image (density landscape)
+     * @param colorMapImage One-dimensional color map image
+     * @param minimum Value that maps to the start of the color map
+     * @param maximum Value that maps to the end of the color map
+     * @return Image with the same resolution as the grid (top row first)
+     */
+    QImage toLandscapeImage(const QImage& colorMapImage, const float& minimum, const float& maximum) const;
+
+private:
+    std::uint32_t           _resolution;    /** Number of cells along each axis */
+    std::vector<float>      _values;        /** Cell values (row major) */
+    float                   _minimum;       /** Smallest cell value */
+    float                   _maximum;       /** Largest cell value */
+};
@@ -0,0 +1,110 @@
+#include "DensityPeakClustering.h"
+#include "KernelDensityEstimator.h"
+#include "IndexRanges.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <numeric>
+
+std::vector<std::size_t> DensityPeakClustering::clusterGrid(const DensityGrid& density, const float& minimumDensity, std::vector<std::int32_t>& cellLabels)
+{
+    const auto resolution       = static_cast<std::int64_t>(density.getResolution());
+    const auto& values          = density.getValues();
+    const auto numberOfCells    = values.size();
+
+    cellLabels.assign(numberOfCells, NO_CLUSTER);
+
+    if (numberOfCells == 0)
+        return {};
+
+    // Index of the densest neighbor per cell (the cell itself for peaks and cells below the minimum density)
+    std::vector<std::size_t> ascent(numberOfCells);
+
+    std::vector<std::int64_t> rows(resolution);
+
+    std::iota(rows.begin(), rows.end(), 0);
+
+    // Rows are independent, so each one is processed by a separate task
+    QtConcurrent::blockingMap(rows, [&](const std::int64_t& y) -> void {
+        for (std::int64_t x = 0; x < resolution; x++) {
+            const auto cellIndex = static_cast<std::size_t>(y * resolution + x);
+
+            ascent[cellIndex] = cellIndex;
+
+            if (values[cellIndex] < minimumDensity)
+                continue;
+
+            auto highestValue = values[cellIndex];
+
+            // Climb to the densest of the eight neighbors (if it is denser than the cell itself), ties are broken on the
+            // cell index so that a plateau ascends to one cell instead of splitting into single cell clusters
+            for (std::int64_t neighborY = std::max<std::int64_t>(0, y - 1); neighborY <= std::min(resolution - 1, y + 1); neighborY++) {
+                for (std::int64_t neighborX = std::max<std::int64_t>(0, x - 1); neighborX <= std::min(resolution - 1, x + 1); neighborX++) {
+                    const auto neighborIndex = static_cast<std::size_t>(neighborY * resolution + neighborX);
+
+                    if (values[neighborIndex] > highestValue || (values[neighborIndex] == highestValue && neighborIndex > ascent[cellIndex])) {
+                        highestValue        = values[neighborIndex];
+                        ascent[cellIndex]   = neighborIndex;
+                    }
+                }
+            }
+        }
+    });
+
+    // Peaks are the cells above the minimum density which do not ascend any further
+    std::vector<std::size_t> peaks;
+
+    for (std::size_t cellIndex = 0; cellIndex < numberOfCells; cellIndex++)
+        if (ascent[cellIndex] == cellIndex && values[cellIndex] >= minimumDensity && values[cellIndex] > 0.0f)
+            peaks.push_back(cellIndex);
+
+    // Number the clusters from the densest peak down (on the same (value, index) order as the ascent)
+    std::sort(peaks.begin(), peaks.end(), [&values](const std::size_t& lhs, const std::size_t& rhs) -> bool {
+        return values[lhs] > values[rhs] || (values[lhs] == values[rhs] && lhs > rhs);
+    });
+
+    for (std::size_t peakIndex = 0; peakIndex < peaks.size(); peakIndex++)
+        cellLabels[peaks[peakIndex]] = static_cast<std::int32_t>(peakIndex);
+
+    // Follow the ascent to the peak, labeling the whole path on the way back (each cell is resolved once)
+    std::vector<std::size_t> path;
+
+    for (std::size_t cellIndex = 0; cellIndex < numberOfCells; cellIndex++) {
+        if (cellLabels[cellIndex] != NO_CLUSTER || values[cellIndex] < minimumDensity)
+            continue;
+
+        auto current = cellIndex;
+
+        while (cellLabels[current] == NO_CLUSTER && ascent[current] != current) {
+            path.push_back(current);
+
+            current = ascent[current];
+        }
+
+        for (const auto& pathCellIndex : path)
+            cellLabels[pathCellIndex] = cellLabels[current];
+
+        path.clear();
+    }
+
+    return peaks;
+}
+
+void DensityPeakClustering::labelPoints(const std::vector<Vector2f>& positions, const Bounds& bounds, const std::uint32_t& resolution, const std::vector<std::int32_t>& cellLabels, std::vector<std::int32_t>& pointLabels)
+{
+    pointLabels.assign(positions.size(), NO_CLUSTER);
+
+    if (cellLabels.size() != static_cast<std::size_t>(resolution) * resolution)
+        return;
+
+    // Label ranges of points in parallel
+    QtConcurrent::blockingMap(common::getIndexRanges(positions.size()), [&](const common::IndexRange& pointRange) -> void {
+        for (auto pointIndex = pointRange.first; pointIndex < pointRange.second; pointIndex++) {
+            std::size_t cellIndex = 0;
+
+            if (KernelDensityEstimator::getCellIndex(positions[pointIndex], bounds, resolution, cellIndex))
+                pointLabels[pointIndex] = cellLabels[cellIndex];
+        }
+    });
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "DensityGrid.h"
+
+#include "graphics/Vector2f.h"
+#include "graphics/Bounds.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace hdps;
+
+/**
+ * Density peak clustering class
+ *
+ * Clusters points by the peaks (local maxima) of their density grid: every grid cell climbs to its
+ * densest neighbor until it reaches a peak (steepest ascent, i.e. mean-shift on the grid), after
+ * which each point gets the cluster of its grid cell. The cost is linear in the number of cells
+ * and points, which keeps it interactive for very large embeddings.
+ */
+class DensityPeakClustering
+{
+public:
+
+    /** Label of cells and points which do not belong to a cluster */
+    static constexpr std::int32_t NO_CLUSTER = -1;
+
+public:
+
+    /**
+     * Assign the cells of \p density to the peak they ascend to
+     * @param density Density grid
+     * @param minimumDensity Cells (and thereby peaks) with a lower density are not clustered
+     * @param cellLabels Cluster index per cell (row major), NO_CLUSTER for cells below the minimum density
+     * @return Cell index of the peak of each cluster (sorted by descending peak density)
+     */
+    static std::vector<std::size_t> clusterGrid(const DensityGrid& density, const float& minimumDensity, std::vector<std::int32_t>& cellLabels);
+
+    /**
+     * Label the points through their grid cell
+     * @param positions Point positions
+     * @param bounds Data bounds covered by the grid
+     * @param resolution Number of grid cells along each axis
+     * @param cellLabels Cluster index per cell (row major)
+     * @param pointLabels Cluster index per point, NO_CLUSTER for points outside the clustered cells
+     */
+    static void labelPoints(const std::vector<Vector2f>& positions, const Bounds& bounds, const std::uint32_t& resolution, const std::vector<std::int32_t>& cellLabels, std::vector<std::int32_t>& pointLabels);
+};
@@ -4,34 +4,89 @@
 #include "ViewerScatterplotPlugin.h"
 #include "ViewerScatterplotWidget.h"
 
+#include <algorithm>
+
 using namespace hdps::gui;
 
 DensityPlotAction::DensityPlotAction(PlotAction* plotAction, ViewerScatterplotPlugin* viewerscatterplotPlugin) :
     PluginAction(plotAction, viewerscatterplotPlugin, "Density"),
     _sigmaAction(this, "Sigma", 0.01f, 0.5f, DEFAULT_SIGMA, DEFAULT_SIGMA, 3),
-    _continuousUpdatesAction(this, "Live Updates", DEFAULT_CONTINUOUS_UPDATES, DEFAULT_CONTINUOUS_UPDATES)
+    _continuousUpdatesAction(this, "Live Updates", DEFAULT_CONTINUOUS_UPDATES, DEFAULT_CONTINUOUS_UPDATES),
+    _cpuComputationAction(this, "CPU", false, false),
+    _weightedAction(this, "Weighted", false, false),
+    _weightDatasetPickerAction(this, "Weight data"),
+    _weightDimensionAction(this, "Weight dim"),
+    _weightDataset(),
+    _densitySourceAction(this, "Points", { "All", "Selection", "Difference" }),
+    _contourLevelsAction(this, "Contours", 0, 32, 0, 0)
 {
     setToolTip("Density plot settings");
     setSerializationName("DensityPlot");
 
     _sigmaAction.setSerializationName("Sigma");
     _continuousUpdatesAction.setSerializationName("ContinuousUpdates");
+    _cpuComputationAction.setSerializationName("CPUComputation");
+    _weightedAction.setSerializationName("Weighted");
+    _weightDatasetPickerAction.setSerializationName("WeightDataset");
+    _weightDimensionAction.setSerializationName("WeightDimension");
+    _densitySourceAction.setSerializationName("DensitySource");
+    _contourLevelsAction.setSerializationName("ContourLevels");
+
+    _cpuComputationAction.setToolTip("Compute the density on the CPU (faster than software OpenGL, e.g. on virtual machines)");
+    _weightedAction.setToolTip("Weigh each point by the value of a dimension (e.g. gene expression) instead of counting points");
+    _weightDatasetPickerAction.setToolTip("Dataset which contains the weight dimension");
+    _weightDimensionAction.setToolTip("Dimension whose values weigh the points");
+    _densitySourceAction.setToolTip("Density of all points, of the selected points, or the normalized difference between the two");
+    _contourLevelsAction.setToolTip("Number of iso-contour lines drawn over the density (zero disables contours)");
 
     _viewerscatterplotPlugin->getWidget().addAction(&_sigmaAction);
     _viewerscatterplotPlugin->getWidget().addAction(&_continuousUpdatesAction);
+    _viewerscatterplotPlugin->getWidget().addAction(&_cpuComputationAction);
+    _viewerscatterplotPlugin->getWidget().addAction(&_weightedAction);
+    _viewerscatterplotPlugin->getWidget().addAction(&_densitySourceAction);
+    _viewerscatterplotPlugin->getWidget().addAction(&_contourLevelsAction);
+
+    // Only points datasets with one point per position can weigh the density
+    _weightDatasetPickerAction.setDatasetsFilterFunction([this](const hdps::Datasets& datasets) -> Datasets {
+        Datasets weightDatasets;
+
+        const auto& positionDataset = _viewerscatterplotPlugin->getPositionDataset();
+
+        if (!positionDataset.isValid())
+            return weightDatasets;
+
+        for (auto dataset : datasets)
+            if (dataset->getDataType() == PointType && Dataset<Points>(dataset)->getNumPoints() == positionDataset->getNumPoints())
+                weightDatasets << dataset;
+
+        return weightDatasets;
+    });
 
-    const auto computeDensity = [this]() -> void {
+    const auto updateColorMapRange = [this]() -> void {
+        const auto minDensity = std::min(0.0f, getViewerScatterplotWidget().getMinDensity());
+        const auto maxDensity = getViewerScatterplotWidget().getMaxDensity();
+
+        if (maxDensity > minDensity)
+            _viewerscatterplotPlugin->getSettingsAction().getColoringAction().getColorMapAction().getRangeAction(ColorMapAction::Axis::X).setRange({ minDensity, maxDensity });
+    };
+
+    const auto computeDensity = [this, updateColorMapRange]() -> void {
         getViewerScatterplotWidget().setSigma(_sigmaAction.getValue());
 
-        const auto maxDensity = getViewerScatterplotWidget().getDensityRenderer().getMaxDensity();
+        updateColorMapRange();
+    };
 
-        if (maxDensity > 0)
-            _viewerscatterplotPlugin->getSettingsAction().getColoringAction().getColorMapAction().getRangeAction(ColorMapAction::Axis::X).setRange({ 0.0f, maxDensity });
+    // The CPU density is computed in the background, so update the color map range when a new density is available
+    connect(&getViewerScatterplotWidget(), &ViewerScatterplotWidget::densityChanged, this, updateColorMapRange);
+
+    // The density is computed at most once per update pass
+    _viewerscatterplotPlugin->getUpdateScheduler().setUpdateFunction(UpdateScheduler::Buffer::Density, computeDensity);
+
+    const auto scheduleComputeDensity = [this]() -> void {
+        _viewerscatterplotPlugin->getUpdateScheduler().markDirty(UpdateScheduler::Buffer::Density);
     };
 
-    connect(&_sigmaAction, &DecimalAction::valueChanged, this, [this, computeDensity](const double& value) {
-        computeDensity();
-    });
+    connect(&_sigmaAction, &DecimalAction::valueChanged, this, scheduleComputeDensity);
 
     const auto updateSigmaAction = [this]() {
         _sigmaAction.setUpdateDuringDrag(_continuousUpdatesAction.isChecked());
@@ -39,17 +94,74 @@ DensityPlotAction::DensityPlotAction(PlotAction* plotAction, ViewerScatterplotPl
 
     connect(&_continuousUpdatesAction, &ToggleAction::toggled, updateSigmaAction);
 
-    connect(&_viewerscatterplotPlugin->getPositionDataset(), &Dataset<Points>::changed, this, [this, updateSigmaAction, computeDensity](DatasetImpl* dataset) {
+    connect(&_viewerscatterplotPlugin->getPositionDataset(), &Dataset<Points>::changed, this, [this, updateSigmaAction, scheduleComputeDensity](DatasetImpl* dataset) {
         updateSigmaAction();
-        computeDensity();
+        scheduleComputeDensity();
+    });
+
+    connect(&getViewerScatterplotWidget(), &ViewerScatterplotWidget::renderModeChanged, this, scheduleComputeDensity);
+
+    // Switch density backend and recompute
+    connect(&_cpuComputationAction, &ToggleAction::toggled, this, [this, scheduleComputeDensity](bool toggled) -> void {
+        getViewerScatterplotWidget().setDensityBackend(toggled ? ViewerScatterplotWidget::DensityBackend::CPU : ViewerScatterplotWidget::DensityBackend::GPU);
+
+        scheduleComputeDensity();
+    });
+
+    connect(&_weightedAction, &ToggleAction::toggled, this, [this](bool toggled) -> void {
+        updateCpuComputationAction();
+
+        _weightDatasetPickerAction.setEnabled(toggled);
+        _weightDimensionAction.setEnabled(toggled);
+
+        updateDensityWeights();
+    });
+
+    connect(&_weightDatasetPickerAction, &DatasetPickerAction::datasetPicked, this, [this](Dataset<DatasetImpl> pickedDataset) -> void {
+        _weightDataset = pickedDataset;
+
+        _weightDimensionAction.setPointsDataset(_weightDataset);
+
+        updateDensityWeights();
+    });
+
+    connect(&_weightDimensionAction, &DimensionPickerAction::currentDimensionIndexChanged, this, &DensityPlotAction::updateDensityWeights);
+
+    // Extract the weights again when the weight data changes
+    connect(&_weightDataset, &Dataset<Points>::dataChanged, this, &DensityPlotAction::updateDensityWeights);
+
+    // The number of positions might no longer match the weight dataset
+    connect(&_viewerscatterplotPlugin->getPositionDataset(), &Dataset<Points>::dataChanged, this, [this]() -> void {
+        if (_weightedAction.isChecked() && getViewerScatterplotWidget().hasDensityWeights() != isWeightDatasetValid())
+            updateDensityWeights();
+    });
+
+    connect(&_densitySourceAction, &OptionAction::currentIndexChanged, this, [this](const std::int32_t& currentIndex) -> void {
+        getViewerScatterplotWidget().setDensitySource(static_cast<ViewerScatterplotWidget::DensitySource>(currentIndex));
+
+        updateCpuComputationAction();
     });
 
-    connect(&getViewerScatterplotWidget(), &ViewerScatterplotWidget::renderModeChanged, this, [this, computeDensity](const ViewerScatterplotWidget::RenderMode& renderMode) {
-        computeDensity();
+    connect(&_contourLevelsAction, &IntegralAction::valueChanged, this, [this](const std::int32_t& value) -> void {
+        getViewerScatterplotWidget().setNumberOfContourLevels(static_cast<std::uint32_t>(std::max(0, value)));
+
+        updateCpuComputationAction();
     });
 
+    // Only the points for which the selection state changed are added to/removed from the selection histogram
+    connect(_viewerscatterplotPlugin, &ViewerScatterplotPlugin::highlightsChanged, &getViewerScatterplotWidget(), &ViewerScatterplotWidget::updateDensityHighlights);
+
+    // Default to the CPU backend when OpenGL is implemented in software
+    connect(&getViewerScatterplotWidget(), &ViewerScatterplotWidget::initialized, this, [this]() -> void {
+        if (getViewerScatterplotWidget().isSoftwareRenderer())
+            _cpuComputationAction.setChecked(true);
+    });
+
+    _weightDatasetPickerAction.setEnabled(false);
+    _weightDimensionAction.setEnabled(false);
+
     updateSigmaAction();
-    computeDensity();
+    scheduleComputeDensity();
 }
 
 QMenu* DensityPlotAction::getContextMenu()
@@ -68,16 +180,70 @@ QMenu* DensityPlotAction::getContextMenu()
 
     addActionToMenu(&_sigmaAction);
     addActionToMenu(&_continuousUpdatesAction);
+    addActionToMenu(&_cpuComputationAction);
+    addActionToMenu(&_weightedAction);
+    addActionToMenu(&_densitySourceAction);
+    addActionToMenu(&_contourLevelsAction);
 
     return menu;
 }
 
+void DensityPlotAction::updateCpuComputationAction()
+{
+    // Weighted and selection densities and contours are only supported by the CPU backend
+    const auto requiresCpu = _weightedAction.isChecked() || _densitySourceAction.getCurrentIndex() != 0 || _contourLevelsAction.getValue() > 0;
+
+    if (requiresCpu)
+        _cpuComputationAction.setChecked(true);
+
+    _cpuComputationAction.setEnabled(!requiresCpu);
+}
+
+bool DensityPlotAction::isWeightDatasetValid() const
+{
+    const auto& positionDataset = _viewerscatterplotPlugin->getPositionDataset();
+
+    return _weightDataset.isValid() && positionDataset.isValid() && _weightDataset->getNumPoints() == positionDataset->getNumPoints();
+}
+
+void DensityPlotAction::updateDensityWeights()
+{
+    const auto currentDimensionIndex = _weightDimensionAction.getCurrentDimensionIndex();
+
+    // Fall back to the point density when no (valid) weight dimension is selected
+    if (!_weightedAction.isChecked() || !isWeightDatasetValid() || currentDimensionIndex < 0 || currentDimensionIndex >= static_cast<std::int32_t>(_weightDataset->getNumDimensions())) {
+        getViewerScatterplotWidget().clearDensityWeights();
+        return;
+    }
+
+    const auto numberOfPoints = _weightDataset->getNumPoints();
+
+    std::vector<float> weights(numberOfPoints);
+
+    // Visit the points dataset to get access to the point values
+    _weightDataset->visitData([&weights, numberOfPoints, currentDimensionIndex](auto pointData) {
+        for (std::uint32_t pointIndex = 0; pointIndex < numberOfPoints; pointIndex++) {
+
+            // Negative weights have no meaning in a density
+            weights[pointIndex] = std::max(0.0f, static_cast<float>(pointData[pointIndex][currentDimensionIndex]));
+        }
+    });
+
+    getViewerScatterplotWidget().setDensityWeights(weights);
+}
+
 void DensityPlotAction::fromVariantMap(const QVariantMap& variantMap)
 {
     WidgetAction::fromVariantMap(variantMap);
 
     _sigmaAction.fromParentVariantMap(variantMap);
     _continuousUpdatesAction.fromParentVariantMap(variantMap);
+    _cpuComputationAction.fromParentVariantMap(variantMap);
+    _weightDatasetPickerAction.fromParentVariantMap(variantMap);
+    _weightDimensionAction.fromParentVariantMap(variantMap);
+    _weightedAction.fromParentVariantMap(variantMap);
+    _densitySourceAction.fromParentVariantMap(variantMap);
+    _contourLevelsAction.fromParentVariantMap(variantMap);
 }
 
 QVariantMap DensityPlotAction::toVariantMap() const
@@ -86,6 +252,12 @@ QVariantMap DensityPlotAction::toVariantMap() const
 
     _sigmaAction.insertIntoVariantMap(variantMap);
     _continuousUpdatesAction.insertIntoVariantMap(variantMap);
+    _cpuComputationAction.insertIntoVariantMap(variantMap);
+    _weightedAction.insertIntoVariantMap(variantMap);
+    _weightDatasetPickerAction.insertIntoVariantMap(variantMap);
+    _weightDimensionAction.insertIntoVariantMap(variantMap);
+    _densitySourceAction.insertIntoVariantMap(variantMap);
+    _contourLevelsAction.insertIntoVariantMap(variantMap);
 
     return variantMap;
 }
@@ -99,6 +271,14 @@ DensityPlotAction::Widget::Widget(QWidget* parent, DensityPlotAction* densityPlo
     layout->addWidget(densityPlotAction->_sigmaAction.createLabelWidget(this));
     layout->addWidget(densityPlotAction->_sigmaAction.createWidget(this));
     layout->addWidget(densityPlotAction->_continuousUpdatesAction.createWidget(this));
+    layout->addWidget(densityPlotAction->_cpuComputationAction.createWidget(this));
+    layout->addWidget(densityPlotAction->_weightedAction.createWidget(this));
+    layout->addWidget(densityPlotAction->_weightDatasetPickerAction.createWidget(this));
+    layout->addWidget(densityPlotAction->_weightDimensionAction.createWidget(this));
+    layout->addWidget(densityPlotAction->_densitySourceAction.createLabelWidget(this));
+    layout->addWidget(densityPlotAction->_densitySourceAction.createWidget(this));
+    layout->addWidget(densityPlotAction->_contourLevelsAction.createLabelWidget(this));
+    layout->addWidget(densityPlotAction->_contourLevelsAction.createWidget(this));
 
     setLayout(layout);
 }
\ No newline at end of file
@@ -2,6 +2,10 @@
 
 #include "PluginAction.h"
 
+#include "actions/DatasetPickerAction.h"
+#include <PointData/PointData.h>
+#include <PointData/DimensionPickerAction.h>
+
 #include <QLabel>
 
 using namespace hdps::gui;
@@ -25,6 +29,17 @@ public:
 
     QMenu* getContextMenu();
 
+protected:
+
+    /** Extract the weights of the current weight dimension and pass them to the scatter plot widget (or clear them) */
+    void updateDensityWeights();
+
+    /** Check (and lock) the CPU computation action when the density settings are only supported by the CPU backend */
+    void updateCpuComputationAction();
+
+    /** Get whether the current weight dataset is a points dataset with one point per position */
+    bool isWeightDatasetValid() const;
+
 public: // Serialization
 
     /**
@@ -40,8 +55,15 @@ public: // Serialization
     QVariantMap toVariantMap() const override;
 
 protected:
-    DecimalAction       _sigmaAction;
-    ToggleAction        _continuousUpdatesAction;
+    DecimalAction           _sigmaAction;                   /** Kernel width action */
+    ToggleAction            _continuousUpdatesAction;       /** Update the density while dragging the sigma slider */
+    ToggleAction            _cpuComputationAction;          /** Compute the density on the CPU */
+    ToggleAction            _weightedAction;                /** Weigh the points by a dimension */
+    DatasetPickerAction     _weightDatasetPickerAction;     /** Dataset which contains the weight dimension */
+    DimensionPickerAction   _weightDimensionAction;         /** Weight dimension */
+    Dataset<Points>         _weightDataset;                 /** Current weight dataset (to track data changes) */
+    OptionAction            _densitySourceAction;           /** Which points contribute to the density */
+    IntegralAction          _contourLevelsAction;           /** Number of iso-contour levels */
 
     static constexpr double DEFAULT_SIGMA = 0.15f;
     static constexpr bool DEFAULT_CONTINUOUS_UPDATES = true;
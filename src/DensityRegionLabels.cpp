@@ -0,0 +1,108 @@
+#include "DensityRegionLabels.h"
+
+#include <algorithm>
+
+DensityRegionLabels::DensityRegionLabels(const std::size_t& capacity /*= DEFAULT_CAPACITY*/) :
+    _capacity(std::max<std::size_t>(1, capacity)),
+    _grid(),
+    _labels()
+{
+}
+
+std::shared_ptr<const std::vector<std::int32_t>> DensityRegionLabels::getLabels(const std::shared_ptr<const DensityGrid>& grid, const float& level)
+{
+    // Labelings of another grid are no longer valid
+    if (grid != _grid) {
+        _grid = grid;
+        _labels.clear();
+    }
+
+    if (!_grid)
+        return std::make_shared<const std::vector<std::int32_t>>();
+
+    const auto it = std::find_if(_labels.begin(), _labels.end(), [&level](const auto& entry) -> bool {
+        return entry.first == level;
+    });
+
+    // Mark as most recently used
+    if (it != _labels.end()) {
+        _labels.splice(_labels.begin(), _labels, it);
+
+        return _labels.front().second;
+    }
+
+    auto labels = std::make_shared<std::vector<std::int32_t>>();
+
+    label(*_grid, level, *labels);
+
+    _labels.emplace_front(level, labels);
+
+    // Evict the least recently used labelings
+    while (_labels.size() > _capacity)
+        _labels.pop_back();
+
+    return labels;
+}
+
+void DensityRegionLabels::clear()
+{
+    _grid.reset();
+    _labels.clear();
+}
+
+std::int32_t DensityRegionLabels::label(const DensityGrid& grid, const float& level, std::vector<std::int32_t>& labels)
+{
+    const auto resolution = grid.getResolution();
+    const auto& values    = grid.getValues();
+
+    labels.assign(values.size(), NO_REGION);
+
+    std::int32_t numberOfRegions = 0;
+
+    // Cells which still need to be visited by the flood fill of the current region
+    std::vector<std::size_t> stack;
+
+    for (std::size_t seedIndex = 0; seedIndex < values.size(); seedIndex++) {
+        if (values[seedIndex] < level || labels[seedIndex] != NO_REGION)
+            continue;
+
+        // Flood fill the region which contains the seed cell
+        labels[seedIndex] = numberOfRegions;
+
+        stack.push_back(seedIndex);
+
+        while (!stack.empty()) {
+            const auto cellIndex = stack.back();
+
+            stack.pop_back();
+
+            const auto x = cellIndex % resolution;
+            const auto y = cellIndex / resolution;
+
+            const auto visit = [&](const std::size_t& neighborIndex) -> void {
+                if (values[neighborIndex] < level || labels[neighborIndex] != NO_REGION)
+                    return;
+
+                labels[neighborIndex] = numberOfRegions;
+
+                stack.push_back(neighborIndex);
+            };
+
+            if (x > 0)
+                visit(cellIndex - 1);
+
+            if (x + 1 < resolution)
+                visit(cellIndex + 1);
+
+            if (y > 0)
+                visit(cellIndex - resolution);
+
+            if (y + 1 < resolution)
+                visit(cellIndex + resolution);
+        }
+
+        numberOfRegions++;
+    }
+
+    return numberOfRegions;
+}
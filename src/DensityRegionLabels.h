@@ -0,0 +1,59 @@
+#pragma once
+
+#include "DensityGrid.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <vector>
+
+/**
+ * Density region labels class
+ *
+ * Labels the connected regions of a density grid above a density level (four-connected cells
+ * with a value at or above the level). Labelings are cached per level for the current density
+ * grid, so that repeated selections at the same level only classify the points.
+ */
+class DensityRegionLabels
+{
+public:
+
+    /** Label of cells below the level */
+    static constexpr std::int32_t NO_REGION = -1;
+
+public:
+
+    /**
+     * Constructor
+     * @param capacity Maximum number of cached labelings
+     */
+    DensityRegionLabels(const std::size_t& capacity = DEFAULT_CAPACITY);
+
+    /**
+     * Get the region labels of \p grid at \p level (labels are computed at most once per grid and level)
+     * @param grid Density grid
+     * @param level Density level
+     * @return Region label per cell (row major), NO_REGION for cells below the level
+     */
+    std::shared_ptr<const std::vector<std::int32_t>> getLabels(const std::shared_ptr<const DensityGrid>& grid, const float& level);
+
+    /** Remove all cached labelings */
+    void clear();
+
+    /**
+     * Label the connected regions of \p grid at or above \p level
+     * @param grid Density grid
+     * @param level Density level
+     * @param labels Region label per cell (row major), NO_REGION for cells below the level
+     * @return Number of regions
+     */
+    static std::int32_t label(const DensityGrid& grid, const float& level, std::vector<std::int32_t>& labels);
+
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 8;     /** Default maximum number of cached labelings */
+
+private:
+    std::size_t                                                                     _capacity;  /** Maximum number of cached labelings */
+    std::shared_ptr<const DensityGrid>                                              _grid;      /** Density grid of the cached labelings */
+    std::list<std::pair<float, std::shared_ptr<const std::vector<std::int32_t>>>>   _labels;    /** Cached labelings per level (most recently used first) */
+};
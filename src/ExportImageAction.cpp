@@ -1,9 +1,22 @@
 #include "ExportImageAction.h"
 #include "ViewerScatterplotPlugin.h"
 #include "ViewerScatterplotWidget.h"
+#include "PlotImageExporter.h"
+#include "StreamingPngWriter.h"
 
 #include <Application.h>
 
+#include <QCryptographicHash>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <deque>
+
 const QMap<ExportImageAction::Scale, TriggersAction::Trigger> ExportImageAction::triggers = QMap<ExportImageAction::Scale, TriggersAction::Trigger>({
     { ExportImageAction::Eighth, TriggersAction::Trigger("12.5%", "Scale by 1/8th") },
     { ExportImageAction::Quarter, TriggersAction::Trigger("25%", "Scale by a quarter") },
@@ -30,18 +43,30 @@ ExportImageAction::ExportImageAction(QObject* parent, ViewerScatterplotPlugin& v
     GroupAction(parent),
     _viewerscatterplotPlugin(viewerscatterplotPlugin),
     _dimensionSelectionAction(this),
-    _targetWidthAction(this, "Width ", 1, 10000),
-    _targetHeightAction(this, "Height", 1, 10000),
+    _targetWidthAction(this, "Width ", 1, MAXIMUM_SIZE),
+    _targetHeightAction(this, "Height", 1, MAXIMUM_SIZE),
     _lockAspectRatioAction(this, "Lock aspect ratio", true, true),
     _scaleAction(this, "Scale", triggers.values().toVector()),
     _backgroundColorAction(this, "Background color", QColor(Qt::white), QColor(Qt::white)),
+    _offscreenAction(this, "Offscreen", false, false),
+    _formatAction(this, "Format", { "PNG", "SVG", "PDF" }),
+    _vectorPointsAction(this, "Vector points", 0, 10000000, 100000, 100000),
+    _saveImagesAction(this, "Images", true, true),
+    _saveAnimationAction(this, "Animation", false, false),
+    _frameDelayAction(this, "Frame delay", 10, 10000, 500, 500),
+    _reuseImagesAction(this, "Reuse images", false, false),
+    _resumeAction(this, "Resume", false, false),
     _overrideRangesAction(this, "Override ranges", false, false),
     _fixedRangeAction(this, "Fixed range"),
     _fileNamePrefixAction(this, "Filename prefix", viewerscatterplotPlugin.getPositionDataset()->getGuiName() + "_", viewerscatterplotPlugin.getPositionDataset()->getGuiName() + "_"),
     _statusAction(this, "Status"),
     _outputDirectoryAction(this, "Output"),
     _exportCancelAction(this, "", { TriggersAction::Trigger("Export", "Export dimensions"), TriggersAction::Trigger("Cancel", "Cancel export")  }),
-    _aspectRatio()
+    _aspectRatio(),
+    _encodingThreadPool(),
+    _animationThreadPool(),
+    _exporting(false),
+    _exportCanceled(false)
 {
     setText("Export");
     setLabelWidthFixed(100);
@@ -52,6 +77,14 @@ ExportImageAction::ExportImageAction(QObject* parent, ViewerScatterplotPlugin& v
     _lockAspectRatioAction.setConnectionPermissionsToNone();
     _scaleAction.setConnectionPermissionsToNone();
     _backgroundColorAction.setConnectionPermissionsToNone();
+    _offscreenAction.setConnectionPermissionsToNone();
+    _formatAction.setConnectionPermissionsToNone();
+    _vectorPointsAction.setConnectionPermissionsToNone();
+    _saveImagesAction.setConnectionPermissionsToNone();
+    _saveAnimationAction.setConnectionPermissionsToNone();
+    _frameDelayAction.setConnectionPermissionsToNone();
+    _reuseImagesAction.setConnectionPermissionsToNone();
+    _resumeAction.setConnectionPermissionsToNone();
     _overrideRangesAction.setConnectionPermissionsToNone();
     _fixedRangeAction.setConnectionPermissionsToNone();
     _fileNamePrefixAction.setConnectionPermissionsToNone();
@@ -63,12 +96,28 @@ ExportImageAction::ExportImageAction(QObject* parent, ViewerScatterplotPlugin& v
     _lockAspectRatioAction.setEnabled(false);
     _scaleAction.setEnabled(false);
 
+    // Encode images on (at most) all but one core, the GUI thread renders the next image
+    _encodingThreadPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+
+    // Animation frames are appended in order, so they are encoded by a single thread
+    _animationThreadPool.setMaxThreadCount(1);
+
     _outputDirectoryAction.setSettingsPrefix(&_viewerscatterplotPlugin, "Screenshot/OutputDirectory");
 
     _dimensionSelectionAction.setObjectName("Dimensions/" + viewerscatterplotPlugin.getPositionDataset()->getGuiName());
 
     _targetWidthAction.setSuffix("px");
     _targetHeightAction.setSuffix("px");
+    _frameDelayAction.setSuffix("ms");
+
+    _offscreenAction.setToolTip("Render the images on the CPU, without OpenGL or a visible plot (e.g. on a render server), otherwise images are rendered with OpenGL (images larger than " + QString::number(PlotImageExporter::MAXIMUM_SCREENSHOT_SIZE) + " pixels in tiles)");
+    _formatAction.setToolTip("Image file format (SVG and PDF are vector formats)");
+    _vectorPointsAction.setToolTip("Maximum number of points which are exported as vector shapes, more points are exported as an embedded image (with vector selection outlines)");
+    _saveImagesAction.setToolTip("Save an image per dimension");
+    _saveAnimationAction.setToolTip("Save an animated PNG with a frame per dimension");
+    _frameDelayAction.setToolTip("Time each frame of the animation is shown");
+    _resumeAction.setToolTip("Skip images whose inputs (data, color map range, settings and size) did not change since they were exported, according to the manifest");
+    _reuseImagesAction.setToolTip("Make animation frames from previously exported images whose inputs did not change, according to the manifest (instead of rendering them)");
 
     // Update dimensions picker when the position dataset changes
     connect(&viewerscatterplotPlugin.getPositionDataset(), &Dataset<Points>::changed, this, &ExportImageAction::updateDimensionsPickerAction);
@@ -115,6 +164,7 @@ ExportImageAction::ExportImageAction(QObject* parent, ViewerScatterplotPlugin& v
                 break;
 
             case 1:
+                cancelExport();
                 break;
 
             default:
@@ -123,6 +173,26 @@ ExportImageAction::ExportImageAction(QObject* parent, ViewerScatterplotPlugin& v
         
     });
 
+    // Update the vector and animation actions read-only (animations are PNG only)
+    const auto updateAnimationReadOnly = [this]() {
+        _vectorPointsAction.setEnabled(isVectorFormat());
+        _saveAnimationAction.setEnabled(!isVectorFormat());
+        _frameDelayAction.setEnabled(!isVectorFormat() && _saveAnimationAction.isChecked());
+        _reuseImagesAction.setEnabled(!isVectorFormat() && _saveAnimationAction.isChecked());
+    };
+
+    // Update the vector and animation actions read-only when the format changes or the animation is toggled
+    connect(&_formatAction, &OptionAction::currentIndexChanged, this, updateAnimationReadOnly);
+    connect(&_saveAnimationAction, &ToggleAction::toggled, this, updateAnimationReadOnly);
+
+    // Update resume read-only (only saved images are recorded in the manifest)
+    const auto updateResumeReadOnly = [this]() {
+        _resumeAction.setEnabled(_saveImagesAction.isChecked());
+    };
+
+    // Update resume read-only when the images are toggled
+    connect(&_saveImagesAction, &ToggleAction::toggled, this, updateResumeReadOnly);
+
     // Update fixed range read-only
     const auto updateFixedRangeReadOnly = [this]() {
         _fixedRangeAction.setEnabled(_overrideRangesAction.isChecked());
@@ -135,10 +205,17 @@ ExportImageAction::ExportImageAction(QObject* parent, ViewerScatterplotPlugin& v
     connect(&_fileNamePrefixAction, &StringAction::stringChanged, this, &ExportImageAction::updateExportTrigger);
     connect(&_outputDirectoryAction, &DirectoryPickerAction::directoryChanged, this, &ExportImageAction::updateExportTrigger);
 
+    // Updates the export trigger when the images or animation are toggled
+    connect(&_saveImagesAction, &ToggleAction::toggled, this, &ExportImageAction::updateExportTrigger);
+    connect(&_saveAnimationAction, &ToggleAction::toggled, this, &ExportImageAction::updateExportTrigger);
+    connect(&_formatAction, &OptionAction::currentIndexChanged, this, &ExportImageAction::updateExportTrigger);
+
     // Perform initialization of actions
     updateAspectRatio();
     updateTargetHeightAction();
+    updateAnimationReadOnly();
     updateFixedRangeReadOnly();
+    updateResumeReadOnly();
 
     initializeTargetSize();
     updateDimensionsPickerAction();
@@ -151,99 +228,509 @@ void ExportImageAction::initializeTargetSize()
     // Get size of the viewerscatterplot widget
     const auto scatterPlotWidgetSize = _viewerscatterplotPlugin.getViewerScatterplotWidget().size();
 
-    _targetWidthAction.initialize(1, 8 * scatterPlotWidgetSize.width(), scatterPlotWidgetSize.width(), scatterPlotWidgetSize.width());
-    _targetHeightAction.initialize(1, 8 * scatterPlotWidgetSize.height(), scatterPlotWidgetSize.height(), scatterPlotWidgetSize.height());
+    // Allow poster size exports (large exports are rendered in tiles)
+    _targetWidthAction.initialize(1, MAXIMUM_SIZE, scatterPlotWidgetSize.width(), scatterPlotWidgetSize.width());
+    _targetHeightAction.initialize(1, MAXIMUM_SIZE, scatterPlotWidgetSize.height(), scatterPlotWidgetSize.height());
 
     _aspectRatio = static_cast<float>(_targetHeightAction.getValue()) / static_cast<float>(_targetWidthAction.getValue());
 }
 
 void ExportImageAction::exportImages()
 {
-    // Get reference to the coloring action
-    auto& coloringAction = _viewerscatterplotPlugin.getSettingsAction().getColoringAction();
+    // Only proceed if the directory exists
+    if (!QDir(_outputDirectoryAction.getDirectory()).exists()) {
+        _statusAction.setStatus(StatusAction::Error);
+        _statusAction.setMessage(_outputDirectoryAction.getDirectory() + " does not exist, aborting", true);
+        return;
+    }
+
+    // Get screenshot dimensions and background color
+    const auto width            = _targetWidthAction.getValue();
+    const auto height           = _targetHeightAction.getValue();
+    const auto backgroundColor  = _backgroundColorAction.getColor();
+    const auto offscreen        = _offscreenAction.isChecked();
+    const auto vectorFormat     = isVectorFormat();
+    const auto saveImages       = _saveImagesAction.isChecked();
+    const auto saveAnimation    = _saveAnimationAction.isChecked() && !vectorFormat;
+    const auto reuseImages      = saveAnimation && _reuseImagesAction.isChecked();
+    const auto resume           = saveImages && _resumeAction.isChecked();
+
+    // Large images are rendered in bands and streamed to disk by the image exporter (on this thread)
+    const auto tiledExport = std::max(width, height) > PlotImageExporter::MAXIMUM_SCREENSHOT_SIZE;
+
+    // Images are only rendered on the CPU when offscreen rendering is chosen
+    if (!offscreen && !vectorFormat && !_viewerscatterplotPlugin.getViewerScatterplotWidget().isInitialized()) {
+        _statusAction.setStatus(StatusAction::Error);
+        _statusAction.setMessage("OpenGL is not available, turn on offscreen to render the images on the CPU, aborting", true);
+        return;
+    }
+
+    // Animation frames are kept in memory until they are encoded
+    if (saveAnimation && tiledExport) {
+        _statusAction.setStatus(StatusAction::Error);
+        _statusAction.setMessage("Animations are limited to " + QString::number(PlotImageExporter::MAXIMUM_SCREENSHOT_SIZE) + " pixels, aborting", true);
+        return;
+    }
+
+    // Get enabled dimensions from dimension picker action
+    const auto enabledDimensions = _dimensionSelectionAction.getEnabledDimensions();
+
+    // Indices of the dimensions which are flagged for export
+    std::vector<std::int32_t> exportDimensionIndices;
+
+    for (std::int32_t enabledDimensionIndex = 0; enabledDimensionIndex < static_cast<std::int32_t>(enabledDimensions.size()); enabledDimensionIndex++)
+        if (enabledDimensions[enabledDimensionIndex])
+            exportDimensionIndices.push_back(enabledDimensionIndex);
+
+    // The animation is written frame by frame while the dimensions are exported
+    const auto animationFileName = _fileNamePrefixAction.getString() + "animation.png";
+
+    StreamingPngWriter animationWriter;
+
+    if (saveAnimation && !animationWriter.open(_outputDirectoryAction.getDirectory() + "/" + animationFileName, width, height, static_cast<std::uint32_t>(exportDimensionIndices.size()), static_cast<std::uint16_t>(_frameDelayAction.getValue()))) {
+        _statusAction.setStatus(StatusAction::Error);
+        _statusAction.setMessage("Unable to create " + animationFileName + ", aborting", true);
+        return;
+    }
+
+    // Get reference to the coloring action, the viewerscatterplot widget and its image exporter
+    auto& coloringAction            = _viewerscatterplotPlugin.getSettingsAction().getColoringAction();
+    auto& viewerscatterplotWidget   = _viewerscatterplotPlugin.getViewerScatterplotWidget();
+    auto& imageExporter             = viewerscatterplotWidget.getImageExporter();
 
     // Cache the coloring type and dimension index
     const auto colorByIndex     = coloringAction.getColorByAction().getCurrentIndex();
     const auto dimensionIndex   = coloringAction.getDimensionAction().getCurrentDimensionIndex();
 
-    // Set the coloring type to dimension
-    coloringAction.getColorByAction().setCurrentIndex(1);
+    // Get smart pointer to the position dataset (the exported dimensions are its dimensions)
+    const auto positionDataset  = _viewerscatterplotPlugin.getPositionDataset();
+    const auto dimensionNames   = positionDataset->getDimensionNames();
+
+    // The images might be rendered with the CPU backends, which need copies of the point colors/scalars
+    viewerscatterplotWidget.setRetainPointData(true);
+
+    // Color by the position dataset and apply the coloring (color map, coloring mode) before the first image is rendered
+    coloringAction.setCurrentColorDataset(positionDataset);
+
+    _viewerscatterplotPlugin.getUpdateScheduler().flush();
+
+    // Export parameters (recorded in the manifest)
+    const QJsonObject parameters{
+        { "width", width },
+        { "height", height },
+        { "format", _formatAction.getCurrentText() },
+        { "backgroundColor", backgroundColor.name(QColor::HexArgb) },
+        { "offscreen", offscreen },
+        { "vectorPoints", _vectorPointsAction.getValue() }
+    };
+
+    // Hash of the inputs which all images share: the export parameters, the plot settings (the coloring is covered by the color map and the columns) and the plot data
+    auto plotSettings = _viewerscatterplotPlugin.getSettingsAction().toVariantMap();
+
+    plotSettings.remove(coloringAction.getSerializationName());
+
+    QCryptographicHash sharedInputsHash(QCryptographicHash::Sha1);
+
+    sharedInputsHash.addData(QJsonDocument(parameters).toJson(QJsonDocument::Compact));
+    sharedInputsHash.addData(QJsonDocument(QJsonObject::fromVariantMap(plotSettings)).toJson(QJsonDocument::Compact));
+    sharedInputsHash.addData(viewerscatterplotWidget.getImageDataHash());
+
+    const auto sharedInputs = sharedInputsHash.result();
+
+    // Images of earlier exports (their entries are kept, so that exports of other dimensions can be resumed as well)
+    QJsonObject manifestImages;
+
+    QFile previousManifestFile(getManifestFilePath());
+
+    if (previousManifestFile.open(QIODevice::ReadOnly))
+        manifestImages = QJsonDocument::fromJson(previousManifestFile.readAll()).object().value("images").toObject();
+
+    previousManifestFile.close();
+
+    // Write the manifest next to the images (atomically, so that an interrupted export leaves a valid manifest)
+    const auto writeManifest = [this, &positionDataset, &parameters, &manifestImages]() -> bool {
+        QSaveFile manifestFile(getManifestFilePath());
+
+        if (!manifestFile.open(QIODevice::WriteOnly))
+            return false;
+
+        const QJsonObject manifest{
+            { "dataset", positionDataset->getGuiName() },
+            { "parameters", parameters },
+            { "images", manifestImages }
+        };
+
+        manifestFile.write(QJsonDocument(manifest).toJson());
+
+        return manifestFile.commit();
+    };
+
+    // Column of a dimension with its hash and color map range
+    struct Column {
+        std::vector<float>  _scalars;       /** Scalars of the points */
+        QByteArray          _hash;          /** SHA-1 hash of the scalars */
+        float               _minimum;       /** Minimum scalar */
+        float               _maximum;       /** Maximum scalar */
+    };
+
+    // The tasks use the points directly, the dataset reference is a QObject (the export waits for the last task, so the points outlive them)
+    auto points = positionDataset.get();
+
+    // Extract (and hash) the column of a dimension in the background
+    const auto extractDimension = [points](std::int32_t dimensionIndex) -> QFuture<Column> {
+        return QtConcurrent::run([points, dimensionIndex]() -> Column {
+            Column column{ {}, {}, 0.0f, 0.0f };
+
+            points->extractDataForDimension(column._scalars, dimensionIndex);
+
+            column._hash = QCryptographicHash::hash(QByteArray::fromRawData(reinterpret_cast<const char*>(column._scalars.data()), static_cast<qsizetype>(column._scalars.size() * sizeof(float))), QCryptographicHash::Sha1);
+
+            if (!column._scalars.empty()) {
+                const auto [minimum, maximum] = std::minmax_element(column._scalars.begin(), column._scalars.end());
+
+                column._minimum = *minimum;
+                column._maximum = *maximum;
+            }
+
+            return column;
+        });
+    };
+
+    // Image which is being encoded (saved to its own file or appended to the animation)
+    struct PendingEncoding {
+        QString         _fileName;      /** File name of the image */
+        QFuture<bool>   _encoded;       /** Whether the image was saved or appended */
+        bool            _frame;         /** Whether the image is appended to the animation */
+        QJsonObject     _manifestEntry; /** Manifest entry of the image (without the image hash) */
+    };
+
+    std::deque<PendingEncoding> pendingEncodings;
 
     auto numberOfExportedImages = 0;
+    auto numberOfSkippedImages  = 0;
+
+    QString errorMessage;
+
+    // Record an exported image in the manifest (which is written regularly, so that an interrupted export can be resumed)
+    const auto recordImage = [this, &manifestImages, &numberOfExportedImages, &writeManifest](const QString& fileName, QJsonObject manifestEntry) -> void {
+        manifestEntry["imageHash"] = getFileHash(_outputDirectoryAction.getDirectory() + "/" + fileName);
+
+        manifestImages[fileName] = manifestEntry;
+
+        numberOfExportedImages++;
+
+        if (numberOfExportedImages % MANIFEST_WRITE_INTERVAL == 0)
+            writeManifest();
+    };
+
+    // Wait for the oldest image which is being encoded and account for it
+    const auto finishEncoding = [this, &pendingEncodings, &recordImage, &errorMessage]() -> void {
+        const auto pendingEncoding = pendingEncodings.front();
+
+        pendingEncodings.pop_front();
+
+        if (pendingEncoding._encoded.result()) {
+            if (!pendingEncoding._frame)
+                recordImage(pendingEncoding._fileName, pendingEncoding._manifestEntry);
+
+            return;
+        }
+
+        // Images are not encoded when the export is canceled, otherwise encoding failed
+        if (!_exportCanceled) {
+            errorMessage    = "Unable to " + QString(pendingEncoding._frame ? "animate " : "export ") + pendingEncoding._fileName + ", aborting";
+            _exportCanceled = true;
+        }
+    };
+
+    // Bound the number of images which wait for encoding (and thus the memory use)
+    const auto limitPendingEncodings = [this, &pendingEncodings, &finishEncoding]() -> void {
+        while (pendingEncodings.size() >= MAXIMUM_PENDING_ENCODINGS_FACTOR * static_cast<std::size_t>(_encodingThreadPool.maxThreadCount() + 1))
+            finishEncoding();
+    };
+
+    // Append an image to the animation (in order, while the next image is rendered)
+    const auto appendFrame = [this, &animationWriter](const QImage& image, const QString& imageFilePath) -> QFuture<bool> {
+        return QtConcurrent::run(&_animationThreadPool, [this, &animationWriter, image, imageFilePath]() -> bool {
+
+            // Skip frames which are not appended yet when the export is canceled
+            if (_exportCanceled)
+                return false;
+
+            // Load reused images here, so that they are decoded in the background
+            return animationWriter.writeRows(image.isNull() ? QImage(imageFilePath) : image);
+        });
+    };
+
+    // Image which was requested from the widget but not taken yet (its readback overlaps with rendering the next image)
+    struct RequestedImage {
+        QString         _fileName;      /** File name of the image */
+        QString         _filePath;      /** File path of the image */
+        QJsonObject     _manifestEntry; /** Manifest entry of the image (without the image hash) */
+    };
+
+    std::deque<RequestedImage> requestedImages;
+
+    // Take the oldest requested image and encode it (the image is discarded when the export was canceled or failed)
+    const auto encodeRequestedImage = [this, &imageExporter, &requestedImages, &pendingEncodings, &errorMessage, &limitPendingEncodings, &appendFrame, saveImages, saveAnimation]() -> void {
+        const auto requestedImage = requestedImages.front();
+
+        requestedImages.pop_front();
+
+        const auto image = imageExporter.takeRequestedImage();
+
+        if (_exportCanceled || !errorMessage.isEmpty())
+            return;
+
+        if (image.isNull()) {
+            errorMessage    = "Unable to render " + requestedImage._fileName + ", aborting";
+            _exportCanceled = true;
+            return;
+        }
+
+        limitPendingEncodings();
+
+        if (_exportCanceled)
+            return;
+
+        // Encode and save the image while the next image is rendered
+        if (saveImages) {
+            const auto imageFilePath = requestedImage._filePath;
+
+            pendingEncodings.push_back({ requestedImage._fileName, QtConcurrent::run(&_encodingThreadPool, [this, image, imageFilePath]() -> bool {
+
+                // Skip images which are not saved yet when the export is canceled
+                if (_exportCanceled)
+                    return false;
+
+                return image.save(imageFilePath);
+            }), false, requestedImage._manifestEntry });
+        }
+
+        // The rendered image is also the animation frame
+        if (saveAnimation)
+            pendingEncodings.push_back({ requestedImage._fileName, appendFrame(image, requestedImage._filePath), true, {} });
+    };
 
     // Update status message
+    _statusAction.setStatus(StatusAction::Info);
     _statusAction.setMessage("Exporting...");
 
+    _exporting      = true;
+    _exportCanceled = false;
+
     QApplication::setOverrideCursor(Qt::WaitCursor);
     {
         // Temporarily disable the export trigger
         _exportCancelAction.setTriggerEnabled(0, false);
 
-        // Get enabled dimensions from dimension picker action
-        const auto enabledDimensions = _dimensionSelectionAction.getEnabledDimensions();
+        // Start extracting the column of the first dimension
+        QFuture<Column> nextColumn;
 
-        // Get screenshot dimensions and background color
-        const auto width            = _targetWidthAction.getValue();
-        const auto height           = _targetHeightAction.getValue();
-        const auto backgroundColor  = _backgroundColorAction.getColor();
-        const auto dimensionNames   = _viewerscatterplotPlugin.getPositionDataset()->getDimensionNames();
+        if (!exportDimensionIndices.empty())
+            nextColumn = extractDimension(exportDimensionIndices.front());
 
-        _statusAction.setStatus(StatusAction::Info);
+        for (std::size_t exportIndex = 0; exportIndex < exportDimensionIndices.size(); exportIndex++) {
 
-        for (std::int32_t dimensionIndex = 0; dimensionIndex < enabledDimensions.size(); dimensionIndex++) {
-
-            // Continue if the dimension is not enabled (not flagged for export)
-            if (!enabledDimensions[dimensionIndex])
-                continue;
+            // Get index of the exported dimension
+            const auto exportDimensionIndex = exportDimensionIndices[exportIndex];
 
             // Establish file name
-            const auto fileName = _fileNamePrefixAction.getString() + dimensionNames[dimensionIndex] + ".png";
+            const auto fileName = _fileNamePrefixAction.getString() + dimensionNames[exportDimensionIndex] + "." + _formatAction.getCurrentText().toLower();
 
             // Update status
-            _statusAction.setMessage("Export " + fileName + " (" + QString::number(numberOfExportedImages + 1) + "/" + QString::number(getNumberOfSelectedDimensions()) + ")");
+            _statusAction.setMessage("Export " + fileName + " (" + QString::number(exportIndex + 1) + "/" + QString::number(exportDimensionIndices.size()) + ")");
 
-            // Ensure status is updated properly
+            // Ensure status is updated properly and the cancel trigger is handled
             QCoreApplication::processEvents();
 
+            if (_exportCanceled)
+                break;
+
+            // Wait for the column of this dimension and extract the column of the next dimension while this one is rendered
+            const auto column = nextColumn.result();
+
+            if (exportIndex + 1 < exportDimensionIndices.size())
+                nextColumn = extractDimension(exportDimensionIndices[exportIndex + 1]);
+
             // Establish file path of the output image
             const auto imageFilePath = _outputDirectoryAction.getDirectory() + "/" + fileName;
 
-            // Only proceed if the directory exists
-            if (!QDir(_outputDirectoryAction.getDirectory()).exists()) {
-                _statusAction.setStatus(StatusAction::Error);
-                _statusAction.setMessage(_outputDirectoryAction.getDirectory() + "does not exist, aborting", true);
-                break;
+            // Use the color map range of the column, unless it is overridden
+            const auto colorMapRangeMinimum = _overrideRangesAction.isChecked() ? _fixedRangeAction.getMinimum() : column._minimum;
+            const auto colorMapRangeMaximum = _overrideRangesAction.isChecked() ? _fixedRangeAction.getMaximum() : column._maximum;
+
+            // Inputs of the image: the shared inputs, the column and its color map range
+            QCryptographicHash inputsHash(QCryptographicHash::Sha1);
+
+            inputsHash.addData(sharedInputs);
+            inputsHash.addData(column._hash);
+            inputsHash.addData(QByteArray::number(colorMapRangeMinimum) + "," + QByteArray::number(colorMapRangeMaximum));
+
+            const QJsonObject manifestEntry{
+                { "dimension", dimensionNames[exportDimensionIndex] },
+                { "dimensionHash", QString(column._hash.toHex()) },
+                { "colorMapRange", QJsonArray{ colorMapRangeMinimum, colorMapRangeMaximum } },
+                { "inputsHash", QString(inputsHash.result().toHex()) }
+            };
+
+            // Images are unchanged when their inputs did not change since they were exported (and the files were not modified since)
+            if (resume || reuseImages) {
+                const auto previousManifestEntry = manifestImages.value(fileName).toObject();
+
+                if (!previousManifestEntry.isEmpty() && previousManifestEntry.value("inputsHash") == manifestEntry.value("inputsHash") && previousManifestEntry.value("imageHash").toString() == getFileHash(imageFilePath)) {
+                    if (saveImages)
+                        numberOfSkippedImages++;
+
+                    // The unchanged image is the animation frame (after the frames of the requested images)
+                    if (saveAnimation) {
+                        while (!requestedImages.empty())
+                            encodeRequestedImage();
+
+                        limitPendingEncodings();
+
+                        pendingEncodings.push_back({ fileName, appendFrame(QImage(), imageFilePath), true, {} });
+                    }
+
+                    continue;
+                }
             }
 
-            // Cache reference to the viewerscatterplot widget
-            auto& viewerscatterplotWidget = _viewerscatterplotPlugin.getViewerScatterplotWidget();
+            // Color the points by the column (directly, the coloring actions are restored after the export)
+            viewerscatterplotWidget.setScalars(column._scalars);
+            viewerscatterplotWidget.setColorMapRange(colorMapRangeMinimum, colorMapRangeMaximum);
+
+            // Vector images are painted directly into the file
+            if (vectorFormat) {
+                if (!imageExporter.exportVectorImage(width, height, imageFilePath, backgroundColor, static_cast<std::uint32_t>(_vectorPointsAction.getValue()))) {
+                    errorMessage = "Unable to export " + fileName + ", aborting";
+                    break;
+                }
 
-            // Set the current dimension name
-            coloringAction.getDimensionAction().setCurrentDimensionName(dimensionNames[dimensionIndex]);
+                recordImage(fileName, manifestEntry);
+                continue;
+            }
+
+            if (tiledExport) {
+                if (!imageExporter.createScreenshot(width, height, imageFilePath, backgroundColor, offscreen)) {
+                    errorMessage = "Unable to export " + fileName + ", aborting";
+                    break;
+                }
 
-            if (_overrideRangesAction.isChecked()) {
-                auto& rangeAction = coloringAction.getColorMapAction().getRangeAction(ColorMapAction::Axis::X);
+                recordImage(fileName, manifestEntry);
+                continue;
+            }
 
-                rangeAction.initialize({ _fixedRangeAction.getMinimum(), _fixedRangeAction.getMaximum() }, { _fixedRangeAction.getMinimum(), _fixedRangeAction.getMaximum() });
+            // Render the image and start its readback
+            if (!imageExporter.requestImage(width, height, backgroundColor, offscreen)) {
+                errorMessage = "Unable to render " + fileName + ", aborting";
+                break;
             }
 
-            // Create and save the image
-            viewerscatterplotWidget.createScreenshot(width, height, imageFilePath, backgroundColor);
+            requestedImages.push_back({ fileName, imageFilePath, manifestEntry });
+
+            // Encode the image of the previous dimension, which was read back while this one was rendered
+            while (requestedImages.size() > 1)
+                encodeRequestedImage();
 
-            numberOfExportedImages++;
+            if (_exportCanceled || !errorMessage.isEmpty())
+                break;
         }
 
+        // Encode the last requested image (or discard the requested images when the export was canceled or failed)
+        while (!requestedImages.empty())
+            encodeRequestedImage();
+
+        // Finish the pending column extraction and encodings (the remaining encodings are skipped when the export was canceled)
+        nextColumn.waitForFinished();
+
+        while (!pendingEncodings.empty())
+            finishEncoding();
+
+        // Record the exported images (also when the export was canceled or failed, so that it can be resumed)
+        if (saveImages && !writeManifest() && errorMessage.isEmpty())
+            errorMessage = "Unable to write " + QFileInfo(getManifestFilePath()).fileName();
+
+        // Finish the animation (an incomplete animation is removed by the writer)
+        if (saveAnimation && !_exportCanceled && errorMessage.isEmpty() && !animationWriter.close())
+            errorMessage = "Unable to export " + animationFileName;
+
         // Turn the export trigger back on
         _exportCancelAction.setTriggerEnabled(0, true);
     }
     QApplication::restoreOverrideCursor();
 
+    _exporting = false;
+
     // Reset the coloring type and dimension index
     coloringAction.getColorByAction().setCurrentIndex(colorByIndex);
     coloringAction.getDimensionAction().setCurrentDimensionIndex(dimensionIndex);
 
+    viewerscatterplotWidget.setRetainPointData(false);
+
+    // The points were colored directly, so restore the colors and color map range of the coloring actions
+    _viewerscatterplotPlugin.getUpdateScheduler().markDirty(UpdateScheduler::Buffer::Colors);
+    _viewerscatterplotPlugin.getUpdateScheduler().flush();
+
+    const auto& rangeAction = coloringAction.getColorMapAction().getRangeAction(ColorMapAction::Axis::X);
+
+    viewerscatterplotWidget.setColorMapRange(rangeAction.getMinimum(), rangeAction.getMaximum());
+
+    // Establish what was exported
+    QStringList exported;
+
+    if (saveImages)
+        exported << QString::number(numberOfExportedImages) + " image" + (numberOfExportedImages == 1 ? "" : "s") + (numberOfSkippedImages > 0 ? " (" + QString::number(numberOfSkippedImages) + " unchanged)" : "");
+
+    if (saveAnimation && !_exportCanceled && errorMessage.isEmpty())
+        exported << "an animation of " + QString::number(animationWriter.getNumberOfWrittenFrames()) + " frames";
+
     // Update status message
-    _statusAction.setMessage("Exported " + QString::number(numberOfExportedImages) + " image" + (numberOfExportedImages > 1 ? "s" : ""), true);
+    if (!errorMessage.isEmpty()) {
+        _statusAction.setStatus(StatusAction::Error);
+        _statusAction.setMessage(errorMessage, true);
+    }
+    else if (_exportCanceled) {
+        _statusAction.setStatus(StatusAction::Warning);
+        _statusAction.setMessage("Export canceled" + (exported.isEmpty() ? QString() : ", exported " + exported.join(" and ")), true);
+    }
+    else {
+        _statusAction.setMessage("Exported " + exported.join(" and "), true);
+    }
+}
+
+void ExportImageAction::cancelExport()
+{
+    _exportCanceled = true;
+}
+
+bool ExportImageAction::isExporting() const
+{
+    return _exporting;
+}
+
+bool ExportImageAction::isVectorFormat() const
+{
+    return _formatAction.getCurrentIndex() > 0;
+}
+
+QString ExportImageAction::getManifestFilePath() const
+{
+    return _outputDirectoryAction.getDirectory() + "/" + _fileNamePrefixAction.getString() + "manifest.json";
+}
+
+QString ExportImageAction::getFileHash(const QString& filePath)
+{
+    QFile file(filePath);
+
+    if (!file.open(QIODevice::ReadOnly))
+        return QString();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    hash.addData(&file);
+
+    return hash.result().toHex();
 }
 
 void ExportImageAction::updateDimensionsPickerAction()
@@ -269,6 +756,9 @@ bool ExportImageAction::mayExport() const
     if (getNumberOfSelectedDimensions() == 0)
         return false;
 
+    if (!_saveImagesAction.isChecked() && (isVectorFormat() || !_saveAnimationAction.isChecked()))
+        return false;
+
     return true;
 }
 
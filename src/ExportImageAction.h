@@ -2,6 +2,7 @@
 
 #include <actions/GroupAction.h>
 #include <actions/IntegralAction.h>
+#include <actions/OptionAction.h>
 #include <actions/ToggleAction.h>
 #include <actions/TriggerAction.h>
 #include <actions/TriggersAction.h>
@@ -11,6 +12,10 @@
 
 #include <PointData/DimensionsPickerAction.h>
 
+#include <QThreadPool>
+
+#include <atomic>
+
 using namespace hdps::gui;
 
 class ViewerScatterplotPlugin;
@@ -53,9 +58,37 @@ public:
     /** Grab target size from scatter plot widget */
     void initializeTargetSize();
 
-    /** Export images to disk */
+    /**
+     * Export images to disk
+     *
+     * The export is pipelined: the column of the next dimension is extracted in the background while
+     * the current image is rendered, and rendered images are encoded and saved on a thread pool. The
+     * same rendered images are streamed as frames into an animated PNG.
+     */
     void exportImages();
 
+    /** Cancel a running export (images which are not being encoded yet are skipped) */
+    void cancelExport();
+
+    /** Get whether images are being exported */
+    bool isExporting() const;
+
+    /** Get whether the images are exported in a vector format (SVG or PDF) */
+    bool isVectorFormat() const;
+
+    /**
+     * Get the file path of the export manifest, which records the inputs and a content hash of each exported image
+     * @return Manifest file path (in the output directory)
+     */
+    QString getManifestFilePath() const;
+
+    /**
+     * Get the SHA-1 hash of the contents of a file
+     * @param filePath Path of the file
+     * @return Hexadecimal hash (empty when the file cannot be read)
+     */
+    static QString getFileHash(const QString& filePath);
+
 protected:
 
     /** Update the input points dataset of the dimensions picker action */
@@ -84,6 +117,14 @@ public: // Action getters
     ToggleAction& getLockAspectRatioAction() { return _lockAspectRatioAction; }
     TriggersAction& getScaleAction() { return _scaleAction; }
     ColorAction& getBackgroundColorAction() { return _backgroundColorAction; }
+    ToggleAction& getOffscreenAction() { return _offscreenAction; }
+    OptionAction& getFormatAction() { return _formatAction; }
+    IntegralAction& getVectorPointsAction() { return _vectorPointsAction; }
+    ToggleAction& getSaveImagesAction() { return _saveImagesAction; }
+    ToggleAction& getSaveAnimationAction() { return _saveAnimationAction; }
+    IntegralAction& getFrameDelayAction() { return _frameDelayAction; }
+    ToggleAction& getReuseImagesAction() { return _reuseImagesAction; }
+    ToggleAction& getResumeAction() { return _resumeAction; }
     ToggleAction& getOverrideRangesAction() { return _overrideRangesAction; }
     DecimalRangeAction& getFixedRangeAction() { return _fixedRangeAction; }
     DirectoryPickerAction& getDirectoryPickerAction() { return _outputDirectoryAction; }
@@ -97,6 +138,14 @@ protected:
     ToggleAction                _lockAspectRatioAction;         /** Lock aspect ratio action */
     TriggersAction              _scaleAction;                   /** Scale action */
     ColorAction                 _backgroundColorAction;         /** Background color action */
+    ToggleAction                _offscreenAction;               /** Render without OpenGL action */
+    OptionAction                _formatAction;                  /** Image file format action */
+    IntegralAction              _vectorPointsAction;            /** Maximum number of vector points action */
+    ToggleAction                _saveImagesAction;              /** Save an image per dimension action */
+    ToggleAction                _saveAnimationAction;           /** Save an animated PNG (a frame per dimension) action */
+    IntegralAction              _frameDelayAction;              /** Animation frame delay action */
+    ToggleAction                _reuseImagesAction;             /** Reuse exported images as animation frames action */
+    ToggleAction                _resumeAction;                  /** Skip unchanged images action */
     ToggleAction                _overrideRangesAction;          /** Override ranges action */
     DecimalRangeAction          _fixedRangeAction;              /** Fixed range action */
     DirectoryPickerAction       _outputDirectoryAction;         /** Output directory picker action */
@@ -104,4 +153,12 @@ protected:
     StatusAction                _statusAction;                  /** Status action */
     TriggersAction              _exportCancelAction;            /** Create and cancel triggers action */
     float                       _aspectRatio;                   /** Export image aspect ratio */
+    QThreadPool                 _encodingThreadPool;            /** Thread pool on which the exported images are encoded */
+    QThreadPool                 _animationThreadPool;           /** Thread pool on which the animation frames are encoded (in order) */
+    bool                        _exporting;                     /** Whether images are being exported */
+    std::atomic<bool>           _exportCanceled;                /** Whether the running export is canceled */
+
+    static constexpr std::int32_t   MAXIMUM_SIZE                        = 32768;    /** Largest export width/height (in pixels) */
+    static constexpr std::size_t    MAXIMUM_PENDING_ENCODINGS_FACTOR    = 2;        /** Maximum number of images waiting for encoding per encoding thread */
+    static constexpr std::int32_t   MANIFEST_WRITE_INTERVAL             = 32;       /** Number of exported images after which the manifest is written */
 };
\ No newline at end of file
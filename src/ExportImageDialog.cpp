@@ -28,9 +28,9 @@ ExportImageDialog::ExportImageDialog(QWidget* parent, ViewerScatterplotPlugin& v
 
     setLayout(layout);
 
-    // Reject when the cancel action is triggered
+    // Reject when the cancel action is triggered (while exporting, it only cancels the export)
     connect(&_exportImageAction.getExportCancelAction(), &TriggersAction::triggered, this, [this](std::int32_t triggerIndex) {
-        if (triggerIndex == 1)
+        if (triggerIndex == 1 && !_exportImageAction.isExporting())
             reject();
     });
 }
@@ -0,0 +1,141 @@
+#include "ImageReadback.h"
+
+#include <cstring>
+
+void ImageReadback::init()
+{
+    if (_isInitialized)
+        return;
+
+    initializeOpenGLFunctions();
+
+    for (auto& pixelBuffer : _pixelBuffers)
+        glGenBuffers(1, &pixelBuffer._buffer);
+
+    _isInitialized = true;
+}
+
+void ImageReadback::destroy()
+{
+    if (!_isInitialized)
+        return;
+
+    for (auto& pixelBuffer : _pixelBuffers) {
+        if (pixelBuffer._fence != nullptr)
+            glDeleteSync(pixelBuffer._fence);
+
+        glDeleteBuffers(1, &pixelBuffer._buffer);
+
+        pixelBuffer = PixelBuffer();
+    }
+
+    _pendingImages.clear();
+
+    _nextPixelBufferIndex   = 0;
+    _isInitialized          = false;
+}
+
+bool ImageReadback::read(std::int32_t width, std::int32_t height)
+{
+    if (!_isInitialized || !canRead() || width <= 0 || height <= 0)
+        return false;
+
+    auto& pixelBuffer = _pixelBuffers[_nextPixelBufferIndex];
+
+    const auto size = static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer._buffer);
+
+    // Only allocate when the image grows, consecutive images usually have the same size
+    if (size > pixelBuffer._capacity) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_READ);
+
+        pixelBuffer._capacity = size;
+    }
+
+    // Transfer the pixels into the pixel buffer (returns immediately), in the memory layout of QImage::Format_ARGB32
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, nullptr);
+
+    pixelBuffer._fence  = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pixelBuffer._width  = width;
+    pixelBuffer._height = height;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // Submit the transfer, so that it runs while the next image is rendered
+    glFlush();
+
+    pixelBuffer._pending = true;
+
+    _pendingImages.push_back({ QImage(), _nextPixelBufferIndex });
+
+    _nextPixelBufferIndex = (_nextPixelBufferIndex + 1) % NUMBER_OF_PIXEL_BUFFERS;
+
+    return true;
+}
+
+void ImageReadback::push(const QImage& image)
+{
+    _pendingImages.push_back({ image, -1 });
+}
+
+QImage ImageReadback::take()
+{
+    if (_pendingImages.empty())
+        return QImage();
+
+    const auto pendingImage = _pendingImages.front();
+
+    _pendingImages.pop_front();
+
+    if (pendingImage._pixelBufferIndex < 0)
+        return pendingImage._image;
+
+    auto& pixelBuffer = _pixelBuffers[pendingImage._pixelBufferIndex];
+
+    pixelBuffer._pending = false;
+
+    // Wait for the transfer (usually complete, it ran while the next image was rendered)
+    const auto waitResult = glClientWaitSync(pixelBuffer._fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+
+    glDeleteSync(pixelBuffer._fence);
+
+    pixelBuffer._fence = nullptr;
+
+    if (waitResult != GL_ALREADY_SIGNALED && waitResult != GL_CONDITION_SATISFIED)
+        return QImage();
+
+    const auto rowSize  = static_cast<std::size_t>(pixelBuffer._width) * 4;
+    const auto size     = rowSize * static_cast<std::size_t>(pixelBuffer._height);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer._buffer);
+
+    const auto pixels = static_cast<const std::uint8_t*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(size), GL_MAP_READ_BIT));
+
+    QImage image;
+
+    if (pixels != nullptr) {
+        image = QImage(pixelBuffer._width, pixelBuffer._height, QImage::Format_ARGB32);
+
+        // The only copy of the pixels, which also flips the bottom-up OpenGL rows
+        for (std::int32_t y = 0; y < pixelBuffer._height; y++)
+            std::memcpy(image.scanLine(y), pixels + static_cast<std::size_t>(pixelBuffer._height - 1 - y) * rowSize, rowSize);
+
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    return image;
+}
+
+std::size_t ImageReadback::getNumberOfPendingImages() const
+{
+    return _pendingImages.size();
+}
+
+bool ImageReadback::canRead() const
+{
+    return !_pixelBuffers[_nextPixelBufferIndex]._pending;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QOpenGLFunctions_3_3_Core>
+#include <QImage>
+
+#include <array>
+#include <cstdint>
+#include <deque>
+
+/**
+ * Image readback class
+ *
+ * Asynchronous readback of rendered images with double-buffered pixel buffer objects (PBOs). A read copies the bound
+ * framebuffer into the next free pixel buffer on the GPU and returns immediately, so that the next image can be rendered
+ * while the previous one is transferred. Taking an image waits for its transfer, maps its pixel buffer and copies the rows
+ * (bottom-up in OpenGL) once into a top-down QImage, which owns its pixels and can be encoded on another thread. Images
+ * which were rendered without OpenGL can be queued as well, so that all images are taken in the order they were requested.
+ */
+class ImageReadback : protected QOpenGLFunctions_3_3_Core
+{
+public:
+
+    /** Initialize the OpenGL functions and create the pixel buffers (requires a current OpenGL context) */
+    void init();
+
+    /** Discard the pending images and delete the pixel buffers (requires the OpenGL context of init) */
+    void destroy();
+
+    /**
+     * Start reading the bound framebuffer into a free pixel buffer (requires the OpenGL context of init)
+     * @param width Width of the framebuffer (in pixels)
+     * @param height Height of the framebuffer (in pixels)
+     * @return Whether the read was started (false when all pixel buffers are pending)
+     */
+    bool read(std::int32_t width, std::int32_t height);
+
+    /**
+     * Queue an image which was rendered without OpenGL
+     * @param image Rendered image
+     */
+    void push(const QImage& image);
+
+    /**
+     * Take the oldest pending image (waits until its transfer is complete, requires the OpenGL context of init for read images)
+     * @return Image (null when there is no pending image or the pixel buffer cannot be mapped)
+     */
+    QImage take();
+
+    /** Get the number of images which were read or queued but not taken yet */
+    std::size_t getNumberOfPendingImages() const;
+
+    /** Get whether a pixel buffer is free for a read */
+    bool canRead() const;
+
+protected:
+
+    /** Pixel buffer with the transfer of an image */
+    struct PixelBuffer {
+        GLuint          _buffer     = 0;            /** OpenGL pixel buffer object */
+        GLsync          _fence      = nullptr;      /** Signaled when the transfer into the pixel buffer is complete */
+        std::int32_t    _width      = 0;            /** Width of the image (in pixels) */
+        std::int32_t    _height     = 0;            /** Height of the image (in pixels) */
+        std::size_t     _capacity   = 0;            /** Allocated size of the pixel buffer (in bytes) */
+        bool            _pending    = false;        /** Whether the pixel buffer holds an image which was not taken yet */
+    };
+
+    /** Image which was read or queued but not taken yet */
+    struct PendingImage {
+        QImage          _image;                     /** Image rendered without OpenGL (null for read images) */
+        std::int32_t    _pixelBufferIndex = -1;     /** Index of the pixel buffer of a read image (-1 for queued images) */
+    };
+
+public:
+    static constexpr std::int32_t   NUMBER_OF_PIXEL_BUFFERS = 2;    /** Number of images which can be transferred concurrently */
+
+protected:
+    std::array<PixelBuffer, NUMBER_OF_PIXEL_BUFFERS>    _pixelBuffers;          /** Pixel buffers */
+    std::int32_t                                        _nextPixelBufferIndex = 0;  /** Index of the pixel buffer of the next read */
+    std::deque<PendingImage>                            _pendingImages;         /** Images in the order they were read or queued */
+    bool                                                _isInitialized = false; /** Whether the pixel buffers were created */
+
+    static constexpr GLuint64   FENCE_TIMEOUT = 1000000000;     /** Time (in nanoseconds) after which waiting for a transfer is given up */
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QThread>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace common {
+
+/** Half-open range of indices [first, second) (e.g. processed by one task) */
+using IndexRange = std::pair<std::size_t, std::size_t>;
+
+/**
+ * Split [0, count) into ranges so that the work can be distributed over the thread pool
+ * @param count Number of items
+ * @param minimumRangeSize Minimum number of items per range (prevents excessive task overhead)
+ * @param maximumNumberOfRanges Maximum number of ranges (zero for the ideal thread count)
+ * @return Ranges
+ */
+inline std::vector<IndexRange> getIndexRanges(const std::size_t& count, const std::size_t& minimumRangeSize = 1, const std::size_t& maximumNumberOfRanges = 0)
+{
+    std::vector<IndexRange> ranges;
+
+    if (count == 0)
+        return ranges;
+
+    const auto maximum          = maximumNumberOfRanges > 0 ? maximumNumberOfRanges : static_cast<std::size_t>(std::max(1, QThread::idealThreadCount()));
+    const auto numberOfRanges   = std::max<std::size_t>(1, std::min(maximum, count / std::max<std::size_t>(1, minimumRangeSize)));
+    const auto rangeSize        = (count + numberOfRanges - 1) / numberOfRanges;
+
+    for (std::size_t first = 0; first < count; first += rangeSize)
+        ranges.emplace_back(first, std::min(count, first + rangeSize));
+
+    return ranges;
+}
+
+/**
+ * Merge sorted indices into ranges of nearby indices (e.g. to upload only the changed parts of a buffer)
+ * @param sortedIndices Indices in ascending order
+ * @param maximumGap Maximum number of other indices between two indices of the same range (fewer, larger ranges)
+ * @return Ranges
+ */
+inline std::vector<IndexRange> getContiguousRanges(const std::vector<std::uint32_t>& sortedIndices, const std::size_t& maximumGap = 0)
+{
+    std::vector<IndexRange> ranges;
+
+    for (const auto& index : sortedIndices) {
+        if (!ranges.empty() && index <= ranges.back().second + maximumGap)
+            ranges.back().second = std::max<std::size_t>(ranges.back().second, index + 1);
+        else
+            ranges.emplace_back(index, index + 1);
+    }
+
+    return ranges;
+}
+
+/**
+ * Get the indices [0, count) (the items which are mapped by QtConcurrent)
+ * @param count Number of items
+ * @return Indices
+ */
+inline std::vector<std::size_t> getIndices(const std::size_t& count)
+{
+    std::vector<std::size_t> indices(count);
+
+    std::iota(indices.begin(), indices.end(), 0);
+
+    return indices;
+}
+
+}
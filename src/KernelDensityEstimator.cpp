@@ -0,0 +1,198 @@
+#include "KernelDensityEstimator.h"
+#include "IndexRanges.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+
+void KernelDensityEstimator::computeHistogram(const std::vector<Vector2f>& positions, const Bounds& bounds, const std::uint32_t& resolution, DensityGrid& histogram, const std::vector<float>* weights /*= nullptr*/)
+{
+    histogram.reset(resolution);
+
+    if (resolution == 0 || positions.empty() || bounds.getWidth() <= 0.0f || bounds.getHeight() <= 0.0f)
+        return;
+
+    // Weights that do not match the positions are ignored
+    if (weights != nullptr && weights->size() != positions.size())
+        weights = nullptr;
+
+    // Each task bins a range of points into a private histogram to avoid write contention
+    const auto pointRanges = common::getIndexRanges(positions.size(), 65536);
+
+    std::vector<std::vector<float>> partialHistograms(pointRanges.size());
+
+    QtConcurrent::blockingMap(common::getIndices(pointRanges.size()), [&](const std::size_t& rangeIndex) -> void {
+        auto& partialHistogram = partialHistograms[rangeIndex];
+
+        partialHistogram.assign(static_cast<std::size_t>(resolution) * resolution, 0.0f);
+
+        for (auto pointIndex = pointRanges[rangeIndex].first; pointIndex < pointRanges[rangeIndex].second; pointIndex++) {
+            std::size_t cellIndex = 0;
+
+            // Skip points outside of the grid
+            if (!getCellIndex(positions[pointIndex], bounds, resolution, cellIndex))
+                continue;
+
+            partialHistogram[cellIndex] += weights != nullptr ? (*weights)[pointIndex] : 1.0f;
+        }
+    });
+
+    // Reduce the partial histograms, distributed over ranges of grid rows
+    auto& values = histogram.getValues();
+
+    QtConcurrent::blockingMap(common::getIndexRanges(resolution, 16), [&](const common::IndexRange& rowRange) -> void {
+        const auto first    = rowRange.first * resolution;
+        const auto last     = rowRange.second * resolution;
+
+        for (const auto& partialHistogram : partialHistograms)
+            for (auto cellIndex = first; cellIndex < last; cellIndex++)
+                values[cellIndex] += partialHistogram[cellIndex];
+    });
+
+    histogram.updateRange();
+}
+
+bool KernelDensityEstimator::getCellIndex(const Vector2f& position, const Bounds& bounds, const std::uint32_t& resolution, std::size_t& cellIndex)
+{
+    if (bounds.getWidth() <= 0.0f || bounds.getHeight() <= 0.0f)
+        return false;
+
+    // Scale from data coordinates to grid coordinates
+    const auto x = static_cast<std::int64_t>(std::floor((position.x - bounds.getLeft()) * static_cast<float>(resolution) / bounds.getWidth()));
+    const auto y = static_cast<std::int64_t>(std::floor((position.y - bounds.getBottom()) * static_cast<float>(resolution) / bounds.getHeight()));
+
+    if (x < 0 || y < 0 || x >= resolution || y >= resolution)
+        return false;
+
+    cellIndex = static_cast<std::size_t>(y) * resolution + static_cast<std::size_t>(x);
+
+    return true;
+}
+
+void KernelDensityEstimator::downsample(const DensityGrid& histogram, const std::uint32_t& factor, DensityGrid& downsampled)
+{
+    const auto resolution = factor > 0 ? histogram.getResolution() / factor : 0;
+
+    downsampled.reset(resolution);
+
+    if (resolution == 0)
+        return;
+
+    // Keep the values comparable to the full resolution density
+    const auto normalization = 1.0f / static_cast<float>(factor * factor);
+
+    auto& values = downsampled.getValues();
+
+    for (std::uint32_t y = 0; y < resolution * factor; y++)
+        for (std::uint32_t x = 0; x < resolution * factor; x++)
+            values[(y / factor) * resolution + (x / factor)] += normalization * histogram.getValue(x, y);
+
+    downsampled.updateRange();
+}
+
+void KernelDensityEstimator::blur(const DensityGrid& histogram, const float& sigma, DensityGrid& density, const std::atomic_bool* canceled /*= nullptr*/)
+{
+    const auto resolution = histogram.getResolution();
+
+    density.reset(resolution);
+
+    if (resolution == 0)
+        return;
+
+    const auto kernel       = getKernel(sigma, resolution);
+    const auto kernelRadius = static_cast<std::int64_t>(kernel.size() / 2);
+    const auto& input       = histogram.getValues();
+    auto& output            = density.getValues();
+
+    // Intermediate result of the horizontal pass
+    std::vector<float> horizontal(input.size(), 0.0f);
+
+    auto rowRanges = common::getIndexRanges(resolution, 8);
+
+    // Horizontal pass: scatter each non-empty cell over its row (histograms are typically sparse)
+    QtConcurrent::blockingMap(rowRanges, [&](const common::IndexRange& rowRange) -> void {
+        for (auto y = rowRange.first; y < rowRange.second; y++) {
+
+            // Stop when the computation was superseded
+            if (canceled != nullptr && *canceled)
+                return;
+
+            const auto rowOffset = y * resolution;
+
+            for (std::int64_t x = 0; x < resolution; x++) {
+                const auto value = input[rowOffset + x];
+
+                if (value == 0.0f)
+                    continue;
+
+                const auto first    = std::max<std::int64_t>(0, x - kernelRadius);
+                const auto last     = std::min<std::int64_t>(resolution - 1, x + kernelRadius);
+
+                for (auto targetX = first; targetX <= last; targetX++)
+                    horizontal[rowOffset + targetX] += value * kernel[targetX - x + kernelRadius];
+            }
+        }
+    });
+
+    // Vertical pass: gather whole rows at a time to keep memory access sequential
+    QtConcurrent::blockingMap(rowRanges, [&](const common::IndexRange& rowRange) -> void {
+        for (auto y = static_cast<std::int64_t>(rowRange.first); y < static_cast<std::int64_t>(rowRange.second); y++) {
+
+            // Stop when the computation was superseded
+            if (canceled != nullptr && *canceled)
+                return;
+
+            auto outputRow = output.data() + y * resolution;
+
+            const auto first    = std::max<std::int64_t>(0, y - kernelRadius);
+            const auto last     = std::min<std::int64_t>(resolution - 1, y + kernelRadius);
+
+            for (auto sourceY = first; sourceY <= last; sourceY++) {
+                const auto weight       = kernel[sourceY - y + kernelRadius];
+                const auto sourceRow    = horizontal.data() + sourceY * resolution;
+
+                for (std::uint32_t x = 0; x < resolution; x++)
+                    outputRow[x] += weight * sourceRow[x];
+            }
+        }
+    });
+
+    if (canceled != nullptr && *canceled)
+        return;
+
+    density.updateRange();
+}
+
+void KernelDensityEstimator::compute(const std::vector<Vector2f>& positions, const Bounds& bounds, const float& sigma, const std::uint32_t& resolution, DensityGrid& density, const std::vector<float>* weights /*= nullptr*/)
+{
+    DensityGrid histogram;
+
+    computeHistogram(positions, bounds, resolution, histogram, weights);
+    blur(histogram, sigma, density);
+}
+
+std::vector<float> KernelDensityEstimator::getKernel(const float& sigma, const std::uint32_t& resolution)
+{
+    // The kernel width is truncated at three standard deviations
+    const auto kernelRadius         = std::max(1, static_cast<int>(std::round(sigma * resolution)));
+    const auto standardDeviation    = std::max(0.5f, static_cast<float>(kernelRadius) / 3.0f);
+
+    std::vector<float> kernel(2 * kernelRadius + 1);
+
+    float sum = 0.0f;
+
+    for (int offset = -kernelRadius; offset <= kernelRadius; offset++) {
+        const auto weight = std::exp(-0.5f * (offset * offset) / (standardDeviation * standardDeviation));
+
+        kernel[offset + kernelRadius] = weight;
+
+        sum += weight;
+    }
+
+    // Normalize so that the total point count is preserved
+    for (auto& weight : kernel)
+        weight /= sum;
+
+    return kernel;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "DensityGrid.h"
+
+#include "graphics/Vector2f.h"
+#include "graphics/Bounds.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+using namespace hdps;
+
+/**
+ * Kernel density estimator class
+ *
+ * CPU implementation of the kernel density estimation of the density renderer: points are
+ * binned into a square histogram grid which covers the data bounds, after which the histogram
+ * is convolved with a separable Gaussian kernel. Both steps are distributed over the global
+ * thread pool. Points can optionally be weighted (e.g. by the expression of a gene), in which
+ * case the grid holds the smoothed sum of weights instead of the point density.
+ */
+class KernelDensityEstimator
+{
+public:
+
+    /**
+     * Bin \p positions into a histogram grid which covers \p bounds (points outside the bounds are ignored)
+     * @param positions Point positions
+     * @param bounds Data bounds covered by the grid
+     * @param resolution Number of grid cells along each axis
+     * @param histogram Histogram grid to populate (point count per cell, or summed weight per cell when \p weights is given)
+     * @param weights Optional per-point weights (same size as \p positions)
+     */
+    static void computeHistogram(const std::vector<Vector2f>& positions, const Bounds& bounds, const std::uint32_t& resolution, DensityGrid& histogram, const std::vector<float>* weights = nullptr);
+
+    /**
+     * Get the histogram cell which contains \p position
+     * @param position Point position
+     * @param bounds Data bounds covered by the grid
+     * @param resolution Number of grid cells along each axis
+     * @param cellIndex Row major index of the cell (only valid when the function returns true)
+     * @return Whether the position lies inside the grid
+     */
+    static bool getCellIndex(const Vector2f& position, const Bounds& bounds, const std::uint32_t& resolution, std::size_t& cellIndex);
+
+    /**
+     * Sum blocks of \p factor x \p factor cells of \p histogram
+     * @param histogram Full resolution histogram
+     * @param factor Downsampling factor (must divide the histogram resolution)
+     * @param downsampled Downsampled histogram (counts expressed per full resolution cell)
+     */
+    static void downsample(const DensityGrid& histogram, const std::uint32_t& factor, DensityGrid& downsampled);
+
+    /**
+     * Convolve \p histogram with a Gaussian kernel
+     * @param histogram Histogram grid
+     * @param sigma Kernel width as a fraction of the grid width (the kernel is truncated at three standard deviations)
+     * @param density Density grid to populate (same resolution as the histogram)
+     * @param canceled Optional flag which aborts the convolution when set (the density grid is incomplete in that case)
+     */
+    static void blur(const DensityGrid& histogram, const float& sigma, DensityGrid& density, const std::atomic_bool* canceled = nullptr);
+
+    /**
+     * Compute the density of \p positions (bins the points and convolves the histogram)
+     * @param positions Point positions
+     * @param bounds Data bounds covered by the grid
+     * @param sigma Kernel width as a fraction of the grid width
+     * @param resolution Number of grid cells along each axis
+     * @param density Density grid to populate
+     * @param weights Optional per-point weights (same size as \p positions)
+     */
+    static void compute(const std::vector<Vector2f>& positions, const Bounds& bounds, const float& sigma, const std::uint32_t& resolution, DensityGrid& density, const std::vector<float>* weights = nullptr);
+
+    /**
+     * Get the (normalized) one-dimensional Gaussian kernel weights for \p sigma at \p resolution
+     * @param sigma Kernel width as a fraction of the grid width
+     * @param resolution Number of grid cells along each axis
+     * @return Kernel weights (odd number of weights, centered)
+     */
+    static std::vector<float> getKernel(const float& sigma, const std::uint32_t& resolution);
+
+public:
+    static constexpr std::uint32_t DEFAULT_RESOLUTION = 512;    /** Default number of grid cells along each axis (matches the density renderer) */
+};
@@ -1,5 +1,6 @@
 #include "ManualClusteringAction.h"
 #include "ViewerScatterplotPlugin.h"
+#include "ViewerScatterplotWidget.h"
 #include "Application.h"
 #include "PointData/PointData.h"
 #include "ClusterData/ClusterData.h"
@@ -15,7 +16,9 @@ ManualClusteringAction::ManualClusteringAction(ViewerScatterplotPlugin* viewersc
     _nameAction(this, "Name"),
     _colorAction(this, "Color"),
     _addClusterAction(this, "Add cluster"),
-    _targetClusterDataset(this, "Cluster set")
+    _targetClusterDataset(this, "Cluster set"),
+    _minimumPeakDensityAction(this, "Min. density", 0.0f, 50.0f, 5.0f, 5.0f, 1),
+    _densityPeakClustersAction(this, "Density peaks")
 {
     setText("Manual clustering");
     setIcon(Application::getIconFont("FontAwesome").getIcon("th-large"));
@@ -24,6 +27,13 @@ ManualClusteringAction::ManualClusteringAction(ViewerScatterplotPlugin* viewersc
     _colorAction.setToolTip("Color of the cluster");
     _addClusterAction.setToolTip("Add cluster");
     _targetClusterDataset.setToolTip("Target cluster set");
+    _minimumPeakDensityAction.setToolTip("Points in cells with a lower density (percentage of the maximum density) are not clustered");
+    _densityPeakClustersAction.setToolTip("Cluster all points by the peaks of the density and add the clusters as a new cluster set");
+
+    _minimumPeakDensityAction.setSuffix("%");
+
+    // Cluster by density peaks when the action is triggered
+    connect(&_densityPeakClustersAction, &TriggerAction::triggered, this, &ManualClusteringAction::createDensityPeakClusters);
 
     // Update actions when the cluster name changed
     connect(&_nameAction, &StringAction::stringChanged, this, &ManualClusteringAction::updateActions);
@@ -108,6 +118,55 @@ void ManualClusteringAction::updateTargetClusterDatasets()
         _targetClusterDataset.setCurrentDataset(clusterDatasets.first());
 }
 
+void ManualClusteringAction::createDensityPeakClusters()
+{
+    auto positionDataset = _viewerscatterplotPlugin->getPositionDataset();
+
+    // Only cluster when there is a position dataset
+    if (!positionDataset.isValid())
+        return;
+
+    // Cluster index per local point index
+    std::vector<std::int32_t> pointLabels;
+
+    const auto numberOfClusters = getViewerScatterplotWidget().clusterDensityPeaks(0.01f * _minimumPeakDensityAction.getValue(), pointLabels);
+
+    if (numberOfClusters == 0)
+        return;
+
+    // Mapping from local to global indices
+    std::vector<std::uint32_t> localGlobalIndices;
+
+    positionDataset->getGlobalIndices(localGlobalIndices);
+
+    // Global point indices per cluster
+    std::vector<std::vector<std::uint32_t>> clusterIndices(numberOfClusters);
+
+    for (std::size_t localIndex = 0; localIndex < pointLabels.size() && localIndex < localGlobalIndices.size(); localIndex++)
+        if (pointLabels[localIndex] != DensityPeakClustering::NO_CLUSTER)
+            clusterIndices[pointLabels[localIndex]].push_back(localGlobalIndices[localIndex]);
+
+    // Add the density peak clusters dataset
+    auto clusters = Application::core()->addDataset<Clusters>("Cluster", "Clusters (density peaks)", positionDataset);
+
+    for (std::int32_t clusterIndex = 0; clusterIndex < numberOfClusters; clusterIndex++) {
+        Cluster cluster;
+
+        // Spread the hues evenly (clusters are ordered by descending peak density)
+        cluster.setName(QString("Peak %1").arg(clusterIndex + 1));
+        cluster.setColor(QColor::fromHsl(static_cast<int>(360.0f * clusterIndex / numberOfClusters), 200, 140));
+        cluster.setIndices(clusterIndices[clusterIndex]);
+
+        clusters->addCluster(cluster);
+    }
+
+    // Notify others that the clusters were added
+    events().notifyDatasetAdded(clusters);
+
+    // Show the clusters
+    _viewerscatterplotPlugin->getSettingsAction().getColoringAction().setCurrentColorDataset(clusters);
+}
+
 void ManualClusteringAction::updateActions()
 {
     const auto positionDataset          = _viewerscatterplotPlugin->getPositionDataset();
@@ -156,6 +215,10 @@ ManualClusteringAction::Widget::Widget(QWidget* parent, ManualClusteringAction*
 
         layout->addWidget(manualClusteringAction->getAddClusterAction().createWidget(this), 3, 1);
 
+        layout->addWidget(manualClusteringAction->getMinimumPeakDensityAction().createLabelWidget(this), 4, 0);
+        layout->addWidget(manualClusteringAction->getMinimumPeakDensityAction().createWidget(this), 4, 1);
+        layout->addWidget(manualClusteringAction->getDensityPeakClustersAction().createWidget(this), 5, 1);
+
         setPopupLayout(layout);
     }
     else {
@@ -180,6 +243,7 @@ ManualClusteringAction::Widget::Widget(QWidget* parent, ManualClusteringAction*
         layout->addWidget(nameWidget);
         layout->addWidget(colorWidget);
         layout->addWidget(createWidget);
+        layout->addWidget(manualClusteringAction->getDensityPeakClustersAction().createWidget(this));
 
         setLayout(layout);
     }
@@ -57,6 +57,9 @@ public:
     /** Update the target cluster datasets action (creates default set if no cluster sets are available) */
     void updateTargetClusterDatasets();
 
+    /** Cluster all points by the peaks of their density and add the clusters as a new clusters dataset (child of the position dataset) */
+    void createDensityPeakClusters();
+
 protected:
 
     /** Update the state of the actions */
@@ -69,10 +72,14 @@ public: // Action getters
     TriggerAction& getCreateCluster() { return _addClusterAction; }
     TriggerAction& getAddClusterAction() { return _addClusterAction; }
     DatasetPickerAction& getTargetClusterDataset() { return _targetClusterDataset; }
+    DecimalAction& getMinimumPeakDensityAction() { return _minimumPeakDensityAction; }
+    TriggerAction& getDensityPeakClustersAction() { return _densityPeakClustersAction; }
 
 protected:
     StringAction            _nameAction;                /** Cluster name action */
     ColorAction             _colorAction;               /** Cluster color action */
     TriggerAction           _addClusterAction;          /** Add manual cluster action */
     DatasetPickerAction     _targetClusterDataset;      /** Target cluster dataset action */
+    DecimalAction           _minimumPeakDensityAction;  /** Minimum density (percentage of the maximum) of clustered cells */
+    TriggerAction           _densityPeakClustersAction; /** Create clusters from the density peaks action */
 };
@@ -0,0 +1,313 @@
+#include "MappedPointRenderer.h"
+
+#include <QDebug>
+
+#include <algorithm>
+
+void MappedPointRenderer::init()
+{
+    initializeOpenGLFunctions();
+
+    _isInitialized = true;
+
+    // Build the program which draws the points (the points are not rendered with OpenGL when it fails)
+    auto program = std::make_unique<QOpenGLShaderProgram>();
+
+    if (!program->addShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/MappedPoints.vert") || !program->addShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/MappedPoints.frag") || !program->link()) {
+        qWarning() << "Unable to build the mapped point program, points are not rendered with OpenGL";
+
+        for (auto& buffer : _buffers)
+            std::vector<char>().swap(buffer._pending);
+
+        return;
+    }
+
+    _program = std::move(program);
+
+    glGenVertexArrays(1, &_vertexArray);
+    glBindVertexArray(_vertexArray);
+
+    // One buffer per attribute, each point is an instance of the quad
+    for (int attribute = 0; attribute < NumberOfAttributes; attribute++) {
+        glGenBuffers(1, &_buffers[attribute]._buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, _buffers[attribute]._buffer);
+
+        switch (attribute)
+        {
+            case PositionAttribute:
+                glVertexAttribPointer(attribute, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+                break;
+
+            // Packed 0xRRGGBB colors are read as normalized (blue, green, red, zero) bytes
+            case ColorAttribute:
+                glVertexAttribPointer(attribute, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, nullptr);
+                break;
+
+            case HighlightAttribute:
+                glVertexAttribPointer(attribute, 1, GL_UNSIGNED_BYTE, GL_FALSE, 0, nullptr);
+                break;
+
+            default:
+                glVertexAttribPointer(attribute, 1, GL_FLOAT, GL_FALSE, 0, nullptr);
+                break;
+        }
+
+        glVertexAttribDivisor(attribute, 1);
+    }
+
+    glEnableVertexAttribArray(PositionAttribute);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenTextures(1, &_colorMapTexture);
+
+    // Upload the per-point data which was set before
+    for (int attribute = 0; attribute < NumberOfAttributes; attribute++) {
+        auto& buffer = _buffers[attribute];
+
+        if (buffer._count == 0)
+            continue;
+
+        const auto pending = std::move(buffer._pending);
+
+        uploadBuffer(static_cast<Attribute>(attribute), pending.data(), buffer._count, pending.size() / buffer._count);
+    }
+}
+
+void MappedPointRenderer::destroy()
+{
+    if (!_isInitialized)
+        return;
+
+    for (auto& buffer : _buffers) {
+        glDeleteBuffers(1, &buffer._buffer);
+
+        buffer = PointBuffer();
+    }
+
+    glDeleteVertexArrays(1, &_vertexArray);
+    glDeleteTextures(1, &_colorMapTexture);
+
+    _vertexArray        = 0;
+    _colorMapTexture    = 0;
+    _colorMapOutOfDate  = !_colorMapImage.isNull();
+    _isInitialized      = false;
+
+    _program.reset();
+}
+
+bool MappedPointRenderer::isInitialized() const
+{
+    return _isInitialized && _program;
+}
+
+void MappedPointRenderer::setPositions(const std::vector<Vector2f>& positions)
+{
+    uploadBuffer(PositionAttribute, positions.data(), positions.size(), sizeof(Vector2f));
+}
+
+void MappedPointRenderer::setColorScalars(const std::vector<float>& colorScalars)
+{
+    uploadBuffer(ColorScalarAttribute, colorScalars.data(), colorScalars.size(), sizeof(float));
+    uploadBuffer(ColorAttribute, nullptr, 0, sizeof(std::uint32_t));
+}
+
+void MappedPointRenderer::setColors(const std::vector<std::uint32_t>& colors)
+{
+    uploadBuffer(ColorAttribute, colors.data(), colors.size(), sizeof(std::uint32_t));
+    uploadBuffer(ColorScalarAttribute, nullptr, 0, sizeof(float));
+}
+
+void MappedPointRenderer::setHighlights(const std::vector<char>& highlights)
+{
+    uploadBuffer(HighlightAttribute, highlights.data(), highlights.size(), sizeof(char));
+}
+
+void MappedPointRenderer::updateHighlights(const std::vector<char>& highlights, const std::vector<common::IndexRange>& ranges)
+{
+    auto& buffer = _buffers[HighlightAttribute];
+
+    if (highlights.size() != buffer._count || (_isInitialized && buffer._capacity != buffer._count)) {
+        setHighlights(highlights);
+        return;
+    }
+
+    if (_isInitialized && !_program)
+        return;
+
+    if (_isInitialized)
+        glBindBuffer(GL_ARRAY_BUFFER, buffer._buffer);
+
+    for (const auto& range : ranges) {
+        const auto last = std::min(range.second, highlights.size());
+
+        if (range.first >= last)
+            continue;
+
+        // Patch the data which is uploaded once the renderer is initialized, or upload the range only
+        if (!_isInitialized)
+            std::copy(highlights.begin() + range.first, highlights.begin() + last, buffer._pending.begin() + range.first);
+        else
+            glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(range.first), static_cast<GLsizeiptr>(last - range.first), highlights.data() + range.first);
+    }
+
+    if (_isInitialized)
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void MappedPointRenderer::setSizeSources(const std::vector<float>& sizeSources)
+{
+    uploadBuffer(SizeSourceAttribute, sizeSources.data(), sizeSources.size(), sizeof(float));
+}
+
+void MappedPointRenderer::setOpacitySources(const std::vector<float>& opacitySources)
+{
+    uploadBuffer(OpacitySourceAttribute, opacitySources.data(), opacitySources.size(), sizeof(float));
+}
+
+void MappedPointRenderer::setColorMap(const QImage& colorMapImage)
+{
+    // The color map is uploaded when the points are rendered next
+    _colorMapImage      = colorMapImage;
+    _colorMapOutOfDate  = true;
+}
+
+void MappedPointRenderer::render(const SoftwarePointSettings& settings, const QSize& viewportSize, const QRectF& dataRectangle, const float& pointScale)
+{
+    const auto numberOfPoints = _buffers[PositionAttribute]._count;
+
+    if (!isInitialized() || numberOfPoints == 0 || viewportSize.isEmpty() || settings._bounds.getWidth() <= 0.0f || settings._bounds.getHeight() <= 0.0f)
+        return;
+
+    // Upload the color map (only when it changed)
+    if (_colorMapOutOfDate) {
+        const auto colorMapImage = _colorMapImage.convertToFormat(QImage::Format_RGBA8888);
+
+        glBindTexture(GL_TEXTURE_2D, _colorMapTexture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, colorMapImage.width(), colorMapImage.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, colorMapImage.isNull() ? nullptr : colorMapImage.constBits());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        _colorMapOutOfDate = false;
+    }
+
+    const auto& bounds = settings._bounds;
+
+    // Colors of the point effects (colors, color map and 2D color map)
+    const auto effect = settings._effect == PointEffect::Color ? 1 : (settings._effect == PointEffect::Color2D ? 2 : 0);
+
+    // The software point renderer truncates the selection color to bytes
+    const auto toByteChannel = [](const float& channel) -> float {
+        return static_cast<float>(static_cast<int>(255.0f * channel)) / 255.0f;
+    };
+
+    glViewport(0, 0, viewportSize.width(), viewportSize.height());
+
+    _program->bind();
+
+    _program->setUniformValue("bounds", bounds.getLeft(), bounds.getTop(), bounds.getWidth(), bounds.getHeight());
+    _program->setUniformValue("dataRectangle", static_cast<float>(dataRectangle.left()), static_cast<float>(dataRectangle.top()), static_cast<float>(dataRectangle.width()), static_cast<float>(dataRectangle.height()));
+    _program->setUniformValue("viewportSize", static_cast<float>(viewportSize.width()), static_cast<float>(viewportSize.height()));
+    _program->setUniformValue("pointScale", pointScale);
+    _program->setUniformValue("sizeMapping", settings._sizeMapping._offset, settings._sizeMapping._scale, settings._sizeMapping._selectionOffset);
+    _program->setUniformValue("opacityMapping", settings._opacityMapping._offset, settings._opacityMapping._scale, settings._opacityMapping._selectionOffset);
+    _program->setUniformValue("effect", effect);
+    _program->setUniformValue("hasColorScalars", _buffers[ColorScalarAttribute]._count == numberOfPoints);
+    _program->setUniformValue("colorMapRange", settings._colorMapRange.x, settings._colorMapRange.y, settings._colorMapRange.z);
+    _program->setUniformValue("colorMap", 0);
+
+    glUniform2i(_program->uniformLocation("colorMapSize"), _colorMapImage.width(), _colorMapImage.height());
+
+    _program->setUniformValue("hasOutline", settings._selectionDisplayMode == PointSelectionDisplayMode::Outline);
+    _program->setUniformValue("selectionColor", toByteChannel(settings._selectionOutlineColor.x), toByteChannel(settings._selectionOutlineColor.y), toByteChannel(settings._selectionOutlineColor.z));
+    _program->setUniformValue("outlineOverride", settings._selectionOutlineOverride);
+    _program->setUniformValue("outlineScale", settings._selectionOutlineScale);
+    _program->setUniformValue("outlineOpacity", std::clamp(settings._selectionOutlineOpacity, 0.0f, 1.0f));
+    _program->setUniformValue("haloEnabled", settings._selectionHaloEnabled);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, _colorMapTexture);
+
+    glBindVertexArray(_vertexArray);
+
+    // Attributes which do not match the positions are ignored (they take a constant zero)
+    for (int attribute = ColorScalarAttribute; attribute < NumberOfAttributes; attribute++) {
+        if (_buffers[attribute]._count == numberOfPoints) {
+            glEnableVertexAttribArray(attribute);
+        }
+        else {
+            glDisableVertexAttribArray(attribute);
+            glVertexAttrib4f(attribute, 0.0f, 0.0f, 0.0f, 0.0f);
+        }
+    }
+
+    // Blend the premultiplied point colors (restore the blend state of the caller afterwards)
+    GLint blendSourceRgb = 0, blendDestinationRgb = 0, blendSourceAlpha = 0, blendDestinationAlpha = 0;
+
+    glGetIntegerv(GL_BLEND_SRC_RGB, &blendSourceRgb);
+    glGetIntegerv(GL_BLEND_DST_RGB, &blendDestinationRgb);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &blendSourceAlpha);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &blendDestinationAlpha);
+
+    const auto blendEnabled = glIsEnabled(GL_BLEND);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Draw the unselected points first so that the selected points are on top
+    _program->setUniformValue("selectionPass", 0);
+
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(numberOfPoints));
+
+    if (_buffers[HighlightAttribute]._count == numberOfPoints) {
+        _program->setUniformValue("selectionPass", 1);
+
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(numberOfPoints));
+    }
+
+    glBlendFuncSeparate(static_cast<GLenum>(blendSourceRgb), static_cast<GLenum>(blendDestinationRgb), static_cast<GLenum>(blendSourceAlpha), static_cast<GLenum>(blendDestinationAlpha));
+
+    if (!blendEnabled)
+        glDisable(GL_BLEND);
+
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    _program->release();
+}
+
+void MappedPointRenderer::uploadBuffer(const Attribute& attribute, const void* data, const std::size_t& count, const std::size_t& elementSize)
+{
+    auto& buffer = _buffers[attribute];
+
+    buffer._count = count;
+
+    // Keep the data until the renderer is initialized
+    if (!_isInitialized) {
+        const auto bytes = static_cast<const char*>(data);
+
+        buffer._pending.assign(bytes, bytes + count * elementSize);
+        return;
+    }
+
+    if (!_program)
+        return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffer._buffer);
+
+    // Only (re)allocate the storage when the number of points changes
+    if (count != buffer._capacity) {
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(count * elementSize), data, GL_STATIC_DRAW);
+
+        buffer._capacity = count;
+    }
+    else if (count > 0) {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(count * elementSize), data);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "SoftwarePointRenderer.h"
+#include "IndexRanges.h"
+
+#include "graphics/Vector2f.h"
+
+#include <QOpenGLFunctions_3_3_Core>
+#include <QOpenGLShaderProgram>
+#include <QImage>
+#include <QRectF>
+#include <QSize>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Mapped point renderer class
+ *
+ * OpenGL point renderer of the plugin which draws the points as instanced, anti-aliased disks in the same way as the
+ * software point renderer (same settings, same coverage and the selected points on top). The point sizes and opacities
+ * are mapped from per-point source scalars in the vertex shader (see PointScalarMapping), so the source scalars are
+ * uploaded once and changing the mapping (e.g. dragging the magnitude or offset) only changes uniforms. Per-point data
+ * which is set before the renderer is initialized is kept until init uploads it.
+ */
+class MappedPointRenderer : protected QOpenGLFunctions_3_3_Core
+{
+public:
+
+    /** Initialize the OpenGL functions, build the program and upload the pending per-point data (requires a current OpenGL context) */
+    void init();
+
+    /** Release the OpenGL resources (requires the OpenGL context of init) */
+    void destroy();
+
+    /** Get whether the renderer was initialized and the program was built */
+    bool isInitialized() const;
+
+    /**
+     * Set the point positions (the per-point setters require the OpenGL context of init once the renderer is initialized)
+     * @param positions Point positions
+     */
+    void setPositions(const std::vector<Vector2f>& positions);
+
+    /**
+     * Set the color scalars (color map point effect, releases the colors)
+     * @param colorScalars Color scalars
+     */
+    void setColorScalars(const std::vector<float>& colorScalars);
+
+    /**
+     * Set the point colors (no point effect, releases the color scalars)
+     * @param colors Colors as 0xRRGGBB
+     */
+    void setColors(const std::vector<std::uint32_t>& colors);
+
+    /**
+     * Set the selection state of all points
+     * @param highlights Selection state per point
+     */
+    void setHighlights(const std::vector<char>& highlights);
+
+    /**
+     * Upload the selection state of the points in \p ranges only (uploads all of them when the number of points changed)
+     * @param highlights Selection state per point
+     * @param ranges Ranges of local point indices for which the selection state changed
+     */
+    void updateHighlights(const std::vector<char>& highlights, const std::vector<common::IndexRange>& ranges);
+
+    /**
+     * Set the source scalars of the point size mapping
+     * @param sizeSources Source scalars (empty releases them, the mapping is evaluated with a zero source scalar)
+     */
+    void setSizeSources(const std::vector<float>& sizeSources);
+
+    /**
+     * Set the source scalars of the point opacity mapping
+     * @param opacitySources Source scalars (empty releases them, the mapping is evaluated with a zero source scalar)
+     */
+    void setOpacitySources(const std::vector<float>& opacitySources);
+
+    /**
+     * Set the color map (1D maps are sampled along the center row)
+     * @param colorMapImage Color map image
+     */
+    void setColorMap(const QImage& colorMapImage);
+
+    /**
+     * Render the points into the current framebuffer (premultiplied, blended over its contents), sets the viewport
+     * @param settings Point appearance settings
+     * @param viewportSize Size of the viewport (in pixels)
+     * @param dataRectangle Rectangle (in viewport pixels, top-left origin) which covers the data bounds
+     * @param pointScale Factor for the point sizes (e.g. the device pixel ratio)
+     */
+    void render(const SoftwarePointSettings& settings, const QSize& viewportSize, const QRectF& dataRectangle, const float& pointScale);
+
+protected:
+
+    /** Vertex attribute locations of the per-point buffers */
+    enum Attribute {
+        PositionAttribute,          /** Point position */
+        ColorScalarAttribute,       /** Color scalar */
+        ColorAttribute,             /** Packed color */
+        HighlightAttribute,         /** Selection state */
+        SizeSourceAttribute,        /** Source scalar of the point size mapping */
+        OpacitySourceAttribute,     /** Source scalar of the point opacity mapping */
+
+        NumberOfAttributes
+    };
+
+    /** Per-point buffer of one vertex attribute */
+    struct PointBuffer {
+        GLuint              _buffer         = 0;    /** Buffer object */
+        std::size_t         _count          = 0;    /** Number of points in the buffer */
+        std::size_t         _capacity       = 0;    /** Number of points the buffer object has storage for */
+        std::vector<char>   _pending;               /** Data which is uploaded once the renderer is initialized */
+    };
+
+    /**
+     * Upload per-point data into the buffer of \p attribute (requires the OpenGL context of init, the data is kept until init when the renderer is not initialized)
+     * @param attribute Vertex attribute
+     * @param data Pointer to the data
+     * @param count Number of points
+     * @param elementSize Number of bytes per point
+     */
+    void uploadBuffer(const Attribute& attribute, const void* data, const std::size_t& count, const std::size_t& elementSize);
+
+protected:
+    std::unique_ptr<QOpenGLShaderProgram>   _program;                       /** Draws the points as instanced quads */
+    GLuint                                  _vertexArray        = 0;        /** Vertex array with the per-point buffers (one instance per point) */
+    PointBuffer                             _buffers[NumberOfAttributes];   /** Per-point buffers per vertex attribute */
+    GLuint                                  _colorMapTexture    = 0;        /** Color map texture (sampled with texel fetches) */
+    QImage                                  _colorMapImage;                 /** Color map which is uploaded once the renderer is initialized */
+    bool                                    _colorMapOutOfDate  = false;    /** Whether the color map has to be uploaded */
+    bool                                    _isInitialized      = false;    /** Whether the renderer was initialized */
+};
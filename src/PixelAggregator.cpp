@@ -0,0 +1,235 @@
+#include "PixelAggregator.h"
+#include "IndexRanges.h"
+
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+
+void PixelAggregator::aggregate(const std::vector<Vector2f>& positions, const Bounds& bounds, const std::uint32_t& width, const std::uint32_t& height, const std::vector<float>* scalars, const std::vector<std::uint32_t>* colors, PixelAggregate& aggregate)
+{
+    aggregate = PixelAggregate();
+
+    if (width == 0 || height == 0 || bounds.getWidth() <= 0.0f || bounds.getHeight() <= 0.0f)
+        return;
+
+    // Scalars and colors that do not match the positions are ignored
+    if (scalars != nullptr && scalars->size() != positions.size())
+        scalars = nullptr;
+
+    if (colors != nullptr && colors->size() != positions.size())
+        colors = nullptr;
+
+    const auto numberOfPixels = static_cast<std::size_t>(width) * height;
+
+    aggregate._width    = width;
+    aggregate._height   = height;
+
+    aggregate._counts.assign(numberOfPixels, 0);
+
+    if (scalars != nullptr)
+        aggregate._scalarSums.assign(numberOfPixels, 0.0);
+
+    if (colors != nullptr)
+        aggregate._colorSums.assign(3 * numberOfPixels, 0.0);
+
+    if (positions.empty())
+        return;
+
+    // Limit the number of tasks so that their private grids fit the memory budget
+    const auto bytesPerPixel        = sizeof(std::uint32_t) + (scalars != nullptr ? sizeof(double) : 0) + (colors != nullptr ? 3 * sizeof(double) : 0);
+    const auto maximumNumberOfTasks = std::max<std::size_t>(1, std::min<std::size_t>(QThread::idealThreadCount(), MEMORY_BUDGET / (bytesPerPixel * numberOfPixels)));
+    const auto pointRanges          = common::getIndexRanges(positions.size(), 65536, maximumNumberOfTasks);
+
+    std::vector<PixelAggregate> partialAggregates(pointRanges.size());
+
+    const auto scaleX = static_cast<float>(width) / bounds.getWidth();
+    const auto scaleY = static_cast<float>(height) / bounds.getHeight();
+
+    // Each task bins a range of points into a private grid to avoid write contention
+    QtConcurrent::blockingMap(common::getIndices(pointRanges.size()), [&](const std::size_t& rangeIndex) -> void {
+        auto& partialAggregate = partialAggregates[rangeIndex];
+
+        partialAggregate._counts.assign(numberOfPixels, 0);
+        partialAggregate._scalarSums.assign(aggregate._scalarSums.size(), 0.0);
+        partialAggregate._colorSums.assign(aggregate._colorSums.size(), 0.0);
+
+        for (auto pointIndex = pointRanges[rangeIndex].first; pointIndex < pointRanges[rangeIndex].second; pointIndex++) {
+            const auto& position = positions[pointIndex];
+
+            const auto x = static_cast<std::int64_t>(std::floor((position.x - bounds.getLeft()) * scaleX));
+            const auto y = static_cast<std::int64_t>(std::floor((position.y - bounds.getBottom()) * scaleY));
+
+            if (x < 0 || y < 0 || x >= width || y >= height)
+                continue;
+
+            // Rows are stored top-down
+            const auto pixelIndex = static_cast<std::size_t>(height - 1 - y) * width + static_cast<std::size_t>(x);
+
+            partialAggregate._counts[pixelIndex]++;
+
+            if (scalars != nullptr)
+                partialAggregate._scalarSums[pixelIndex] += (*scalars)[pointIndex];
+
+            if (colors != nullptr) {
+                const auto color = (*colors)[pointIndex];
+
+                partialAggregate._colorSums[3 * pixelIndex]     += static_cast<double>((color >> 16) & 0xff);
+                partialAggregate._colorSums[3 * pixelIndex + 1] += static_cast<double>((color >> 8) & 0xff);
+                partialAggregate._colorSums[3 * pixelIndex + 2] += static_cast<double>(color & 0xff);
+            }
+        }
+    });
+
+    // Reduce the private grids, distributed over ranges of rows
+    const auto rowRanges = common::getIndexRanges(height);
+
+    std::vector<std::uint32_t> maximumCounts(rowRanges.size(), 0);
+
+    QtConcurrent::blockingMap(common::getIndices(rowRanges.size()), [&](const std::size_t& rangeIndex) -> void {
+        const auto first    = rowRanges[rangeIndex].first * width;
+        const auto last     = rowRanges[rangeIndex].second * width;
+
+        for (const auto& partialAggregate : partialAggregates) {
+            for (auto pixelIndex = first; pixelIndex < last; pixelIndex++) {
+                aggregate._counts[pixelIndex] += partialAggregate._counts[pixelIndex];
+
+                if (scalars != nullptr)
+                    aggregate._scalarSums[pixelIndex] += partialAggregate._scalarSums[pixelIndex];
+
+                if (colors != nullptr)
+                    for (std::size_t channelIndex = 0; channelIndex < 3; channelIndex++)
+                        aggregate._colorSums[3 * pixelIndex + channelIndex] += partialAggregate._colorSums[3 * pixelIndex + channelIndex];
+            }
+        }
+
+        for (auto pixelIndex = first; pixelIndex < last; pixelIndex++)
+            maximumCounts[rangeIndex] = std::max(maximumCounts[rangeIndex], aggregate._counts[pixelIndex]);
+    });
+
+    aggregate._maximumCount = *std::max_element(maximumCounts.begin(), maximumCounts.end());
+}
+
+QImage PixelAggregator::shade(const PixelAggregate& aggregate, Shading shading, const Normalization& normalization, const QImage& colorMapImage, const Vector3f& colorMapRange)
+{
+    QImage image(static_cast<int>(aggregate._width), static_cast<int>(aggregate._height), QImage::Format_ARGB32);
+
+    image.fill(Qt::transparent);
+
+    if (!aggregate.isValid() || aggregate._maximumCount == 0 || colorMapImage.isNull())
+        return image;
+
+    // Shade the count when the aggregate lacks scalars/colors
+    if ((shading == Shading::Scalar && aggregate._scalarSums.empty()) || (shading == Shading::Color && aggregate._colorSums.empty()))
+        shading = Shading::Count;
+
+    // Sample the color map along the center row (once per color map texel)
+    const auto colorMapWidth    = colorMapImage.width();
+    const auto colorMapRow      = colorMapImage.height() / 2;
+
+    std::vector<QRgb> lookupTable(colorMapWidth);
+
+    for (int colorMapIndex = 0; colorMapIndex < colorMapWidth; colorMapIndex++)
+        lookupTable[colorMapIndex] = colorMapImage.pixel(colorMapIndex, colorMapRow);
+
+    const auto getColorMapColor = [&lookupTable, colorMapWidth](const float& normalizedValue) -> QRgb {
+        return lookupTable[std::min(colorMapWidth - 1, static_cast<int>(std::clamp(normalizedValue, 0.0f, 1.0f) * colorMapWidth))];
+    };
+
+    // Sorted distinct non-empty counts and the fraction of non-empty pixels with a lower or equal count (histogram equalization)
+    std::vector<std::uint32_t> distinctCounts;
+    std::vector<float> cumulativeFractions;
+
+    if (normalization == Normalization::Equalize) {
+        std::vector<std::uint32_t> counts;
+
+        std::copy_if(aggregate._counts.begin(), aggregate._counts.end(), std::back_inserter(counts), [](const std::uint32_t& count) -> bool {
+            return count > 0;
+        });
+
+        std::sort(counts.begin(), counts.end());
+
+        for (std::size_t countIndex = 0; countIndex < counts.size(); countIndex++) {
+            if (countIndex + 1 < counts.size() && counts[countIndex + 1] == counts[countIndex])
+                continue;
+
+            distinctCounts.push_back(counts[countIndex]);
+            cumulativeFractions.push_back(static_cast<float>(countIndex + 1) / static_cast<float>(counts.size()));
+        }
+    }
+
+    const auto logMaximumCount = std::log1p(static_cast<float>(aggregate._maximumCount));
+
+    const auto normalizeCount = [&](const std::uint32_t& count) -> float {
+        switch (normalization)
+        {
+            case Normalization::Linear:
+                return static_cast<float>(count) / static_cast<float>(aggregate._maximumCount);
+
+            case Normalization::Log:
+                return logMaximumCount > 0.0f ? std::log1p(static_cast<float>(count)) / logMaximumCount : 1.0f;
+
+            case Normalization::Equalize:
+                return cumulativeFractions[std::lower_bound(distinctCounts.begin(), distinctCounts.end(), count) - distinctCounts.begin()];
+        }
+
+        return 0.0f;
+    };
+
+    // Prevent zero division for an empty range
+    const auto scalarNormalization = colorMapRange.z > 0.0f ? 1.0f / colorMapRange.z : 0.0f;
+
+    // A one texel color map (constant color) only varies the opacity
+    const auto isConstantColor = colorMapWidth == 1;
+
+    const auto rowRanges = common::getIndexRanges(aggregate._height);
+
+    QtConcurrent::blockingMap(common::getIndices(rowRanges.size()), [&](const std::size_t& rangeIndex) -> void {
+        for (auto y = rowRanges[rangeIndex].first; y < rowRanges[rangeIndex].second; y++) {
+            auto scanLine = reinterpret_cast<QRgb*>(image.scanLine(static_cast<int>(y)));
+
+            for (std::size_t x = 0; x < aggregate._width; x++) {
+                const auto pixelIndex   = y * aggregate._width + x;
+                const auto count        = aggregate._counts[pixelIndex];
+
+                if (count == 0)
+                    continue;
+
+                const auto normalizedCount  = normalizeCount(count);
+                const auto alpha            = static_cast<int>(255.0f * (MINIMUM_ALPHA + (1.0f - MINIMUM_ALPHA) * normalizedCount));
+
+                switch (shading)
+                {
+                    case Shading::Count:
+                    {
+                        const auto color = getColorMapColor(normalizedCount);
+
+                        scanLine[x] = isConstantColor ? qRgba(qRed(color), qGreen(color), qBlue(color), alpha) : color;
+                        break;
+                    }
+
+                    case Shading::Scalar:
+                    {
+                        const auto color = getColorMapColor((static_cast<float>(aggregate._scalarSums[pixelIndex] / count) - colorMapRange.x) * scalarNormalization);
+
+                        scanLine[x] = qRgba(qRed(color), qGreen(color), qBlue(color), alpha);
+                        break;
+                    }
+
+                    case Shading::Color:
+                    {
+                        const auto red      = static_cast<int>(aggregate._colorSums[3 * pixelIndex] / count);
+                        const auto green    = static_cast<int>(aggregate._colorSums[3 * pixelIndex + 1] / count);
+                        const auto blue     = static_cast<int>(aggregate._colorSums[3 * pixelIndex + 2] / count);
+
+                        scanLine[x] = qRgba(red, green, blue, alpha);
+                        break;
+                    }
+                }
+            }
+        }
+    });
+
+    return image;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "graphics/Vector2f.h"
+#include "graphics/Vector3f.h"
+#include "graphics/Bounds.h"
+
+#include <QImage>
+
+#include <cstdint>
+#include <vector>
+
+using namespace hdps;
+
+/** Points aggregated per pixel of a screen resolution grid (rows are stored top-down, like image scan lines) */
+struct PixelAggregate
+{
+    /**
+     * Get whether there are pixels
+     * @return Whether there are pixels
+     */
+    bool isValid() const {
+        return !_counts.empty();
+    }
+
+    std::uint32_t               _width = 0;             /** Number of pixels along the x-axis */
+    std::uint32_t               _height = 0;            /** Number of pixels along the y-axis */
+    std::vector<std::uint32_t>  _counts;                /** Number of points per pixel */
+    std::vector<double>         _scalarSums;            /** Sum of the point scalars per pixel, in double precision to prevent drift (empty without scalars) */
+    std::vector<double>         _colorSums;             /** Sum of the red, green and blue point color channels per pixel, in double precision like the scalar sums (empty without colors) */
+    std::uint32_t               _maximumCount = 0;      /** Largest number of points in one pixel */
+};
+
+/**
+ * Pixel aggregator class
+ *
+ * Screen space aggregation of very large point sets: instead of drawing each point, the points are
+ * counted per pixel (optionally summing a color scalar or the point colors), after which the grid
+ * is shaded with the color map. The cost of shading and the memory footprint are proportional to
+ * the number of pixels instead of the number of points. Points are binned in parallel, each task
+ * into a private grid (the number of tasks is limited so that the private grids fit a fixed memory
+ * budget), and the private grids are reduced in parallel over ranges of rows.
+ */
+class PixelAggregator
+{
+public:
+
+    /** Mapping of pixel counts to the [0, 1] range */
+    enum class Normalization {
+        Linear,         /** Count divided by the maximum count */
+        Log,            /** Logarithm of the count divided by the logarithm of the maximum count */
+        Equalize,       /** Fraction of the non-empty pixels with a lower or equal count (histogram equalization) */
+    };
+
+    /** What determines the pixel colors */
+    enum class Shading {
+        Count,          /** Color map of the normalized count */
+        Scalar,         /** Color map of the mean scalar, opacity from the normalized count */
+        Color,          /** Mean point color, opacity from the normalized count */
+    };
+
+public:
+
+    /**
+     * Aggregate \p positions into a \p width x \p height pixel grid which covers \p bounds (points outside the bounds are ignored)
+     * @param positions Point positions
+     * @param bounds Data bounds covered by the grid
+     * @param width Number of pixels along the x-axis
+     * @param height Number of pixels along the y-axis
+     * @param scalars Optional per-point color scalars (same size as \p positions)
+     * @param colors Optional per-point colors as 0xRRGGBB (same size as \p positions)
+     * @param aggregate Pixel aggregate to populate
+     */
+    static void aggregate(const std::vector<Vector2f>& positions, const Bounds& bounds, const std::uint32_t& width, const std::uint32_t& height, const std::vector<float>* scalars, const std::vector<std::uint32_t>* colors, PixelAggregate& aggregate);
+
+    /**
+     * Shade \p aggregate into an image (empty pixels are transparent)
+     * @param aggregate Pixel aggregate
+     * @param shading What determines the pixel colors (falls back to the count when the aggregate lacks scalars/colors)
+     * @param normalization Mapping of pixel counts to the [0, 1] range
+     * @param colorMapImage Color map image (sampled along the center row)
+     * @param colorMapRange Scalar range of the color map (scalar shading only)
+     * @return Image of the aggregate size
+     */
+    static QImage shade(const PixelAggregate& aggregate, Shading shading, const Normalization& normalization, const QImage& colorMapImage, const Vector3f& colorMapRange);
+
+public:
+    static constexpr float          MINIMUM_ALPHA       = 0.2f;                 /** Opacity of pixels with the lowest (non-zero) count */
+    static constexpr std::size_t    MEMORY_BUDGET       = 256 * 1024 * 1024;    /** Maximum size (in bytes) of the private grids of all tasks */
+};
@@ -11,14 +11,20 @@ using namespace hdps::gui;
 PlotAction::PlotAction(ViewerScatterplotPlugin* viewerscatterplotPlugin) :
     PluginAction(viewerscatterplotPlugin, viewerscatterplotPlugin, "Plot"),
     _pointPlotAction(this, viewerscatterplotPlugin),
-    _densityPlotAction(this, viewerscatterplotPlugin)
+    _densityPlotAction(this, viewerscatterplotPlugin),
+    _aggregatePlotAction(this, viewerscatterplotPlugin),
+    _shadedPlotAction(this, viewerscatterplotPlugin)
 {
     setIcon(hdps::Application::getIconFont("FontAwesome").getIcon("paint-brush"));
     _pointPlotAction._sizeAction.getSourceAction().setVisible(false);
     _pointPlotAction._opacityAction.getSourceAction().setVisible(false);
     const auto updateRenderMode = [this]() -> void {
-        _pointPlotAction.setVisible(getViewerScatterplotWidget().getRenderMode() == ViewerScatterplotWidget::SCATTERPLOT);
-        _densityPlotAction.setVisible(getViewerScatterplotWidget().getRenderMode() != ViewerScatterplotWidget::SCATTERPLOT);
+        const auto renderMode = getViewerScatterplotWidget().getRenderMode();
+
+        _pointPlotAction.setVisible(renderMode == ViewerScatterplotWidget::SCATTERPLOT);
+        _densityPlotAction.setVisible(renderMode == ViewerScatterplotWidget::DENSITY || renderMode == ViewerScatterplotWidget::LANDSCAPE);
+        _aggregatePlotAction.setVisible(renderMode == ViewerScatterplotWidget::BINNED);
+        _shadedPlotAction.setVisible(renderMode == ViewerScatterplotWidget::SHADED);
     };
 
     connect(&getViewerScatterplotWidget(), &ViewerScatterplotWidget::renderModeChanged, this, [this, updateRenderMode](const ViewerScatterplotWidget::RenderMode& renderMode) {
@@ -41,6 +47,14 @@ QMenu* PlotAction::getContextMenu()
             return _densityPlotAction.getContextMenu();
             break;
 
+        case ViewerScatterplotWidget::RenderMode::BINNED:
+            return _aggregatePlotAction.getContextMenu();
+            break;
+
+        case ViewerScatterplotWidget::RenderMode::SHADED:
+            return _shadedPlotAction.getContextMenu();
+            break;
+
         default:
             break;
     }
@@ -54,6 +68,8 @@ void PlotAction::fromVariantMap(const QVariantMap& variantMap)
 
     _pointPlotAction.fromParentVariantMap(variantMap);
     _densityPlotAction.fromParentVariantMap(variantMap);
+    _aggregatePlotAction.fromParentVariantMap(variantMap);
+    _shadedPlotAction.fromParentVariantMap(variantMap);
 }
 
 QVariantMap PlotAction::toVariantMap() const
@@ -62,6 +78,8 @@ QVariantMap PlotAction::toVariantMap() const
 
     _pointPlotAction.insertIntoVariantMap(variantMap);
     _densityPlotAction.insertIntoVariantMap(variantMap);
+    _aggregatePlotAction.insertIntoVariantMap(variantMap);
+    _shadedPlotAction.insertIntoVariantMap(variantMap);
 
     return variantMap;
 }
@@ -71,36 +89,48 @@ PlotAction::Widget::Widget(QWidget* parent, PlotAction* plotAction, const std::i
 {
     QWidget* pointPlotWidget    = nullptr;
     QWidget* densityPlotWidget  = nullptr;
+    QWidget* aggregatePlotWidget = nullptr;
+    QWidget* shadedPlotWidget   = nullptr;
 
     if (widgetFlags & PopupLayout) {
         pointPlotWidget     = plotAction->_pointPlotAction.createWidget(this, WidgetActionWidget::PopupLayout);
         densityPlotWidget   = plotAction->_densityPlotAction.createWidget(this, WidgetActionWidget::PopupLayout);
+        aggregatePlotWidget = plotAction->_aggregatePlotAction.createWidget(this, WidgetActionWidget::PopupLayout);
+        shadedPlotWidget    = plotAction->_shadedPlotAction.createWidget(this, WidgetActionWidget::PopupLayout);
 
         auto layout = new QVBoxLayout();
 
         layout->addWidget(pointPlotWidget);
         layout->addWidget(densityPlotWidget);
+        layout->addWidget(aggregatePlotWidget);
+        layout->addWidget(shadedPlotWidget);
 
         setPopupLayout(layout);
     }
     else {
         pointPlotWidget = plotAction->_pointPlotAction.createWidget(this);
         densityPlotWidget = plotAction->_densityPlotAction.createWidget(this);
+        aggregatePlotWidget = plotAction->_aggregatePlotAction.createWidget(this);
+        shadedPlotWidget = plotAction->_shadedPlotAction.createWidget(this);
 
         auto layout = new QHBoxLayout();
 
         layout->setContentsMargins(0, 0, 0, 0);
         layout->addWidget(pointPlotWidget);
         layout->addWidget(densityPlotWidget);
+        layout->addWidget(aggregatePlotWidget);
+        layout->addWidget(shadedPlotWidget);
 
         setLayout(layout);
     }
 
-    const auto updateRenderMode = [plotAction, pointPlotWidget, densityPlotWidget]() -> void {
+    const auto updateRenderMode = [plotAction, pointPlotWidget, densityPlotWidget, aggregatePlotWidget, shadedPlotWidget]() -> void {
         const auto renderMode = plotAction->getViewerScatterplotWidget().getRenderMode();
 
         pointPlotWidget->setVisible(renderMode == ViewerScatterplotWidget::RenderMode::SCATTERPLOT);
-        densityPlotWidget->setVisible(renderMode != ViewerScatterplotWidget::RenderMode::SCATTERPLOT);
+        densityPlotWidget->setVisible(renderMode == ViewerScatterplotWidget::RenderMode::DENSITY || renderMode == ViewerScatterplotWidget::RenderMode::LANDSCAPE);
+        aggregatePlotWidget->setVisible(renderMode == ViewerScatterplotWidget::RenderMode::BINNED);
+        shadedPlotWidget->setVisible(renderMode == ViewerScatterplotWidget::RenderMode::SHADED);
     };
 
     connect(&plotAction->getViewerScatterplotWidget(), &ViewerScatterplotWidget::renderModeChanged, this, [this, updateRenderMode](const ViewerScatterplotWidget::RenderMode& renderMode) {
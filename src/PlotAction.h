@@ -3,6 +3,8 @@
 #include "PluginAction.h"
 #include "PointPlotAction.h"
 #include "DensityPlotAction.h"
+#include "AggregatePlotAction.h"
+#include "ShadedPlotAction.h"
 
 using namespace hdps::gui;
 
@@ -42,10 +44,14 @@ public: // Action getters
 
     PointPlotAction& getPointPlotAction() { return _pointPlotAction; }
     DensityPlotAction& getDensityPlotAction() { return _densityPlotAction; }
+    AggregatePlotAction& getAggregatePlotAction() { return _aggregatePlotAction; }
+    ShadedPlotAction& getShadedPlotAction() { return _shadedPlotAction; }
 
 protected:
     PointPlotAction     _pointPlotAction;
     DensityPlotAction   _densityPlotAction;
+    AggregatePlotAction _aggregatePlotAction;
+    ShadedPlotAction    _shadedPlotAction;
 
     friend class Widget;
 };
\ No newline at end of file
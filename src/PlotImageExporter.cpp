@@ -0,0 +1,542 @@
+#include "PlotImageExporter.h"
+#include "ViewerScatterplotWidget.h"
+#include "StreamingPngWriter.h"
+
+#include "util/Exception.h"
+
+#include <QPdfWriter>
+#include <QSvgGenerator>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+PlotImageExporter::PlotImageExporter(ViewerScatterplotWidget& viewerScatterplotWidget) :
+    _viewerScatterplotWidget(viewerScatterplotWidget)
+{
+}
+
+void PlotImageExporter::init()
+{
+    initializeOpenGLFunctions();
+
+    _imageReadback.init();
+
+    _isInitialized = true;
+}
+
+void PlotImageExporter::destroy()
+{
+    if (!_isInitialized)
+        return;
+
+    _imageReadback.destroy();
+    _imageFramebuffer.reset();
+    _tileFramebuffer.reset();
+
+    _isInitialized = false;
+}
+
+bool PlotImageExporter::createScreenshot(std::int32_t width, std::int32_t height, const QString& fileName, const QColor& backgroundColor, bool offscreen /*= false*/)
+{
+    // Exit prematurely if the file name is invalid
+    if (fileName.isEmpty())
+        return false;
+
+    // Large images are rendered in bands and streamed to disk
+    if (std::max(width, height) > MAXIMUM_SCREENSHOT_SIZE && fileName.endsWith(".png", Qt::CaseInsensitive))
+        return exportTiledImage(width, height, fileName, backgroundColor, offscreen);
+
+    const auto image = renderImage(width, height, backgroundColor, offscreen);
+
+    if (image.isNull())
+        return false;
+
+    return image.save(fileName);
+}
+
+QImage PlotImageExporter::renderImage(std::int32_t width, std::int32_t height, const QColor& backgroundColor, bool offscreen /*= false*/)
+{
+    // The image would be taken after the pending ones
+    if (getNumberOfRequestedImages() > 0)
+        return QImage();
+
+    if (!requestImage(width, height, backgroundColor, offscreen))
+        return QImage();
+
+    return takeRequestedImage();
+}
+
+bool PlotImageExporter::requestImage(std::int32_t width, std::int32_t height, const QColor& backgroundColor, bool offscreen /*= false*/)
+{
+    if (width <= 0 || height <= 0)
+        return false;
+
+    auto& widget = _viewerScatterplotWidget;
+
+    // Without an OpenGL context the plot can only be rendered with the CPU backends
+    offscreen = offscreen || !_isInitialized || !widget._isInitialized;
+
+    const auto isCpuPointRendering      = widget._renderMode == ViewerScatterplotWidget::SCATTERPLOT && (offscreen || widget._pointBackend == ViewerScatterplotWidget::PointBackend::CPU);
+    const auto isCpuDensityRendering    = widget.isDensityRenderMode() && (offscreen || widget._densityBackend == ViewerScatterplotWidget::DensityBackend::CPU);
+
+    // The CPU density, the CPU points and the aggregate bins are drawn without OpenGL (the image is complete right away)
+    if (isCpuPointRendering || isCpuDensityRendering || widget._renderMode == ViewerScatterplotWidget::BINNED || widget._renderMode == ViewerScatterplotWidget::SHADED) {
+        prepareImage(QSize(width, height), offscreen);
+
+        _imageReadback.push(renderImageBand(QSize(width, height), QRect(0, 0, width, height), backgroundColor));
+
+        return true;
+    }
+
+    // All pixel buffers hold images which were not taken yet
+    if (!_imageReadback.canRead())
+        return false;
+
+    auto requested = false;
+
+    widget.makeCurrent();
+
+    // The density might not have been computed yet (e.g. when the widget is hidden)
+    widget.updateDensity();
+
+    try {
+
+        // Reuse the framebuffer of the previous image when it has the same size
+        if (!_imageFramebuffer || _imageFramebuffer->size() != QSize(width, height)) {
+
+            // Use custom FBO format
+            QOpenGLFramebufferObjectFormat fboFormat;
+
+            fboFormat.setTextureTarget(GL_TEXTURE_2D);
+            fboFormat.setInternalTextureFormat(GL_RGB);
+
+            _imageFramebuffer = std::make_unique<QOpenGLFramebufferObject>(width, height, fboFormat);
+        }
+
+        // Bind the FBO and render into it when successfully bound
+        if (_imageFramebuffer->bind()) {
+
+            // Clear the widget to the background color
+            glClearColor(backgroundColor.redF(), backgroundColor.greenF(), backgroundColor.blueF(), backgroundColor.alphaF());
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            // Reset the blending function
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+            // Resize OpenGL to intended screenshot size
+            widget.resizeGL(width, height);
+
+            switch (widget._renderMode)
+            {
+                case ViewerScatterplotWidget::SCATTERPLOT:
+                {
+                    widget._pointRenderer.render(widget._softwarePointSettings, QSize(width, height), QRectF(widget.getDataRectangle(QSize(width, height))), getImagePointScale(QSize(width, height)));
+
+                    break;
+                }
+
+                case ViewerScatterplotWidget::DENSITY:
+                case ViewerScatterplotWidget::LANDSCAPE:
+                    widget._densityRenderer.setRenderMode(widget._renderMode == ViewerScatterplotWidget::DENSITY ? DensityRenderer::DENSITY : DensityRenderer::LANDSCAPE);
+                    widget._densityRenderer.render();
+                    break;
+
+                default:
+                    break;
+            }
+
+            // Start reading back the FBO image (it is transferred while the next image is rendered)
+            requested = _imageReadback.read(width, height);
+
+            // Resize OpenGL back to original OpenGL widget size
+            widget.resizeGL(widget.width(), widget.height());
+
+            _imageFramebuffer->release();
+        }
+    }
+    catch (std::exception& e)
+    {
+        exceptionMessageBox("Rendering failed", e);
+    }
+    catch (...) {
+        exceptionMessageBox("Rendering failed");
+    }
+
+    return requested;
+}
+
+QImage PlotImageExporter::takeRequestedImage()
+{
+    // Read back images require the OpenGL context
+    if (_viewerScatterplotWidget._isInitialized)
+        _viewerScatterplotWidget.makeCurrent();
+
+    return _imageReadback.take();
+}
+
+std::size_t PlotImageExporter::getNumberOfRequestedImages() const
+{
+    return _imageReadback.getNumberOfPendingImages();
+}
+
+bool PlotImageExporter::exportTiledImage(std::int32_t width, std::int32_t height, const QString& fileName, const QColor& backgroundColor, bool offscreen /*= false*/)
+{
+    if (width <= 0 || height <= 0)
+        return false;
+
+    StreamingPngWriter pngWriter;
+
+    if (!pngWriter.open(fileName, static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height)))
+        return false;
+
+    auto& widget = _viewerScatterplotWidget;
+
+    // Without an OpenGL context the plot can only be rendered with the CPU backends
+    offscreen = offscreen || !_isInitialized || !widget._isInitialized;
+
+    // The points of the OpenGL point backend are rendered in tiles (the points would be rendered differently by the CPU backend)
+    if (!offscreen && widget._renderMode == ViewerScatterplotWidget::SCATTERPLOT && widget._pointBackend == ViewerScatterplotWidget::PointBackend::GPU)
+        return writePointTiles(pngWriter, QSize(width, height), backgroundColor) && pngWriter.close();
+
+    prepareImage(QSize(width, height), offscreen);
+
+    // Bound the memory of a band, regardless of the image size
+    const auto bandHeight = std::max(1, std::min(height, static_cast<std::int32_t>(MAXIMUM_BAND_SIZE / width)));
+
+    for (std::int32_t bandTop = 0; bandTop < height; bandTop += bandHeight)
+        if (!pngWriter.writeRows(renderImageBand(QSize(width, height), QRect(0, bandTop, width, std::min(bandHeight, height - bandTop)), backgroundColor)))
+            return false;
+
+    return pngWriter.close();
+}
+
+bool PlotImageExporter::exportVectorImage(std::int32_t width, std::int32_t height, const QString& fileName, const QColor& backgroundColor, const std::uint32_t& maximumNumberOfVectorPoints)
+{
+    if (width <= 0 || height <= 0)
+        return false;
+
+    auto& widget = _viewerScatterplotWidget;
+
+    const QSize imageSize(width, height);
+
+    // Create the paint device for the file type
+    std::unique_ptr<QPaintDevice> paintDevice;
+
+    if (fileName.endsWith(".svg", Qt::CaseInsensitive)) {
+        auto svgGenerator = std::make_unique<QSvgGenerator>();
+
+        svgGenerator->setFileName(fileName);
+        svgGenerator->setSize(imageSize);
+        svgGenerator->setViewBox(QRect(QPoint(0, 0), imageSize));
+
+        paintDevice = std::move(svgGenerator);
+    }
+    else if (fileName.endsWith(".pdf", Qt::CaseInsensitive)) {
+        auto pdfWriter = std::make_unique<QPdfWriter>(fileName);
+
+        // One point per pixel, the page is the image
+        pdfWriter->setResolution(72);
+        pdfWriter->setPageSize(QPageSize(QSizeF(width, height), QPageSize::Point));
+        pdfWriter->setPageMargins(QMarginsF());
+
+        paintDevice = std::move(pdfWriter);
+    }
+    else {
+        return false;
+    }
+
+    prepareImage(imageSize, !_isInitialized);
+
+    QPainter painter;
+
+    if (!painter.begin(paintDevice.get()))
+        return false;
+
+    painter.fillRect(QRect(QPoint(0, 0), imageSize), backgroundColor);
+
+    const auto numberOfPoints = widget._positions != nullptr ? widget._positions->size() : 0;
+
+    if (widget._renderMode == ViewerScatterplotWidget::SCATTERPLOT && numberOfPoints <= maximumNumberOfVectorPoints) {
+        SoftwarePointRenderer::paint(widget.getSoftwarePoints(), widget._softwarePointSettings, painter, widget.getDataRectangle(imageSize), getImagePointScale(imageSize));
+    }
+    else {
+
+        // Aggregated geometry: bins and contours are vector paths, the points and densities are embedded as an image
+        drawImageRegion(painter, imageSize, QRect(QPoint(0, 0), imageSize));
+
+        // Keep the selection crisp, as long as the number of selected points does not blow up the file size
+        const auto numberOfSelectedPoints = widget._pointHighlights != nullptr ? static_cast<std::size_t>(std::count_if(widget._pointHighlights->begin(), widget._pointHighlights->end(), [](const char& highlight) -> bool {
+            return highlight != 0;
+        })) : 0;
+
+        if (widget._renderMode == ViewerScatterplotWidget::SCATTERPLOT && numberOfSelectedPoints <= maximumNumberOfVectorPoints)
+            SoftwarePointRenderer::paint(widget.getSoftwarePoints(), widget._softwarePointSettings, painter, widget.getDataRectangle(imageSize), getImagePointScale(imageSize), true);
+    }
+
+    return painter.end();
+}
+
+QImage PlotImageExporter::renderImageBand(const QSize& imageSize, const QRect& band, const QColor& backgroundColor)
+{
+    QImage image(band.size(), QImage::Format_ARGB32);
+
+    image.fill(backgroundColor);
+
+    QPainter painter(&image);
+
+    // Draw in image coordinates
+    painter.translate(-band.topLeft());
+
+    drawImageRegion(painter, imageSize, band);
+
+    painter.end();
+
+    return image;
+}
+
+void PlotImageExporter::prepareImage(const QSize& imageSize, bool offscreen)
+{
+    auto& widget = _viewerScatterplotWidget;
+
+    _densityImage = QImage();
+
+    // The image should show the latest CPU density
+    if (widget._densityBackend == ViewerScatterplotWidget::DensityBackend::CPU) {
+        widget.updateDensity();
+        widget._densityComputation.waitForFinished();
+        return;
+    }
+
+    if (!widget.isDensityRenderMode())
+        return;
+
+    // Render the density with the density renderer, at the resolution of the data rectangle (within the screen shot size)
+    if (!offscreen) {
+        _densityImage = renderDensityImage(std::min(widget.getDataRectangle(imageSize).width(), MAXIMUM_SCREENSHOT_SIZE));
+
+        if (!_densityImage.isNull())
+            return;
+    }
+
+    // Without OpenGL the density can only be estimated on the CPU (once per image, not per band)
+    const auto densityGrid      = widget.getDensityGrid();
+    const auto minimumDensity   = std::min(0.0f, densityGrid->getMinimum());
+
+    _densityImage = widget.createDensityImage(*densityGrid, Vector3f(minimumDensity, densityGrid->getMaximum(), densityGrid->getMaximum() - minimumDensity));
+}
+
+void PlotImageExporter::drawImageRegion(QPainter& painter, const QSize& imageSize, const QRect& region)
+{
+    auto& widget = _viewerScatterplotWidget;
+
+    switch (widget._renderMode)
+    {
+        case ViewerScatterplotWidget::SCATTERPLOT:
+            widget.drawSoftwarePoints(painter, imageSize, region, getImagePointScale(imageSize));
+            break;
+
+        case ViewerScatterplotWidget::DENSITY:
+        case ViewerScatterplotWidget::LANDSCAPE:
+        {
+            if (widget._densityBackend == ViewerScatterplotWidget::DensityBackend::CPU) {
+                widget.drawDensityImage(painter, imageSize);
+                widget.drawContours(painter, imageSize);
+                break;
+            }
+
+            // Draw the density which was prepared for the image in place of the density renderer output
+            if (_densityImage.isNull())
+                break;
+
+            painter.setRenderHint(QPainter::SmoothPixmapTransform);
+            painter.drawImage(widget.getDataRectangle(imageSize), _densityImage);
+            break;
+        }
+
+        case ViewerScatterplotWidget::BINNED:
+            widget.drawBins(painter, imageSize);
+            break;
+
+        case ViewerScatterplotWidget::SHADED:
+            widget.drawShadedImage(painter, imageSize);
+            break;
+    }
+}
+
+bool PlotImageExporter::writePointTiles(StreamingPngWriter& pngWriter, const QSize& imageSize, const QColor& backgroundColor)
+{
+    auto& widget = _viewerScatterplotWidget;
+
+    // The tiles are read back through the pixel buffers of the requested images
+    if (getNumberOfRequestedImages() > 0)
+        return false;
+
+    // Bands are one tile high, so the tiles are as large as the band memory allows (larger tiles render the points fewer times)
+    const auto tileSize         = std::clamp(MAXIMUM_BAND_SIZE / imageSize.width(), MINIMUM_TILE_SIZE, MAXIMUM_SCREENSHOT_SIZE);
+    const auto dataRectangle    = widget.getDataRectangle(imageSize);
+    const auto pointScale       = getImagePointScale(imageSize);
+
+    QImage band;
+
+    // Positions of the tiles which are read back but not copied into the band yet
+    std::deque<QPoint> pendingTiles;
+
+    // Copy the oldest tile which is read back into the band (clipped to the band)
+    const auto takeTile = [this, &band, &pendingTiles]() -> bool {
+        const auto tileImage    = _imageReadback.take();
+        const auto tileTopLeft  = pendingTiles.front();
+
+        pendingTiles.pop_front();
+
+        if (tileImage.isNull())
+            return false;
+
+        QPainter painter(&band);
+
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.drawImage(tileTopLeft.x(), 0, tileImage);
+
+        return true;
+    };
+
+    auto written = false;
+
+    widget.makeCurrent();
+
+    try {
+
+        // Reuse the framebuffer of the previous tiled export when the tiles have the same size
+        if (!_tileFramebuffer || _tileFramebuffer->size() != QSize(tileSize, tileSize)) {
+            QOpenGLFramebufferObjectFormat fboFormat;
+
+            fboFormat.setTextureTarget(GL_TEXTURE_2D);
+            fboFormat.setInternalTextureFormat(GL_RGB);
+
+            _tileFramebuffer = std::make_unique<QOpenGLFramebufferObject>(tileSize, tileSize, fboFormat);
+        }
+
+        written = true;
+
+        for (std::int32_t bandTop = 0; written && bandTop < imageSize.height(); bandTop += tileSize) {
+            band = QImage(imageSize.width(), std::min(tileSize, imageSize.height() - bandTop), QImage::Format_ARGB32);
+
+            for (std::int32_t tileLeft = 0; written && tileLeft < imageSize.width(); tileLeft += tileSize) {
+                if (!_tileFramebuffer->bind()) {
+                    written = false;
+                    break;
+                }
+
+                glClearColor(backgroundColor.redF(), backgroundColor.greenF(), backgroundColor.blueF(), backgroundColor.alphaF());
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+                glEnable(GL_BLEND);
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+                // The tile shows its part of the data rectangle, with the point sizes of the complete image
+                widget._pointRenderer.render(widget._softwarePointSettings, QSize(tileSize, tileSize), QRectF(dataRectangle.translated(-tileLeft, -bandTop)), pointScale);
+
+                // Start reading back the tile (it is transferred while the next tile is rendered)
+                if (_imageReadback.read(tileSize, tileSize))
+                    pendingTiles.push_back(QPoint(tileLeft, bandTop));
+                else
+                    written = false;
+
+                _tileFramebuffer->release();
+
+                // Free a pixel buffer for the next tile
+                if (written && !_imageReadback.canRead())
+                    written = takeTile();
+            }
+
+            while (written && !pendingTiles.empty())
+                written = takeTile();
+
+            written = written && pngWriter.writeRows(band);
+        }
+    }
+    catch (std::exception& e)
+    {
+        exceptionMessageBox("Rendering failed", e);
+
+        written = false;
+    }
+    catch (...) {
+        exceptionMessageBox("Rendering failed");
+
+        written = false;
+    }
+
+    // Discard the tiles of a failed export
+    while (!pendingTiles.empty()) {
+        _imageReadback.take();
+        pendingTiles.pop_front();
+    }
+
+    return written;
+}
+
+QImage PlotImageExporter::renderDensityImage(const std::int32_t& size)
+{
+    auto& widget = _viewerScatterplotWidget;
+
+    if (!_isInitialized || !widget._isInitialized || size <= 0)
+        return QImage();
+
+    QImage densityImage;
+
+    widget.makeCurrent();
+
+    // The density might not have been computed yet (the density renderer binds its own framebuffer while it computes)
+    widget.updateDensity();
+
+    try {
+        QOpenGLFramebufferObjectFormat fboFormat;
+
+        fboFormat.setTextureTarget(GL_TEXTURE_2D);
+        fboFormat.setInternalTextureFormat(GL_RGBA8);
+
+        QOpenGLFramebufferObject densityFramebuffer(size, size, fboFormat);
+
+        if (densityFramebuffer.bind()) {
+            glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            // Blend the alpha separately, so that the image holds premultiplied colors which are drawn over the background
+            glEnable(GL_BLEND);
+            glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+            // The square viewport is covered by the data bounds
+            widget.resizeGL(size, size);
+
+            widget._densityRenderer.setRenderMode(widget._renderMode == ViewerScatterplotWidget::DENSITY ? DensityRenderer::DENSITY : DensityRenderer::LANDSCAPE);
+            widget._densityRenderer.render();
+
+            densityImage = densityFramebuffer.toImage();
+
+            widget.resizeGL(widget.width(), widget.height());
+
+            densityFramebuffer.release();
+        }
+
+        // Reset the blending function
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+    catch (std::exception& e)
+    {
+        exceptionMessageBox("Rendering failed", e);
+    }
+    catch (...) {
+        exceptionMessageBox("Rendering failed");
+    }
+
+    return densityImage;
+}
+
+float PlotImageExporter::getImagePointScale(const QSize& imageSize) const
+{
+    const auto widgetSize = std::min(_viewerScatterplotWidget.width(), _viewerScatterplotWidget.height());
+
+    return widgetSize > 0 ? static_cast<float>(std::min(imageSize.width(), imageSize.height())) / static_cast<float>(widgetSize) : 1.0f;
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "ImageReadback.h"
+
+#include <QOpenGLFunctions_3_3_Core>
+#include <QOpenGLFramebufferObject>
+#include <QColor>
+#include <QImage>
+#include <QPainter>
+#include <QRect>
+#include <QSize>
+#include <QString>
+
+#include <cstdint>
+#include <memory>
+
+class ViewerScatterplotWidget;
+class StreamingPngWriter;
+
+/**
+ * Plot image exporter class
+ *
+ * Renders the current plot state of a scatterplot widget into images and files: single images (read back
+ * asynchronously with OpenGL, or rendered with the CPU backends), PNG images which are too large for one piece
+ * (rendered in bands and streamed to disk) and vector images (SVG and PDF). The density of the GPU density backend
+ * is rendered by the density renderer for images which are drawn with a painter, so it is never estimated on the
+ * CPU unless the image is rendered offscreen.
+ */
+class PlotImageExporter : protected QOpenGLFunctions_3_3_Core
+{
+public:
+
+    /**
+     * Constructor
+     * @param viewerScatterplotWidget Reference to the widget of which the plot is exported
+     */
+    PlotImageExporter(ViewerScatterplotWidget& viewerScatterplotWidget);
+
+    /** Initialize the OpenGL functions and the image readback (requires the current OpenGL context of the widget) */
+    void init();
+
+    /** Release the OpenGL resources (requires the OpenGL context of init) */
+    void destroy();
+
+    /**
+     * Create screenshot
+     * @param width Width of the screen shot (in pixels)
+     * @param height Height of the screen shot (in pixels)
+     * @param fileName File name of the screen shot
+     * @param backgroundColor Background color of the screen shot
+     * @param offscreen Whether to render without OpenGL (see renderImage)
+     * @return Whether the screen shot was saved
+     *
+     * PNG screen shots larger than MAXIMUM_SCREENSHOT_SIZE along either axis are exported tiled (see exportTiledImage).
+     */
+    bool createScreenshot(std::int32_t width, std::int32_t height, const QString& fileName, const QColor& backgroundColor, bool offscreen = false);
+
+    /**
+     * Render the current plot state into an image. Offscreen rendering uses the CPU backends (the software point
+     * renderer and the CPU density), so it needs neither an OpenGL context nor a visible widget and the resolution
+     * is only limited by memory. It is used regardless of \p offscreen when OpenGL is not initialized.
+     * @param width Width of the image (in pixels)
+     * @param height Height of the image (in pixels)
+     * @param backgroundColor Background color of the image
+     * @param offscreen Whether to render without OpenGL
+     * @return Rendered image (null when rendering failed or requested images are pending)
+     */
+    QImage renderImage(std::int32_t width, std::int32_t height, const QColor& backgroundColor, bool offscreen = false);
+
+    /**
+     * Request an image of the current plot state (see renderImage). With OpenGL, the image is rendered and its readback is
+     * started, but not waited for, so that the next image can be rendered while it is transferred. Requested images are
+     * taken in the order they were requested and at most ImageReadback::NUMBER_OF_PIXEL_BUFFERS OpenGL images can be pending.
+     * @param width Width of the image (in pixels)
+     * @param height Height of the image (in pixels)
+     * @param backgroundColor Background color of the image
+     * @param offscreen Whether to render without OpenGL
+     * @return Whether the image was requested
+     */
+    bool requestImage(std::int32_t width, std::int32_t height, const QColor& backgroundColor, bool offscreen = false);
+
+    /**
+     * Take the oldest requested image (waits for its readback)
+     * @return Rendered image (null when rendering or the readback failed)
+     */
+    QImage takeRequestedImage();
+
+    /** Get the number of requested images which were not taken yet */
+    std::size_t getNumberOfRequestedImages() const;
+
+    /**
+     * Render the current plot state in bands of rows and stream the bands into a PNG file, so that the memory use is
+     * bounded regardless of the image size (e.g. poster size exports). The points of the OpenGL point backend are rendered
+     * in tiles with OpenGL, unless the image is rendered offscreen (with the CPU backends).
+     * @param width Width of the image (in pixels)
+     * @param height Height of the image (in pixels)
+     * @param fileName File name of the PNG image
+     * @param backgroundColor Background color of the image
+     * @param offscreen Whether to render without OpenGL
+     * @return Whether the image was saved
+     */
+    bool exportTiledImage(std::int32_t width, std::int32_t height, const QString& fileName, const QColor& backgroundColor, bool offscreen = false);
+
+    /**
+     * Export the current plot state as a vector image (SVG or PDF, depending on the file name extension)
+     *
+     * Up to \p maximumNumberOfVectorPoints points are exported as vector shapes. Above it the points are aggregated (rendered
+     * into an embedded image) with vector selection outlines and contours on top, so that the file size remains bounded.
+     * @param width Width of the image (in pixels, points in a PDF)
+     * @param height Height of the image (in pixels, points in a PDF)
+     * @param fileName File name of the SVG or PDF file
+     * @param backgroundColor Background color of the image
+     * @param maximumNumberOfVectorPoints Maximum number of points which are exported as vector shapes
+     * @return Whether the image was saved
+     */
+    bool exportVectorImage(std::int32_t width, std::int32_t height, const QString& fileName, const QColor& backgroundColor, const std::uint32_t& maximumNumberOfVectorPoints);
+
+    /**
+     * Render a band of an image of the current plot state with the painter (see prepareImage)
+     * @param imageSize Size of the complete image
+     * @param band Part of the image which is rendered
+     * @param backgroundColor Background color of the image
+     * @return Image of the band
+     */
+    QImage renderImageBand(const QSize& imageSize, const QRect& band, const QColor& backgroundColor);
+
+protected:
+
+    /**
+     * Prepare drawing images of the current plot state with the painter: wait for the latest CPU density, or render the
+     * density of the GPU density backend with the density renderer (the CPU density is only estimated offscreen)
+     * @param imageSize Size of the complete image
+     * @param offscreen Whether the image is rendered without OpenGL
+     */
+    void prepareImage(const QSize& imageSize, bool offscreen);
+
+    /**
+     * Draw (a region of) an image of the current plot state with the painter (see prepareImage)
+     * @param painter Painter to draw with (in image coordinates)
+     * @param imageSize Size of the complete image
+     * @param region Part of the image which is drawn
+     */
+    void drawImageRegion(QPainter& painter, const QSize& imageSize, const QRect& region);
+
+    /**
+     * Render the points with the point renderer in square tiles (one tile high bands) and stream the bands into a PNG file,
+     * each tile covers its part of the data rectangle and is read back while the next tile is rendered
+     * @param pngWriter PNG writer of the image (opened with the image size)
+     * @param imageSize Size of the complete image
+     * @param backgroundColor Background color of the image
+     * @return Whether all bands were written
+     */
+    bool writePointTiles(StreamingPngWriter& pngWriter, const QSize& imageSize, const QColor& backgroundColor);
+
+    /**
+     * Render the density of the density renderer into a premultiplied image which covers the data bounds
+     * @param size Width and height of the image (in pixels)
+     * @return Density image (null when it could not be rendered)
+     */
+    QImage renderDensityImage(const std::int32_t& size);
+
+    /**
+     * Get the point size factor of an image, relative to the widget size (the point sizes of the widget do not depend on its size)
+     * @param imageSize Size of the image
+     * @return Point size factor
+     */
+    float getImagePointScale(const QSize& imageSize) const;
+
+protected:
+    ViewerScatterplotWidget&                    _viewerScatterplotWidget;   /** Reference to the widget of which the plot is exported */
+    ImageReadback                               _imageReadback;             /** Asynchronous readback of requested images */
+    std::unique_ptr<QOpenGLFramebufferObject>   _imageFramebuffer;          /** Framebuffer of requested images (reused while the size does not change) */
+    std::unique_ptr<QOpenGLFramebufferObject>   _tileFramebuffer;           /** Framebuffer of the tiles of tiled exports (reused while the tile size does not change) */
+    QImage                                      _densityImage;              /** Density of the GPU density backend for images which are drawn with the painter */
+    bool                                        _isInitialized = false;     /** Whether the OpenGL functions were initialized */
+
+    static constexpr std::int32_t   MAXIMUM_BAND_SIZE = 16 * 1024 * 1024;   /** Maximum number of pixels of a band of a tiled export */
+    static constexpr std::int32_t   MINIMUM_TILE_SIZE = 1024;               /** Smallest OpenGL tile width/height (each tile renders all points) */
+
+public:
+    static constexpr std::int32_t   MAXIMUM_SCREENSHOT_SIZE = 4096;         /** Largest screen shot width/height which is rendered in one piece */
+};
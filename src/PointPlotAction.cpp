@@ -7,15 +7,16 @@
 #include "ViewerScatterplotWidget.h"
 #include "DataHierarchyItem.h"
 
+#include <algorithm>
+
 using namespace gui;
 
 PointPlotAction::PointPlotAction(PlotAction* plotAction, ViewerScatterplotPlugin* viewerscatterplotPlugin) :
     PluginAction(plotAction, viewerscatterplotPlugin, "Point"),
     _sizeAction(this, viewerscatterplotPlugin, "Point size", 0.0, 100.0, DEFAULT_POINT_SIZE, DEFAULT_POINT_SIZE),
     _opacityAction(this, viewerscatterplotPlugin, "Point opacity", 0.0, 100.0, DEFAULT_POINT_OPACITY, DEFAULT_POINT_OPACITY),
-    _pointSizeScalars(),
-    _pointOpacityScalars(),
     _focusSelection(this, "Focus selection"),
+    _cpuRenderingAction(this, "CPU", false, false),
     _lastOpacitySourceIndex(-1)
 {
     setSerializationName("PointPlot");
@@ -55,6 +56,11 @@ PointPlotAction::PointPlotAction(PlotAction* plotAction, ViewerScatterplotPlugin
     _opacityAction.getSourceAction().getOffsetAction().setSuffix("%");
 
     _focusSelection.setToolTip("Put focus on selected points by modulating the point opacity");
+    _cpuRenderingAction.setToolTip("Render the points on the CPU (for environments without hardware OpenGL)");
+
+    _cpuRenderingAction.setSerializationName("CPURendering");
+
+    _viewerscatterplotPlugin->getWidget().addAction(&_cpuRenderingAction);
 
     // Update size by action when the position dataset changes
     connect(&_viewerscatterplotPlugin->getPositionDataset(), &Dataset<Points>::changed, this, [this]() {
@@ -89,8 +95,10 @@ PointPlotAction::PointPlotAction(PlotAction* plotAction, ViewerScatterplotPlugin
         updateDefaultDatasets();
 
         // Reset the point size and opacity scalars
-        updateScatterPlotWidgetPointSizeScalars();
-        updateScatterPlotWidgetPointOpacityScalars();
+        _pointSizeSourceScalars._stale      = true;
+        _pointOpacitySourceScalars._stale   = true;
+
+        _viewerscatterplotPlugin->getUpdateScheduler().markDirty(UpdateScheduler::Buffer::PointSizes | UpdateScheduler::Buffer::PointOpacities);
 
         // Reset
         _sizeAction.getSourceAction().getPickerAction().setCurrentIndex(0);
@@ -101,23 +109,65 @@ PointPlotAction::PointPlotAction(PlotAction* plotAction, ViewerScatterplotPlugin
     connect(&_viewerscatterplotPlugin->getPositionDataset(), &Dataset<Points>::dataChildAdded, this, &PointPlotAction::updateDefaultDatasets);
     connect(&_viewerscatterplotPlugin->getPositionDataset(), &Dataset<Points>::dataChildRemoved, this, &PointPlotAction::updateDefaultDatasets);
 
-    // Update scatter plot widget point size scalars
-    connect(&_sizeAction, &ScalarAction::magnitudeChanged, this, &PointPlotAction::updateScatterPlotWidgetPointSizeScalars);
-    connect(&_sizeAction, &ScalarAction::offsetChanged, this, &PointPlotAction::updateScatterPlotWidgetPointSizeScalars);
-    connect(&_sizeAction, &ScalarAction::sourceSelectionChanged, this, &PointPlotAction::updateScatterPlotWidgetPointSizeScalars);
-    connect(&_sizeAction, &ScalarAction::sourceDataChanged, this, &PointPlotAction::updateScatterPlotWidgetPointSizeScalars);
-    connect(&_sizeAction, &ScalarAction::scalarRangeChanged, this, &PointPlotAction::updateScatterPlotWidgetPointSizeScalars);
+    auto& updateScheduler = _viewerscatterplotPlugin->getUpdateScheduler();
+
+    // Point sizes are updated at most once per update pass (extract the source scalars again when stale)
+    updateScheduler.setUpdateFunction(UpdateScheduler::Buffer::PointSizes, [this]() -> void {
+        if (_pointSizeSourceScalars._stale)
+            updatePointSizeSourceScalars();
+
+        updateScatterPlotWidgetPointSizeScalars();
+    });
+
+    // Point opacities are updated at most once per update pass (extract the source scalars again when stale)
+    updateScheduler.setUpdateFunction(UpdateScheduler::Buffer::PointOpacities, [this]() -> void {
+        if (_pointOpacitySourceScalars._stale)
+            updatePointOpacitySourceScalars();
+
+        updateScatterPlotWidgetPointOpacityScalars();
+    });
+
+    // Schedule a point size update which only changes the mapping of the uploaded source scalars
+    const auto schedulePointSizeUpdate = [this]() -> void {
+        _viewerscatterplotPlugin->getUpdateScheduler().markDirty(UpdateScheduler::Buffer::PointSizes);
+    };
+
+    // Schedule a point size update which extracts the source scalars again
+    const auto schedulePointSizeSourceUpdate = [this]() -> void {
+        _pointSizeSourceScalars._stale = true;
+
+        _viewerscatterplotPlugin->getUpdateScheduler().markDirty(UpdateScheduler::Buffer::PointSizes);
+    };
+
+    // Schedule a point opacity update which only changes the mapping of the uploaded source scalars
+    const auto schedulePointOpacityUpdate = [this]() -> void {
+        _viewerscatterplotPlugin->getUpdateScheduler().markDirty(UpdateScheduler::Buffer::PointOpacities);
+    };
+
+    // Schedule a point opacity update which extracts the source scalars again
+    const auto schedulePointOpacitySourceUpdate = [this]() -> void {
+        _pointOpacitySourceScalars._stale = true;
+
+        _viewerscatterplotPlugin->getUpdateScheduler().markDirty(UpdateScheduler::Buffer::PointOpacities);
+    };
+
+    // Magnitude and offset changes only change the point size mapping (no per-point work)
+    connect(&_sizeAction, &ScalarAction::magnitudeChanged, this, schedulePointSizeUpdate);
+    connect(&_sizeAction, &ScalarAction::offsetChanged, this, schedulePointSizeUpdate);
+
+    // Source, source data and range changes require the point size source scalars to be extracted again
+    connect(&_sizeAction, &ScalarAction::sourceSelectionChanged, this, schedulePointSizeSourceUpdate);
+    connect(&_sizeAction, &ScalarAction::sourceDataChanged, this, schedulePointSizeSourceUpdate);
+    connect(&_sizeAction, &ScalarAction::scalarRangeChanged, this, schedulePointSizeSourceUpdate);
 
-    // Update scatter plot widget point opacity scalars
-    connect(&_opacityAction, &ScalarAction::magnitudeChanged, this, &PointPlotAction::updateScatterPlotWidgetPointOpacityScalars);
-    connect(&_opacityAction, &ScalarAction::offsetChanged, this, &PointPlotAction::updateScatterPlotWidgetPointOpacityScalars);
-    connect(&_opacityAction, &ScalarAction::sourceSelectionChanged, this, &PointPlotAction::updateScatterPlotWidgetPointOpacityScalars);
-    connect(&_opacityAction, &ScalarAction::sourceDataChanged, this, &PointPlotAction::updateScatterPlotWidgetPointOpacityScalars);
-    connect(&_opacityAction, &ScalarAction::scalarRangeChanged, this, &PointPlotAction::updateScatterPlotWidgetPointOpacityScalars);
+    // Magnitude and offset changes only change the point opacity mapping (no per-point work)
+    connect(&_opacityAction, &ScalarAction::magnitudeChanged, this, schedulePointOpacityUpdate);
+    connect(&_opacityAction, &ScalarAction::offsetChanged, this, schedulePointOpacityUpdate);
 
-    // Update the point size and opacity scalars when the selection of the position dataset changes
-    connect(&_viewerscatterplotPlugin->getPositionDataset(), &Dataset<Points>::dataSelectionChanged, this, &PointPlotAction::updateScatterPlotWidgetPointSizeScalars);
-    connect(&_viewerscatterplotPlugin->getPositionDataset(), &Dataset<Points>::dataSelectionChanged, this, &PointPlotAction::updateScatterPlotWidgetPointOpacityScalars);
+    // Source, source data and range changes require the point opacity source scalars to be extracted again
+    connect(&_opacityAction, &ScalarAction::sourceSelectionChanged, this, schedulePointOpacitySourceUpdate);
+    connect(&_opacityAction, &ScalarAction::sourceDataChanged, this, schedulePointOpacitySourceUpdate);
+    connect(&_opacityAction, &ScalarAction::scalarRangeChanged, this, schedulePointOpacitySourceUpdate);
 
     // For convenience, set the offset to double the magnitude in case of a selection source
     connect(&_sizeAction, &ScalarAction::sourceSelectionChanged, this, [this](const std::uint32_t& sourceSelectionIndex) {
@@ -205,6 +255,17 @@ PointPlotAction::PointPlotAction(PlotAction* plotAction, ViewerScatterplotPlugin
                 _opacityAction.setCurrentSourceIndex(_lastOpacitySourceIndex);
         }
     });
+
+    // Switch the point backend
+    connect(&_cpuRenderingAction, &ToggleAction::toggled, this, [this](bool toggled) -> void {
+        getViewerScatterplotWidget().setPointBackend(toggled ? ViewerScatterplotWidget::PointBackend::CPU : ViewerScatterplotWidget::PointBackend::GPU);
+    });
+
+    // Default to the CPU backend when OpenGL is implemented in software
+    connect(&getViewerScatterplotWidget(), &ViewerScatterplotWidget::initialized, this, [this]() -> void {
+        if (getViewerScatterplotWidget().isSoftwareRenderer())
+            _cpuRenderingAction.setChecked(true);
+    });
 }
 
 QMenu* PointPlotAction::getContextMenu()
@@ -224,6 +285,8 @@ QMenu* PointPlotAction::getContextMenu()
     addActionToMenu(&_sizeAction);
     addActionToMenu(&_opacityAction);
 
+    menu->addAction(&_cpuRenderingAction);
+
     return menu;
 }
 
@@ -281,99 +344,138 @@ void PointPlotAction::updateDefaultDatasets()
     }
 }
 
-void PointPlotAction::updateScatterPlotWidgetPointSizeScalars()
+void PointPlotAction::extractSourceScalars(ScalarAction& scalarAction, SourceScalars& sourceScalars)
 {
-    if (!_viewerscatterplotPlugin->getPositionDataset().isValid())
+    sourceScalars._stale    = false;
+    sourceScalars._valid    = false;
+    sourceScalars._hasRange = false;
+    sourceScalars._assigned = false;
+
+    sourceScalars._normalized.clear();
+
+    // Only extract scalars when a source dataset is selected
+    if (!scalarAction.isSourceDataset())
         return;
 
-    _sizeAction.getMagnitudeAction().setMinimum(0);
-    _sizeAction.getMagnitudeAction().setMaximum(100);
-    // Number of points
-    const auto numberOfPoints = _viewerscatterplotPlugin->getPositionDataset()->getNumPoints();
+    // Get current source dataset
+    auto sourceDataset = Dataset<Points>(scalarAction.getCurrentDataset());
 
-    // Resize to number of points if needed
-    if (numberOfPoints != _pointSizeScalars.size())
-        _pointSizeScalars.resize(numberOfPoints);
+    // Only extract scalars if the number of points in the source and target dataset match and we have a valid input dataset
+    if (!sourceDataset.isValid() || sourceDataset->getNumPoints() != _viewerscatterplotPlugin->getPositionDataset()->getNumPoints())
+        return;
 
-    // Fill with ones for constant point size
-    std::fill(_pointSizeScalars.begin(), _pointSizeScalars.end(), _sizeAction.getMagnitudeAction().getValue());
+    sourceScalars._valid = true;
 
-    // Modulate point size by selection
-    if (_sizeAction.isSourceSelection()) {
+    // Get range for selected dimension
+    const auto rangeMin     = scalarAction.getSourceAction().getRangeAction().getMinimum();
+    const auto rangeMax     = scalarAction.getSourceAction().getRangeAction().getMaximum();
+    const auto rangeLength  = rangeMax - rangeMin;
+
+    // Prevent zero division in normalization
+    if (rangeLength <= 0)
+        return;
+
+    sourceScalars._hasRange = true;
+
+    // Number of points
+    const auto numberOfPoints = sourceDataset->getNumPoints();
 
-        // Get smart pointer to current position dataset
-        auto positionDataset = _viewerscatterplotPlugin->getPositionDataset();
+    sourceScalars._normalized.resize(numberOfPoints);
 
-        // Default point size for all
-        std::fill(_pointSizeScalars.begin(), _pointSizeScalars.end(), _sizeAction.getMagnitudeAction().getValue());
+    // Visit the points dataset to get access to the point values
+    sourceDataset->visitData([&scalarAction, &sourceScalars, numberOfPoints, rangeMin, rangeMax, rangeLength](auto pointData) {
 
-        // Establish point size of selected points
-        const auto pointSizeSelectedPoints = _sizeAction.getMagnitudeAction().getValue() + _sizeAction.getSourceAction().getOffsetAction().getValue();
+        // Get current dimension index
+        const auto currentDimensionIndex = scalarAction.getSourceAction().getDimensionPickerAction().getCurrentDimensionIndex();
 
-        std::vector<bool> selected;
+        // Loop over all points and compute the normalized point value
+        for (std::uint32_t pointIndex = 0; pointIndex < numberOfPoints; pointIndex++) {
 
-        // Get selected local indices from position dataset
-        positionDataset->selectedLocalIndices(positionDataset->getSelection<Points>()->indices, selected);
+            // Get point value for dimension
+            auto pointValue = static_cast<float>(pointData[pointIndex][currentDimensionIndex]);
 
-        for (int i = 0; i < selected.size(); i++) {
-            if (!selected[i])
-                continue;
+            // Clamp the point value to the range
+            const auto pointValueClamped = std::max(rangeMin, std::min(rangeMax, pointValue));
 
-            // Selected point size for selected points
-            _pointSizeScalars[i] = pointSizeSelectedPoints;
+            // Compute normalized point value
+            sourceScalars._normalized[pointIndex] = (pointValueClamped - rangeMin) / rangeLength;
         }
-    }
+    });
+}
 
-    // Modulate point size by dataset
-    if (_sizeAction.isSourceDataset()) {
+void PointPlotAction::updatePointSizeSourceScalars()
+{
+    if (!_viewerscatterplotPlugin->getPositionDataset().isValid())
+        return;
 
-        // Get current point size source dataset
-        auto pointSizeSourceDataset = Dataset<Points>(_sizeAction.getCurrentDataset());
+    extractSourceScalars(_sizeAction, _pointSizeSourceScalars);
+}
 
-        // Only populate scalars from dataset if the number of points in the source and target dataset match and we have a valid input dataset
-        if (pointSizeSourceDataset.isValid() && pointSizeSourceDataset->getNumPoints() == _viewerscatterplotPlugin->getPositionDataset()->getNumPoints())
-        {
-            // Visit the points dataset to get access to the point values
-            pointSizeSourceDataset->visitData([this, pointSizeSourceDataset, numberOfPoints](auto pointData) {
+void PointPlotAction::updatePointOpacitySourceScalars()
+{
+    if (!_viewerscatterplotPlugin->getPositionDataset().isValid())
+        return;
+
+    extractSourceScalars(_opacityAction, _pointOpacitySourceScalars);
+}
+
+void PointPlotAction::updateScatterPlotWidgetPointSizeScalars()
+{
+    if (!_viewerscatterplotPlugin->getPositionDataset().isValid())
+        return;
 
-                // Get current dimension index
-                const auto currentDimensionIndex = _sizeAction.getSourceAction().getDimensionPickerAction().getCurrentDimensionIndex();
+    _sizeAction.getMagnitudeAction().setMinimum(0);
+    _sizeAction.getMagnitudeAction().setMaximum(100);
+    // Number of points
+    const auto numberOfPoints = _viewerscatterplotPlugin->getPositionDataset()->getNumPoints();
 
-                // Get range for selected dimension
-                const auto rangeMin     = _sizeAction.getSourceAction().getRangeAction().getMinimum();
-                const auto rangeMax     = _sizeAction.getSourceAction().getRangeAction().getMaximum();
-                const auto rangeLength  = rangeMax - rangeMin;
+    // Establish point size magnitude and offset
+    const auto pointSizeMagnitude   = _sizeAction.getMagnitudeAction().getValue();
+    const auto pointSizeOffset      = _sizeAction.getSourceAction().getOffsetAction().getValue();
 
-                // Prevent zero division in normalization
-                if (rangeLength > 0) {
+    // The point count might have changed since the source scalars were extracted
+    if (_sizeAction.isSourceDataset() && _pointSizeSourceScalars._hasRange && _pointSizeSourceScalars._normalized.size() != numberOfPoints)
+        updatePointSizeSourceScalars();
 
-                    // Loop over all points and compute the point size scalar
-                    for (std::uint32_t pointIndex = 0; pointIndex < numberOfPoints; pointIndex++) {
+    // Get reference to the scatter plot widget
+    auto& scatterplotWidget = _viewerscatterplotPlugin->getViewerScatterplotWidget();
 
-                        // Get point value for dimension
-                        auto pointValue = static_cast<float>(pointData[pointIndex][currentDimensionIndex]);
+    // Sets a constant point size and releases the point size sources
+    const auto setConstantPointSize = [this, &scatterplotWidget](const float& pointSize) -> void {
+        _pointSizeSourceScalars._assigned = false;
 
-                        // Clamp the point value to the range
-                        const auto pointValueClamped = std::max(rangeMin, std::min(rangeMax, pointValue));
+        scatterplotWidget.setPointSize(pointSize);
+    };
 
-                        // Compute normalized point value
-                        const auto pointValueNormalized = (pointValueClamped - rangeMin) / rangeLength;
+    // Constant point size (also when the source dataset cannot be used)
+    if (_sizeAction.isSourceConstant() || (_sizeAction.isSourceDataset() && !_pointSizeSourceScalars._valid)) {
+        setConstantPointSize(pointSizeMagnitude);
+        return;
+    }
+
+    // Zero division since rangeMin == rangeMax, so use a constant point size
+    if (_sizeAction.isSourceDataset() && !_pointSizeSourceScalars._hasRange) {
+        setConstantPointSize(pointSizeOffset + (_sizeAction.getSourceAction().getRangeAction().getMinimum() * pointSizeMagnitude));
+        return;
+    }
 
-                        // Compute normalized point size scalar
-                        _pointSizeScalars[pointIndex] = _sizeAction.getSourceAction().getOffsetAction().getValue() + (pointValueNormalized * _sizeAction.getMagnitudeAction().getValue());
-                    }
-                }
-                else {
+    // Modulate point size by selection (the point renderers add the offset to the size of the selected points)
+    if (_sizeAction.isSourceSelection()) {
+        setConstantPointSize(pointSizeMagnitude);
 
-                    // Zero division since rangeMin == rangeMax, so reset all point size scalars to constant value
-                    std::fill(_pointSizeScalars.begin(), _pointSizeScalars.end(), _sizeAction.getSourceAction().getOffsetAction().getValue() + (rangeMin * _sizeAction.getMagnitudeAction().getValue()));
-                }
-            });
-        }
+        scatterplotWidget.setPointSizeMapping({ pointSizeMagnitude, 0.0f, pointSizeOffset });
     }
 
-    // Set scatter plot point size scalars
-    _viewerscatterplotPlugin->getViewerScatterplotWidget().setPointSizeScalars(_pointSizeScalars);
+    // Modulate point size by dataset (the normalized source scalars are only uploaded when they were extracted again)
+    if (_sizeAction.isSourceDataset()) {
+        if (!_pointSizeSourceScalars._assigned) {
+            scatterplotWidget.setPointSizeSources(_pointSizeSourceScalars._normalized);
+
+            _pointSizeSourceScalars._assigned = true;
+        }
+
+        scatterplotWidget.setPointSizeMapping({ pointSizeOffset, pointSizeMagnitude, 0.0f });
+    }
 }
 
 void PointPlotAction::updateScatterPlotWidgetPointOpacityScalars()
@@ -388,105 +490,66 @@ void PointPlotAction::updateScatterPlotWidgetPointOpacityScalars()
     // Number of points
     const auto numberOfPoints = _viewerscatterplotPlugin->getPositionDataset()->getNumPoints();
 
-    // Resize to number of points
-    if (numberOfPoints != _pointOpacityScalars.size())
-        _pointOpacityScalars.resize(numberOfPoints);
-
-    // Establish opacity magnitude
+    // Establish opacity magnitude and offset
     const auto opacityMagnitude = 0.01f * _opacityAction.getMagnitudeAction().getValue();
+    const auto opacityOffset    = 0.01f * _opacityAction.getSourceAction().getOffsetAction().getValue();
 
-    // Fill with ones for constant point opacity
-    std::fill(_pointOpacityScalars.begin(), _pointOpacityScalars.end(), opacityMagnitude);
+    // The point count might have changed since the source scalars were extracted
+    if (_opacityAction.isSourceDataset() && _pointOpacitySourceScalars._hasRange && _pointOpacitySourceScalars._normalized.size() != numberOfPoints)
+        updatePointOpacitySourceScalars();
 
-    // Modulate point opacity by point selection
-    if (_opacityAction.isSourceSelection()) {
+    // Get reference to the scatter plot widget
+    auto& scatterplotWidget = _viewerscatterplotPlugin->getViewerScatterplotWidget();
 
-        // Get smart pointer to current position dataset
-        auto positionDataset = _viewerscatterplotPlugin->getPositionDataset();
+    // Sets a constant point opacity and releases the point opacity sources
+    const auto setConstantPointOpacity = [this, &scatterplotWidget](const float& pointOpacity) -> void {
+        _pointOpacitySourceScalars._assigned = false;
 
-        // Get smart pointer to the position selection dataset
-        auto selectionSet = positionDataset->getSelection<Points>();
+        scatterplotWidget.setPointOpacity(pointOpacity);
+    };
 
-        // Default point opacity for all
-        std::fill(_pointOpacityScalars.begin(), _pointOpacityScalars.end(), 0.01f * _opacityAction.getMagnitudeAction().getValue());
+    // Constant point opacity (also when the source dataset cannot be used)
+    if (_opacityAction.isSourceConstant() || (_opacityAction.isSourceDataset() && !_pointOpacitySourceScalars._valid)) {
+        setConstantPointOpacity(opacityMagnitude);
+        return;
+    }
 
-        // Establish opacity offset
-        const auto opacityOffset = 0.01f * _opacityAction.getSourceAction().getOffsetAction().getValue();
+    if (_opacityAction.isSourceDataset()) {
 
-        // Establish point opacity of selected points
-        const auto pointOpacitySelectedPoints = std::min(1.0f, opacityMagnitude + opacityOffset);
+        // Handle zero division
+        if (!_pointOpacitySourceScalars._hasRange) {
 
-        // Get selection indices relative to displayed dataset
-        std::vector<uint32_t> localSelectionIndices;
-        positionDataset->getLocalSelectionIndices(localSelectionIndices);
+            // Get reference to range action
+            auto& rangeAction = _opacityAction.getSourceAction().getRangeAction();
 
-        // And selected point opacity for selected points
-        for (const auto& selectionIndex : localSelectionIndices)
-            _pointOpacityScalars[selectionIndex] = pointOpacitySelectedPoints;
+            setConstantPointOpacity(rangeAction.getRangeMinAction().getValue() == rangeAction.getRangeMaxAction().getValue() ? 0.0f : 1.0f);
+            return;
+        }
+
+        // Fully opaque at maximum offset
+        if (opacityOffset == 1.0f) {
+            setConstantPointOpacity(1.0f);
+            return;
+        }
     }
 
-    // Modulate point opacity by dataset
-    if (_opacityAction.isSourceDataset()) {
+    // Modulate point opacity by point selection (the opacity of the selected points is raised by the offset, up to fully opaque)
+    if (_opacityAction.isSourceSelection()) {
+        setConstantPointOpacity(opacityMagnitude);
+
+        scatterplotWidget.setPointOpacityMapping({ opacityMagnitude, 0.0f, std::min(1.0f, opacityMagnitude + opacityOffset) - opacityMagnitude });
+    }
 
-        // Get current point opacity source dataset
-        auto pointOpacitySourceDataset = Dataset<Points>(_opacityAction.getCurrentDataset());
+    // Modulate point opacity by dataset: magnitude * (offset + source / (1 - offset)), the normalized source scalars are only uploaded when they were extracted again
+    if (_opacityAction.isSourceDataset()) {
+        if (!_pointOpacitySourceScalars._assigned) {
+            scatterplotWidget.setPointOpacitySources(_pointOpacitySourceScalars._normalized);
 
-        // Only populate scalars from dataset if the number of points in the source and target dataset match and we have a valid input dataset
-        if (pointOpacitySourceDataset.isValid() && pointOpacitySourceDataset->getNumPoints() == _viewerscatterplotPlugin->getPositionDataset()->getNumPoints())
-        {
-            // Visit the points dataset to get access to the point values
-            pointOpacitySourceDataset->visitData([this, pointOpacitySourceDataset, numberOfPoints, opacityMagnitude](auto pointData) {
-
-                // Get current dimension index
-                const auto currentDimensionIndex = _opacityAction.getSourceAction().getDimensionPickerAction().getCurrentDimensionIndex();
-
-                // Get opacity offset
-                const auto opacityOffset = 0.01f * _opacityAction.getSourceAction().getOffsetAction().getValue();
-
-                // Get range for selected dimension
-                const auto rangeMin     = _opacityAction.getSourceAction().getRangeAction().getMinimum();
-                const auto rangeMax     = _opacityAction.getSourceAction().getRangeAction().getMaximum();
-                const auto rangeLength  = rangeMax - rangeMin;
-
-                // Prevent zero division in normalization
-                if (rangeLength > 0) {
-
-                    // Loop over all points and compute the point size opacity
-                    for (std::uint32_t pointIndex = 0; pointIndex < numberOfPoints; pointIndex++) {
-
-                        // Get point value for dimension
-                        auto pointValue = static_cast<float>(pointData[pointIndex][currentDimensionIndex]);
-
-                        // Clamp the point value to the range
-                        const auto pointValueClamped = std::max(rangeMin, std::min(rangeMax, pointValue));
-
-                        // Compute normalized point value
-                        const auto pointValueNormalized = (pointValueClamped - rangeMin) / rangeLength;
-
-                        // Compute normalized point opacity scalar
-                        if (opacityOffset == 1.0f)
-                            _pointOpacityScalars[pointIndex] = 1.0f;
-                        else
-                            _pointOpacityScalars[pointIndex] = opacityMagnitude * (opacityOffset + (pointValueNormalized / (1.0f - opacityOffset)));
-                    }
-                }
-                else {
-
-                    // Get reference to range action
-                    auto& rangeAction = _opacityAction.getSourceAction().getRangeAction();
-
-                    // Handle zero division
-                    if (rangeAction.getRangeMinAction().getValue() == rangeAction.getRangeMaxAction().getValue())
-                        std::fill(_pointOpacityScalars.begin(), _pointOpacityScalars.end(), 0.0f);
-                    else
-                        std::fill(_pointOpacityScalars.begin(), _pointOpacityScalars.end(), 1.0f);
-                }
-            });
+            _pointOpacitySourceScalars._assigned = true;
         }
-    }
 
-    // Set scatter plot point size scalars
-    _viewerscatterplotPlugin->getViewerScatterplotWidget().setPointOpacityScalars(_pointOpacityScalars);
+        scatterplotWidget.setPointOpacityMapping({ opacityMagnitude * opacityOffset, opacityMagnitude / (1.0f - opacityOffset), 0.0f });
+    }
 }
 
 void PointPlotAction::fromVariantMap(const QVariantMap& variantMap)
@@ -496,6 +559,7 @@ void PointPlotAction::fromVariantMap(const QVariantMap& variantMap)
     _sizeAction.fromParentVariantMap(variantMap);
     _opacityAction.fromParentVariantMap(variantMap);
     _focusSelection.fromParentVariantMap(variantMap);
+    _cpuRenderingAction.fromParentVariantMap(variantMap);
 }
 
 QVariantMap PointPlotAction::toVariantMap() const
@@ -505,6 +569,7 @@ QVariantMap PointPlotAction::toVariantMap() const
     _sizeAction.insertIntoVariantMap(variantMap);
     _opacityAction.insertIntoVariantMap(variantMap);
     _focusSelection.insertIntoVariantMap(variantMap);
+    _cpuRenderingAction.insertIntoVariantMap(variantMap);
 
     return variantMap;
 }
@@ -526,6 +591,8 @@ PointPlotAction::Widget::Widget(QWidget* parent, PointPlotAction* pointPlotActio
         layout->addWidget(pointPlotAction->getOpacityAction().createLabelWidget(this), 1, 0);
         layout->addWidget(pointPlotAction->getOpacityAction().createWidget(this), 1, 1);
 
+        layout->addWidget(pointPlotAction->getCpuRenderingAction().createWidget(this), 2, 1);
+
         setLayout(layout);
     }
     else {
@@ -537,6 +604,7 @@ PointPlotAction::Widget::Widget(QWidget* parent, PointPlotAction* pointPlotActio
         layout->addWidget(pointPlotAction->getSizeAction().createWidget(this));
         layout->addWidget(pointPlotAction->getOpacityAction().createLabelWidget(this));
         layout->addWidget(pointPlotAction->getOpacityAction().createWidget(this));
+        layout->addWidget(pointPlotAction->getCpuRenderingAction().createWidget(this));
 
         setLayout(layout);
     }
@@ -45,12 +45,36 @@ protected:
     /** Update default datasets (candidates are children of points type and with matching number of points) */
     void updateDefaultDatasets();
 
-    /** Update the scatter plot widget point size scalars */
+    /** Update the cached point size source scalars (only needed when the source, its data or the scalar range changes) */
+    void updatePointSizeSourceScalars();
+
+    /** Update the cached point opacity source scalars (only needed when the source, its data or the scalar range changes) */
+    void updatePointOpacitySourceScalars();
+
+    /** Update the point size mapping of the scatter plot widget (the source scalars are only assigned when they were extracted again) */
     void updateScatterPlotWidgetPointSizeScalars();
 
-    /** Update the scatter plot widget point opacity scalars */
+    /** Update the point opacity mapping of the scatter plot widget (the source scalars are only assigned when they were extracted again) */
     void updateScatterPlotWidgetPointOpacityScalars();
 
+protected:
+
+    /** Normalized scalars of a source dataset dimension */
+    struct SourceScalars {
+        bool                _stale      = true;     /** Whether the scalars need to be extracted again before use */
+        bool                _valid      = false;    /** Whether the source dataset is valid and matches the position dataset */
+        bool                _hasRange   = false;    /** Whether the scalar range is non-empty (normalization is possible) */
+        bool                _assigned   = false;    /** Whether the scalars are assigned to the scatter plot widget as mapping sources */
+        std::vector<float>  _normalized;            /** Clamped and normalized source scalars in the range [0, 1] */
+    };
+
+    /**
+     * Extract clamped and normalized scalars from the current source dataset dimension of \p scalarAction
+     * @param scalarAction Reference to the scalar action (point size or opacity)
+     * @param sourceScalars Source scalars to populate
+     */
+    void extractSourceScalars(ScalarAction& scalarAction, SourceScalars& sourceScalars);
+
 public: // Serialization
 
     /**
@@ -70,13 +94,15 @@ public: // Action getters
     ScalarAction& getSizeAction() { return _sizeAction; }
     ScalarAction& getOpacityAction() { return _opacityAction; }
     ToggleAction& getFocusSelection() { return _focusSelection; }
+    ToggleAction& getCpuRenderingAction() { return _cpuRenderingAction; }
 
 protected:
     ScalarAction            _sizeAction;                /** Point size action */
     ScalarAction            _opacityAction;             /** Point opacity action */
-    std::vector<float>      _pointSizeScalars;          /** Cached point size scalars */
-    std::vector<float>      _pointOpacityScalars;       /** Cached point opacity scalars */
+    SourceScalars           _pointSizeSourceScalars;    /** Cached normalized point size source scalars */
+    SourceScalars           _pointOpacitySourceScalars; /** Cached normalized point opacity source scalars */
     ToggleAction            _focusSelection;            /** Focus selection action */
+    ToggleAction            _cpuRenderingAction;        /** Whether the points are rendered on the CPU */
     std::int32_t            _lastOpacitySourceIndex;    /** Last opacity source index that was selected */
 
     static constexpr double DEFAULT_POINT_SIZE      = 10.0;     /** Default point size */
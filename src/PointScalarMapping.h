@@ -0,0 +1,32 @@
+#pragma once
+
+/**
+ * Linear mapping of per-point source scalars (e.g. normalized dataset values) to a point attribute such as the size or the opacity
+ *
+ * The value of a point is offset + scale * source, plus the selection offset when the point is selected. The point renderers
+ * evaluate the mapping per point, so that changing it (e.g. dragging the magnitude or offset) does not touch the per-point data.
+ */
+struct PointScalarMapping
+{
+    float   _offset             = 0.0f;     /** Value of a point with a zero source scalar */
+    float   _scale              = 0.0f;     /** Factor of the source scalar (zero for a constant or selection dependent value) */
+    float   _selectionOffset    = 0.0f;     /** Added to the value of selected points */
+
+    /**
+     * Map a source scalar
+     * @param source Source scalar of the point (zero when there are no source scalars)
+     * @param selected Whether the point is selected
+     * @return Mapped value
+     */
+    float map(const float& source, bool selected) const {
+        return _offset + _scale * source + (selected ? _selectionOffset : 0.0f);
+    }
+
+    bool operator==(const PointScalarMapping& other) const {
+        return _offset == other._offset && _scale == other._scale && _selectionOffset == other._selectionOffset;
+    }
+
+    bool operator!=(const PointScalarMapping& other) const {
+        return !(*this == other);
+    }
+};
@@ -10,6 +10,8 @@ RenderModeAction::RenderModeAction(ViewerScatterplotPlugin* viewerscatterplotPlu
     _scatterPlotAction(this, "Scatter"),
     _densityPlotAction(this, "Density"),
     _contourPlotAction(this, "Contour"),
+    _aggregatePlotAction(this, "Aggregate"),
+    _shadedPlotAction(this, "Shaded"),
     _actionGroup(this)
 {
     setIcon(hdps::Application::getIconFont("FontAwesome").getIcon("image"));
@@ -18,30 +20,44 @@ RenderModeAction::RenderModeAction(ViewerScatterplotPlugin* viewerscatterplotPlu
     _scatterPlotAction.setSerializationName("ScatterPlotToggle");
     _densityPlotAction.setSerializationName("DensityPlotToggle");
     _contourPlotAction.setSerializationName("ContourPlotToggle");
+    _aggregatePlotAction.setSerializationName("AggregatePlotToggle");
+    _shadedPlotAction.setSerializationName("ShadedPlotToggle");
 
     _scatterPlotAction.setShortcutContext(Qt::WidgetWithChildrenShortcut);
     _densityPlotAction.setShortcutContext(Qt::WidgetWithChildrenShortcut);
     _contourPlotAction.setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    _aggregatePlotAction.setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    _shadedPlotAction.setShortcutContext(Qt::WidgetWithChildrenShortcut);
 
     _viewerscatterplotPlugin->getWidget().addAction(&_scatterPlotAction);
     _viewerscatterplotPlugin->getWidget().addAction(&_densityPlotAction);
     _viewerscatterplotPlugin->getWidget().addAction(&_contourPlotAction);
+    _viewerscatterplotPlugin->getWidget().addAction(&_aggregatePlotAction);
+    _viewerscatterplotPlugin->getWidget().addAction(&_shadedPlotAction);
 
     _actionGroup.addAction(&_scatterPlotAction);
     _actionGroup.addAction(&_densityPlotAction);
     _actionGroup.addAction(&_contourPlotAction);
+    _actionGroup.addAction(&_aggregatePlotAction);
+    _actionGroup.addAction(&_shadedPlotAction);
 
     _scatterPlotAction.setCheckable(true);
     _densityPlotAction.setCheckable(true);
     _contourPlotAction.setCheckable(true);
+    _aggregatePlotAction.setCheckable(true);
+    _shadedPlotAction.setCheckable(true);
 
     _scatterPlotAction.setShortcut(QKeySequence("S"));
     _densityPlotAction.setShortcut(QKeySequence("D"));
     _contourPlotAction.setShortcut(QKeySequence("C"));
+    _aggregatePlotAction.setShortcut(QKeySequence("G"));
+    _shadedPlotAction.setShortcut(QKeySequence("H"));
 
     _scatterPlotAction.setToolTip("Set render mode to scatter plot (S)");
     _densityPlotAction.setToolTip("Set render mode to density plot (D)");
     _contourPlotAction.setToolTip("Set render mode to contour plot (C)");
+    _aggregatePlotAction.setToolTip("Set render mode to aggregate (binned) plot (G)");
+    _shadedPlotAction.setToolTip("Set render mode to shaded (per-pixel aggregate) plot (H)");
 
     /*
     const auto& fontAwesome = Application::getIconFont("FontAwesome");
@@ -66,12 +82,24 @@ RenderModeAction::RenderModeAction(ViewerScatterplotPlugin* viewerscatterplotPlu
             getViewerScatterplotWidget().setRenderMode(ViewerScatterplotWidget::RenderMode::LANDSCAPE);
     });
 
+    connect(&_aggregatePlotAction, &QAction::toggled, this, [this](bool toggled) {
+        if (toggled)
+            getViewerScatterplotWidget().setRenderMode(ViewerScatterplotWidget::RenderMode::BINNED);
+    });
+
+    connect(&_shadedPlotAction, &QAction::toggled, this, [this](bool toggled) {
+        if (toggled)
+            getViewerScatterplotWidget().setRenderMode(ViewerScatterplotWidget::RenderMode::SHADED);
+    });
+
     const auto updateButtons = [this]() -> void {
         const auto renderMode = getViewerScatterplotWidget().getRenderMode();
 
         _scatterPlotAction.setChecked(renderMode == ViewerScatterplotWidget::RenderMode::SCATTERPLOT);
         _densityPlotAction.setChecked(renderMode == ViewerScatterplotWidget::RenderMode::DENSITY);
         _contourPlotAction.setChecked(renderMode == ViewerScatterplotWidget::RenderMode::LANDSCAPE);
+        _aggregatePlotAction.setChecked(renderMode == ViewerScatterplotWidget::RenderMode::BINNED);
+        _shadedPlotAction.setChecked(renderMode == ViewerScatterplotWidget::RenderMode::SHADED);
     };
 
     connect(&getViewerScatterplotWidget(), &ViewerScatterplotWidget::renderModeChanged, this, [this, updateButtons](const ViewerScatterplotWidget::RenderMode& renderMode) {
@@ -88,6 +116,8 @@ QMenu* RenderModeAction::getContextMenu()
     menu->addAction(&_scatterPlotAction);
     menu->addAction(&_densityPlotAction);
     menu->addAction(&_contourPlotAction);
+    menu->addAction(&_aggregatePlotAction);
+    menu->addAction(&_shadedPlotAction);
 
     return menu;
 }
@@ -99,6 +129,8 @@ void RenderModeAction::fromVariantMap(const QVariantMap& variantMap)
     _scatterPlotAction.fromParentVariantMap(variantMap);
     _densityPlotAction.fromParentVariantMap(variantMap);
     _contourPlotAction.fromParentVariantMap(variantMap);
+    _aggregatePlotAction.fromParentVariantMap(variantMap);
+    _shadedPlotAction.fromParentVariantMap(variantMap);
 }
 
 QVariantMap RenderModeAction::toVariantMap() const
@@ -108,6 +140,8 @@ QVariantMap RenderModeAction::toVariantMap() const
     _scatterPlotAction.insertIntoVariantMap(variantMap);
     _densityPlotAction.insertIntoVariantMap(variantMap);
     _contourPlotAction.insertIntoVariantMap(variantMap);
+    _aggregatePlotAction.insertIntoVariantMap(variantMap);
+    _shadedPlotAction.insertIntoVariantMap(variantMap);
 
     return variantMap;
 }
@@ -122,6 +156,8 @@ RenderModeAction::Widget::Widget(QWidget* parent, RenderModeAction* renderModeAc
     layout->addWidget(renderModeAction->_scatterPlotAction.createWidget(this, ToggleAction::PushButton));
     layout->addWidget(renderModeAction->_densityPlotAction.createWidget(this, ToggleAction::PushButton));
     layout->addWidget(renderModeAction->_contourPlotAction.createWidget(this, ToggleAction::PushButton));
+    layout->addWidget(renderModeAction->_aggregatePlotAction.createWidget(this, ToggleAction::PushButton));
+    layout->addWidget(renderModeAction->_shadedPlotAction.createWidget(this, ToggleAction::PushButton));
 
     if (widgetFlags & PopupLayout) {
         setPopupLayout(layout);
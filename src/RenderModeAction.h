@@ -45,6 +45,8 @@ protected:
     ToggleAction    _scatterPlotAction;
     ToggleAction    _densityPlotAction;
     ToggleAction    _contourPlotAction;
+    ToggleAction    _aggregatePlotAction;
+    ToggleAction    _shadedPlotAction;
     QActionGroup    _actionGroup;
 
     friend class Widget;
@@ -11,7 +11,8 @@ using namespace hdps::gui;
 ScalarAction::ScalarAction(QObject* parent, ViewerScatterplotPlugin* viewerscatterplotPlugin, const QString& title, const float& minimum, const float& maximum, const float& value, const float& defaultValue) :
     PluginAction(parent, viewerscatterplotPlugin, "Scalar"),
     _magnitudeAction(this, title, minimum, maximum, value, defaultValue),
-    _sourceAction(this, viewerscatterplotPlugin, QString("%1 source").arg(title))
+    _sourceAction(this, viewerscatterplotPlugin, QString("%1 source").arg(title)),
+    _subscriptions(this)
 {
     setText(title);
     setSerializationName("Scalar");
@@ -36,6 +37,23 @@ ScalarAction::ScalarAction(QObject* parent, ViewerScatterplotPlugin* viewerscatt
         emit scalarRangeChanged(minimum, maximum);
     });
 
+    // Update the scalar range (once per batch) and notify others when the data of the current dataset changed
+    connect(&_subscriptions, &DatasetSubscriptions::datasetsChanged, this, [this](const Datasets& datasets) {
+
+        // Get smart pointer to current dataset
+        const auto currentDataset = getCurrentDataset();
+
+        // Only proceed if we have a valid point size dataset
+        if (!currentDataset.isValid())
+            return;
+
+        _sourceAction.updateScalarRange();
+
+        // Update scatter plot widget point size if the current dataset changed
+        if (datasets.contains(currentDataset))
+            emit sourceDataChanged(currentDataset);
+    });
+
     // Pass-through scalar offset updates
     connect(&_sourceAction.getOffsetAction(), &DecimalAction::valueChanged, this, [this](const float& value) {
         emit offsetChanged(value);
@@ -50,33 +68,14 @@ void ScalarAction::addDataset(const Dataset<DatasetImpl>& dataset)
     // Add dataset to the list of candidate datasets
     sourceModel.addDataset(dataset);
 
-    // Connect to the data changed signal so that we can update the scatter plot point size appropriately
-    connect(&sourceModel.getDatasets().last(), &Dataset<DatasetImpl>::dataChanged, this, [this, dataset]() {
-
-        // Get smart pointer to current dataset
-        const auto currentDataset = getCurrentDataset();
-
-        // Only proceed if we have a valid point size dataset
-        if (!currentDataset.isValid())
-            return;
-
-        // To do: schedule more efficient
-        _sourceAction.updateScalarRange();
-
-        // Update scatter plot widget point size if the dataset matches
-        if (currentDataset == dataset)
-            emit sourceDataChanged(dataset);
-    });
-
-    // Connect to the data changed signal so that we can update the scatter plot point size appropriately
-    connect(&_magnitudeAction, &DecimalAction::valueChanged, this, [this, dataset](const float& value) {
-        emit magnitudeChanged(value);
-    });
+    // Subscribe to data changes of the added dataset only (no-op if already subscribed)
+    _subscriptions.subscribe(dataset);
 }
 
 void ScalarAction::removeAllDatasets()
 {
     _sourceAction.getModel().removeAllDatasets();
+    _subscriptions.unsubscribeAll();
 }
 
 Dataset<DatasetImpl> ScalarAction::getCurrentDataset()
@@ -3,6 +3,7 @@
 #include "PluginAction.h"
 
 #include "ScalarSourceAction.h"
+#include "DatasetSubscriptions.h"
 
 using namespace hdps::gui;
 
@@ -144,4 +145,5 @@ signals:
 protected:
     DecimalAction           _magnitudeAction;   /** Scalar magnitude action */
     ScalarSourceAction      _sourceAction;      /** Scalar source action */
+    DatasetSubscriptions    _subscriptions;     /** One data changed subscription per source dataset */
 };
\ No newline at end of file
@@ -24,7 +24,8 @@ SelectionAction::SelectionAction(ViewerScatterplotPlugin& viewerscatterplotPlugi
     _outlineOverrideColorAction(this, "Custom color", true, true),
     _outlineScaleAction(this, "Scale", 100.0f, 500.0f, 200.0f, 200.0f, 1),
     _outlineOpacityAction(this, "Opacity", 0.0f, 100.0f, 100.0f, 100.0f, 1),
-    _outlineHaloEnabledAction(this, "Halo")
+    _outlineHaloEnabledAction(this, "Halo"),
+    _densityRegionAction(this, "Density region", false, false)
 {
     setIcon(hdps::Application::getIconFont("FontAwesome").getIcon("mouse-pointer"));
 
@@ -37,6 +38,7 @@ SelectionAction::SelectionAction(ViewerScatterplotPlugin& viewerscatterplotPlugi
     }
 
     _displayModeAction.setToolTip("The way in which selection is visualized");
+    _densityRegionAction.setToolTip("Click inside a density/landscape region to select all points in the connected region at or above the clicked density (CPU density only)");
 
     _outlineScaleAction.setSuffix("%");
     _outlineOpacityAction.setSuffix("%");
@@ -71,6 +73,10 @@ SelectionAction::SelectionAction(ViewerScatterplotPlugin& viewerscatterplotPlugi
         _viewerscatterplotPlugin.getViewerScatterplotWidget().setSelectionOutlineOpacity(0.01f * value);
     });
 
+    connect(&_densityRegionAction, &ToggleAction::toggled, [this](bool toggled) {
+        _viewerscatterplotPlugin.getViewerScatterplotWidget().setDensityRegionSelectionEnabled(toggled);
+    });
+
     connect(&_outlineHaloEnabledAction, &ToggleAction::toggled, [this](bool toggled) {
         _viewerscatterplotPlugin.getViewerScatterplotWidget().setSelectionOutlineHaloEnabled(toggled);
     });
@@ -102,6 +108,22 @@ SelectionAction::SelectionAction(ViewerScatterplotPlugin& viewerscatterplotPlugi
     updateActionsReadOnly();
 }
 
+void SelectionAction::fromVariantMap(const QVariantMap& variantMap)
+{
+    PixelSelectionAction::fromVariantMap(variantMap);
+
+    _densityRegionAction.fromParentVariantMap(variantMap);
+}
+
+QVariantMap SelectionAction::toVariantMap() const
+{
+    QVariantMap variantMap = PixelSelectionAction::toVariantMap();
+
+    _densityRegionAction.insertIntoVariantMap(variantMap);
+
+    return variantMap;
+}
+
 SelectionAction::Widget::Widget(QWidget* parent, SelectionAction* selectionAction, const std::int32_t& widgetFlags) :
     WidgetActionWidget(parent, selectionAction, widgetFlags)
 {
@@ -146,6 +168,7 @@ SelectionAction::Widget::Widget(QWidget* parent, SelectionAction* selectionActio
         layout->addWidget(selectionAction->getBrushRadiusAction().createWidget(this), 1, 1);
         layout->addWidget(getSelectWidget(), 2, 1);
         layout->addWidget(selectionAction->getNotifyDuringSelectionAction().createWidget(this), 3, 1);
+        layout->addWidget(selectionAction->getDensityRegionAction().createWidget(this), 4, 1);
         
         layout->addWidget(selectionAction->getOverlayColorAction().createLabelWidget(this), 5, 0);
         layout->addWidget(selectionAction->getOverlayColorAction().createWidget(this), 5, 1);
@@ -178,6 +201,7 @@ SelectionAction::Widget::Widget(QWidget* parent, SelectionAction* selectionActio
         layout->addWidget(selectionAction->getSelectAllAction().createWidget(this));
         layout->addWidget(selectionAction->getInvertSelectionAction().createWidget(this));
         layout->addWidget(selectionAction->getNotifyDuringSelectionAction().createWidget(this));
+        layout->addWidget(selectionAction->getDensityRegionAction().createWidget(this));
         layout->addWidget(selectionAction->getDisplayModeAction().createWidget(this));
         layout->addWidget(selectionAction->getOutlineScaleAction().createWidget(this));
         layout->addWidget(selectionAction->getOutlineOpacityAction().createWidget(this));
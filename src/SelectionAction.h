@@ -32,6 +32,21 @@ public:
     DecimalAction& getOutlineScaleAction() { return _outlineScaleAction; }
     DecimalAction& getOutlineOpacityAction() { return _outlineOpacityAction; }
     ToggleAction& getOutlineHaloEnabledAction() { return _outlineHaloEnabledAction; }
+    ToggleAction& getDensityRegionAction() { return _densityRegionAction; }
+
+public: // Serialization
+
+    /**
+     * Load selection action from variant map
+     * @param Variant map representation of the selection action
+     */
+    void fromVariantMap(const QVariantMap& variantMap) override;
+
+    /**
+     * Save selection action to variant map
+     * @return Variant map representation of the selection action
+     */
+    QVariantMap toVariantMap() const override;
 
 protected:
     ViewerScatterplotPlugin&  _viewerscatterplotPlugin;             /** Reference to scatter plot plugin */
@@ -40,4 +55,5 @@ protected:
     DecimalAction       _outlineScaleAction;            /** Selection outline scale action */
     DecimalAction       _outlineOpacityAction;          /** Selection outline opacity action */
     ToggleAction        _outlineHaloEnabledAction;      /** Selection outline halo enabled action */
+    ToggleAction        _densityRegionAction;           /** Select connected density regions by clicking */
 };
\ No newline at end of file
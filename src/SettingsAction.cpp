@@ -78,6 +78,7 @@ void SettingsAction::fromVariantMap(const QVariantMap& variantMap)
     _positionAction.fromParentVariantMap(variantMap);
     _coloringAction.fromParentVariantMap(variantMap);
     _renderModeAction.fromParentVariantMap(variantMap);
+    _selectionAction.fromParentVariantMap(variantMap);
 }
 
 QVariantMap SettingsAction::toVariantMap() const
@@ -89,6 +90,7 @@ QVariantMap SettingsAction::toVariantMap() const
     _plotAction.insertIntoVariantMap(variantMap);
     _positionAction.insertIntoVariantMap(variantMap);
     _coloringAction.insertIntoVariantMap(variantMap);
+    _selectionAction.insertIntoVariantMap(variantMap);
 
     return variantMap;
 }
@@ -0,0 +1,84 @@
+#include "ShadedPlotAction.h"
+#include "Application.h"
+
+#include "ViewerScatterplotPlugin.h"
+#include "ViewerScatterplotWidget.h"
+
+using namespace hdps::gui;
+
+ShadedPlotAction::ShadedPlotAction(PlotAction* plotAction, ViewerScatterplotPlugin* viewerscatterplotPlugin) :
+    PluginAction(plotAction, viewerscatterplotPlugin, "Shaded"),
+    _normalizationAction(this, "Normalization", { "Linear", "Log", "Equalize" }),
+    _pointColorsAction(this, "Point colors", true, true)
+{
+    setToolTip("Shaded plot settings");
+    setSerializationName("ShadedPlot");
+
+    _normalizationAction.setSerializationName("Normalization");
+    _pointColorsAction.setSerializationName("PointColors");
+
+    _normalizationAction.setToolTip("Mapping of the number of points per pixel (equalize spreads the pixels evenly over the color map)");
+    _pointColorsAction.setToolTip("Color the pixels by the mean color/scalar of their points (the number of points sets the opacity), instead of color mapping the number of points");
+
+    _normalizationAction.setCurrentIndex(static_cast<std::int32_t>(getViewerScatterplotWidget().getPixelNormalization()));
+
+    _viewerscatterplotPlugin->getWidget().addAction(&_normalizationAction);
+    _viewerscatterplotPlugin->getWidget().addAction(&_pointColorsAction);
+
+    connect(&_normalizationAction, &OptionAction::currentIndexChanged, this, [this](const std::int32_t& currentIndex) -> void {
+        getViewerScatterplotWidget().setPixelNormalization(static_cast<PixelAggregator::Normalization>(currentIndex));
+    });
+
+    connect(&_pointColorsAction, &ToggleAction::toggled, this, [this](bool toggled) -> void {
+        getViewerScatterplotWidget().setPixelPointColors(toggled);
+    });
+}
+
+QMenu* ShadedPlotAction::getContextMenu()
+{
+    auto menu = new QMenu("Plot settings");
+
+    const auto addActionToMenu = [menu](QAction* action) {
+        auto actionMenu = new QMenu(action->text());
+
+        actionMenu->addAction(action);
+
+        menu->addMenu(actionMenu);
+    };
+
+    addActionToMenu(&_normalizationAction);
+    addActionToMenu(&_pointColorsAction);
+
+    return menu;
+}
+
+void ShadedPlotAction::fromVariantMap(const QVariantMap& variantMap)
+{
+    WidgetAction::fromVariantMap(variantMap);
+
+    _normalizationAction.fromParentVariantMap(variantMap);
+    _pointColorsAction.fromParentVariantMap(variantMap);
+}
+
+QVariantMap ShadedPlotAction::toVariantMap() const
+{
+    QVariantMap variantMap = WidgetAction::toVariantMap();
+
+    _normalizationAction.insertIntoVariantMap(variantMap);
+    _pointColorsAction.insertIntoVariantMap(variantMap);
+
+    return variantMap;
+}
+
+ShadedPlotAction::Widget::Widget(QWidget* parent, ShadedPlotAction* shadedPlotAction) :
+    WidgetActionWidget(parent, shadedPlotAction)
+{
+    auto layout = new QHBoxLayout();
+
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(shadedPlotAction->_normalizationAction.createLabelWidget(this));
+    layout->addWidget(shadedPlotAction->_normalizationAction.createWidget(this));
+    layout->addWidget(shadedPlotAction->_pointColorsAction.createWidget(this));
+
+    setLayout(layout);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "PluginAction.h"
+
+using namespace hdps::gui;
+
+class PlotAction;
+
+class ShadedPlotAction : public PluginAction
+{
+protected:
+    class Widget : public WidgetActionWidget {
+    public:
+        Widget(QWidget* parent, ShadedPlotAction* shadedPlotAction);
+    };
+
+    QWidget* getWidget(QWidget* parent, const std::int32_t& widgetFlags) override {
+        return new Widget(parent, this);
+    };
+
+public:
+    ShadedPlotAction(PlotAction* plotAction, ViewerScatterplotPlugin* viewerscatterplotPlugin);
+
+    QMenu* getContextMenu();
+
+public: // Serialization
+
+    /**
+     * Load widget action from variant map
+     * @param Variant map representation of the widget action
+     */
+    void fromVariantMap(const QVariantMap& variantMap) override;
+
+    /**
+     * Save widget action to variant map
+     * @return Variant map representation of the widget action
+     */
+    QVariantMap toVariantMap() const override;
+
+protected:
+    OptionAction    _normalizationAction;       /** Mapping of the per-pixel point counts */
+    ToggleAction    _pointColorsAction;         /** Color the pixels by the mean point color/scalar instead of the count */
+
+    friend class Widget;
+    friend class PlotAction;
+};
@@ -0,0 +1,470 @@
+#include "SoftwarePointRenderer.h"
+#include "IndexRanges.h"
+
+#include <QPainter>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+    /** Premultiplied color with channels in the range [0, 1] */
+    struct PixelColor {
+        float   _red    = 0.0f;
+        float   _green  = 0.0f;
+        float   _blue   = 0.0f;
+        float   _alpha  = 0.0f;
+    };
+
+    /** Samples the (unpremultiplied) point colors, without opacity, in the same way as the point renderer */
+    class PointColorSampler
+    {
+    public:
+
+        /**
+         * Constructor
+         * @param points Per-point attributes (the positions must be valid)
+         * @param settings Point appearance settings
+         */
+        PointColorSampler(const SoftwarePoints& points, const SoftwarePointSettings& settings) :
+            _positions(*points._positions),
+            _colorScalars(points._colorScalars != nullptr && points._colorScalars->size() == _positions.size() ? points._colorScalars : nullptr),
+            _colors(points._colors != nullptr && points._colors->size() == _positions.size() ? points._colors : nullptr),
+            _settings(settings),
+            _colorMapWidth(settings._colorMapImage.isNull() ? 0 : settings._colorMapImage.width()),
+            _lookupTable(_colorMapWidth),
+            _scalarNormalization(settings._colorMapRange.z > 0.0f ? 1.0f / settings._colorMapRange.z : 0.0f)
+        {
+            // Sample the (1D) color map along the center row (once per color map texel)
+            for (int colorMapIndex = 0; colorMapIndex < _colorMapWidth; colorMapIndex++)
+                _lookupTable[colorMapIndex] = settings._colorMapImage.pixel(colorMapIndex, settings._colorMapImage.height() / 2);
+        }
+
+        /**
+         * Get the color of a point
+         * @param pointIndex Index of the point
+         * @return Color of the point
+         */
+        QRgb operator()(const std::size_t& pointIndex) const
+        {
+            switch (_settings._effect)
+            {
+                case PointEffect::Color:
+                {
+                    if (_colorMapWidth == 0)
+                        break;
+
+                    // Without scalars (e.g. a constant color map) the color map is sampled at the start
+                    const auto normalizedValue = _colorScalars != nullptr ? std::clamp(((*_colorScalars)[pointIndex] - _settings._colorMapRange.x) * _scalarNormalization, 0.0f, 1.0f) : 0.0f;
+
+                    return _lookupTable[std::min(_colorMapWidth - 1, static_cast<int>(normalizedValue * _colorMapWidth))];
+                }
+
+                case PointEffect::Color2D:
+                {
+                    if (_colorMapWidth == 0)
+                        break;
+
+                    const auto& position    = _positions[pointIndex];
+                    const auto& bounds      = _settings._bounds;
+                    const auto& colorMap    = _settings._colorMapImage;
+
+                    const auto u = std::clamp((position.x - bounds.getLeft()) / bounds.getWidth(), 0.0f, 1.0f);
+                    const auto v = std::clamp((position.y - bounds.getBottom()) / bounds.getHeight(), 0.0f, 1.0f);
+
+                    return colorMap.pixel(std::min(_colorMapWidth - 1, static_cast<int>(u * _colorMapWidth)), std::min(colorMap.height() - 1, static_cast<int>((1.0f - v) * colorMap.height())));
+                }
+
+                default:
+                {
+                    if (_colors != nullptr)
+                        return 0xff000000 | (*_colors)[pointIndex];
+
+                    break;
+                }
+            }
+
+            return 0xff000000;
+        }
+
+    private:
+        const std::vector<Vector2f>&        _positions;                 /** Point positions */
+        const std::vector<float>*           _colorScalars;              /** Color scalars (if they match the positions) */
+        const std::vector<std::uint32_t>*   _colors;                    /** Colors (if they match the positions) */
+        const SoftwarePointSettings&        _settings;                  /** Point appearance settings */
+        const int                           _colorMapWidth;             /** Width of the color map image */
+        std::vector<QRgb>                   _lookupTable;               /** Color map sampled along the center row */
+        const float                         _scalarNormalization;       /** Scalar to normalized color map coordinate factor */
+    };
+
+    /** Tiles of the image which are overlapped by a disk */
+    struct TileRange {
+        std::int32_t    _firstColumn    = 0;
+        std::int32_t    _lastColumn     = -1;
+        std::int32_t    _firstRow       = 0;
+        std::int32_t    _lastRow        = -1;
+    };
+}
+
+void SoftwarePointRenderer::render(const SoftwarePoints& points, const SoftwarePointSettings& settings, QImage& image, const QRectF& dataRectangle, const float& pointScale)
+{
+    if (points._positions == nullptr || points._positions->empty() || image.isNull() || settings._bounds.getWidth() <= 0.0f || settings._bounds.getHeight() <= 0.0f)
+        return;
+
+    if (image.format() != QImage::Format_ARGB32_Premultiplied)
+        image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    const auto& positions       = *points._positions;
+    const auto numberOfPoints   = positions.size();
+
+    // Attributes which do not match the positions are ignored
+    const auto matches = [numberOfPoints](const auto* attribute) -> bool {
+        return attribute != nullptr && attribute->size() == numberOfPoints;
+    };
+
+    const auto sizeSources      = matches(points._sizeSources) ? points._sizeSources : nullptr;
+    const auto opacitySources   = matches(points._opacitySources) ? points._opacitySources : nullptr;
+    const auto highlights       = matches(points._highlights) ? points._highlights : nullptr;
+
+    const auto imageWidth       = image.width();
+    const auto imageHeight      = image.height();
+    const auto numberOfColumns  = (imageWidth + TILE_SIZE - 1) / TILE_SIZE;
+    const auto numberOfRows     = (imageHeight + TILE_SIZE - 1) / TILE_SIZE;
+    const auto numberOfTiles    = static_cast<std::size_t>(numberOfColumns) * numberOfRows;
+
+    const auto& bounds  = settings._bounds;
+    const auto scaleX   = static_cast<float>(dataRectangle.width()) / bounds.getWidth();
+    const auto scaleY   = static_cast<float>(dataRectangle.height()) / bounds.getHeight();
+
+    // Image position of a point (the y-axis is flipped)
+    const auto getPixelPosition = [&](const std::size_t& pointIndex) -> Vector2f {
+        const auto& position = positions[pointIndex];
+
+        return Vector2f(static_cast<float>(dataRectangle.left()) + (position.x - bounds.getLeft()) * scaleX, static_cast<float>(dataRectangle.top()) + (bounds.getTop() - position.y) * scaleY);
+    };
+
+    const auto isSelected = [highlights](const std::size_t& pointIndex) -> bool {
+        return highlights != nullptr && (*highlights)[pointIndex] != 0;
+    };
+
+    const auto hasOutline = settings._selectionDisplayMode == PointSelectionDisplayMode::Outline;
+
+    const auto getRadius = [&](const std::size_t& pointIndex) -> float {
+        return 0.5f * pointScale * std::max(0.0f, settings._sizeMapping.map(sizeSources != nullptr ? (*sizeSources)[pointIndex] : 0.0f, isSelected(pointIndex)));
+    };
+
+    // Radius of the disk which is covered by a point (including the selection outline)
+    const auto getOuterRadius = [&](const std::size_t& pointIndex) -> float {
+        const auto radius = getRadius(pointIndex);
+
+        return hasOutline && isSelected(pointIndex) ? radius * (1.0f + std::max(0.0f, settings._selectionOutlineScale)) : radius;
+    };
+
+    // Tiles which contain pixels that are (partially) covered by a point
+    const auto getTileRange = [&](const std::size_t& pointIndex) -> TileRange {
+        const auto pixelPosition    = getPixelPosition(pointIndex);
+        const auto outerRadius      = getOuterRadius(pointIndex) + 1.0f;
+
+        if (!std::isfinite(pixelPosition.x) || !std::isfinite(pixelPosition.y) || outerRadius <= 1.0f)
+            return TileRange();
+
+        const auto left     = std::floor(pixelPosition.x - outerRadius);
+        const auto right    = std::floor(pixelPosition.x + outerRadius);
+        const auto top      = std::floor(pixelPosition.y - outerRadius);
+        const auto bottom   = std::floor(pixelPosition.y + outerRadius);
+
+        if (right < 0.0f || bottom < 0.0f || left >= static_cast<float>(imageWidth) || top >= static_cast<float>(imageHeight))
+            return TileRange();
+
+        TileRange tileRange;
+
+        tileRange._firstColumn  = static_cast<std::int32_t>(std::max(0.0f, left)) / TILE_SIZE;
+        tileRange._lastColumn   = static_cast<std::int32_t>(std::min(static_cast<float>(imageWidth - 1), right)) / TILE_SIZE;
+        tileRange._firstRow     = static_cast<std::int32_t>(std::max(0.0f, top)) / TILE_SIZE;
+        tileRange._lastRow      = static_cast<std::int32_t>(std::min(static_cast<float>(imageHeight - 1), bottom)) / TILE_SIZE;
+
+        return tileRange;
+    };
+
+    // Count the points per tile, each task for a range of points
+    const auto pointRanges = common::getIndexRanges(numberOfPoints, 16384, 4 * static_cast<std::size_t>(std::max(1, QThread::idealThreadCount())));
+
+    std::vector<std::vector<std::uint32_t>> tileCounts(pointRanges.size(), std::vector<std::uint32_t>(numberOfTiles, 0));
+
+    QtConcurrent::blockingMap(common::getIndices(pointRanges.size()), [&](const std::size_t& rangeIndex) -> void {
+        auto& counts = tileCounts[rangeIndex];
+
+        for (auto pointIndex = pointRanges[rangeIndex].first; pointIndex < pointRanges[rangeIndex].second; pointIndex++) {
+            const auto tileRange = getTileRange(pointIndex);
+
+            for (auto row = tileRange._firstRow; row <= tileRange._lastRow; row++)
+                for (auto column = tileRange._firstColumn; column <= tileRange._lastColumn; column++)
+                    counts[static_cast<std::size_t>(row) * numberOfColumns + column]++;
+        }
+    });
+
+    // Offsets of the tile entries per range (ranges are consecutive within a tile, which keeps the point order)
+    std::vector<std::size_t> tileOffsets(numberOfTiles + 1, 0);
+    std::vector<std::vector<std::size_t>> rangeOffsets(pointRanges.size(), std::vector<std::size_t>(numberOfTiles, 0));
+
+    for (std::size_t tileIndex = 0; tileIndex < numberOfTiles; tileIndex++) {
+        auto offset = tileOffsets[tileIndex];
+
+        for (std::size_t rangeIndex = 0; rangeIndex < pointRanges.size(); rangeIndex++) {
+            rangeOffsets[rangeIndex][tileIndex] = offset;
+
+            offset += tileCounts[rangeIndex][tileIndex];
+        }
+
+        tileOffsets[tileIndex + 1] = offset;
+    }
+
+    tileCounts.clear();
+
+    // Scatter the point indices into the tile entries
+    std::vector<std::uint32_t> tileEntries(tileOffsets.back());
+
+    QtConcurrent::blockingMap(common::getIndices(pointRanges.size()), [&](const std::size_t& rangeIndex) -> void {
+        auto& offsets = rangeOffsets[rangeIndex];
+
+        for (auto pointIndex = pointRanges[rangeIndex].first; pointIndex < pointRanges[rangeIndex].second; pointIndex++) {
+            const auto tileRange = getTileRange(pointIndex);
+
+            for (auto row = tileRange._firstRow; row <= tileRange._lastRow; row++)
+                for (auto column = tileRange._firstColumn; column <= tileRange._lastColumn; column++)
+                    tileEntries[offsets[static_cast<std::size_t>(row) * numberOfColumns + column]++] = static_cast<std::uint32_t>(pointIndex);
+        }
+    });
+
+    rangeOffsets.clear();
+
+    const PointColorSampler pointColorSampler(points, settings);
+
+    const auto toColor = [](const QRgb& rgb, const float& alpha) -> PixelColor {
+        return { alpha * qRed(rgb) / 255.0f, alpha * qGreen(rgb) / 255.0f, alpha * qBlue(rgb) / 255.0f, alpha };
+    };
+
+    // Detach the image once (scan lines must not detach concurrently)
+    const auto imageBits    = image.bits();
+    const auto bytesPerLine = static_cast<std::size_t>(image.bytesPerLine());
+
+    const auto selectionOutlineColor = qRgba(static_cast<int>(255.0f * settings._selectionOutlineColor.x), static_cast<int>(255.0f * settings._selectionOutlineColor.y), static_cast<int>(255.0f * settings._selectionOutlineColor.z), 255);
+
+    // Render the tiles in parallel (each task owns the pixels of its tile)
+    QtConcurrent::blockingMap(common::getIndices(numberOfTiles), [&](const std::size_t& tileIndex) -> void {
+        if (tileOffsets[tileIndex] == tileOffsets[tileIndex + 1])
+            return;
+
+        const auto tileLeft     = static_cast<std::int32_t>(tileIndex % numberOfColumns) * TILE_SIZE;
+        const auto tileTop      = static_cast<std::int32_t>(tileIndex / numberOfColumns) * TILE_SIZE;
+        const auto tileWidth    = std::min(TILE_SIZE, imageWidth - tileLeft);
+        const auto tileHeight   = std::min(TILE_SIZE, imageHeight - tileTop);
+
+        // Blend in floating point to prevent banding when many translucent points overlap
+        std::vector<PixelColor> pixels(static_cast<std::size_t>(tileWidth) * tileHeight);
+
+        for (std::int32_t y = 0; y < tileHeight; y++) {
+            const auto scanLine = reinterpret_cast<const QRgb*>(imageBits + (tileTop + y) * bytesPerLine);
+
+            for (std::int32_t x = 0; x < tileWidth; x++) {
+                const auto pixel = scanLine[tileLeft + x];
+
+                pixels[y * tileWidth + x] = { qRed(pixel) / 255.0f, qGreen(pixel) / 255.0f, qBlue(pixel) / 255.0f, qAlpha(pixel) / 255.0f };
+            }
+        }
+
+        // Blend a (premultiplied) color over the pixels of the tile which are covered by a ring, the coverage is anti-aliased
+        const auto drawRing = [&](const Vector2f& center, const float& innerRadius, const float& outerRadius, const PixelColor& color, bool fade) -> void {
+            const auto left     = std::max(tileLeft, static_cast<std::int32_t>(std::floor(center.x - outerRadius - 0.5f)));
+            const auto right    = std::min(tileLeft + tileWidth - 1, static_cast<std::int32_t>(std::floor(center.x + outerRadius + 0.5f)));
+            const auto top      = std::max(tileTop, static_cast<std::int32_t>(std::floor(center.y - outerRadius - 0.5f)));
+            const auto bottom   = std::min(tileTop + tileHeight - 1, static_cast<std::int32_t>(std::floor(center.y + outerRadius + 0.5f)));
+
+            const auto ringWidth                = outerRadius - innerRadius;
+            const auto maximumDistanceSquared   = (outerRadius + 0.5f) * (outerRadius + 0.5f);
+
+            for (auto y = top; y <= bottom; y++) {
+                const auto deltaY = static_cast<float>(y) + 0.5f - center.y;
+
+                for (auto x = left; x <= right; x++) {
+                    const auto deltaX           = static_cast<float>(x) + 0.5f - center.x;
+                    const auto distanceSquared  = deltaX * deltaX + deltaY * deltaY;
+
+                    // Skip the corners of the bounding square
+                    if (distanceSquared >= maximumDistanceSquared)
+                        continue;
+
+                    const auto distance = std::sqrt(distanceSquared);
+
+                    auto coverage = std::clamp(outerRadius + 0.5f - distance, 0.0f, 1.0f);
+
+                    if (innerRadius > 0.0f)
+                        coverage -= std::clamp(innerRadius + 0.5f - distance, 0.0f, 1.0f);
+
+                    // The halo fades out towards the outer radius
+                    if (fade && ringWidth > 0.0f)
+                        coverage *= std::clamp(1.0f - (distance - innerRadius) / ringWidth, 0.0f, 1.0f);
+
+                    if (coverage <= 0.0f)
+                        continue;
+
+                    auto& pixel = pixels[(y - tileTop) * tileWidth + (x - tileLeft)];
+
+                    const auto inverseAlpha = 1.0f - coverage * color._alpha;
+
+                    pixel._red      = coverage * color._red + inverseAlpha * pixel._red;
+                    pixel._green    = coverage * color._green + inverseAlpha * pixel._green;
+                    pixel._blue     = coverage * color._blue + inverseAlpha * pixel._blue;
+                    pixel._alpha    = coverage * color._alpha + inverseAlpha * pixel._alpha;
+                }
+            }
+        };
+
+        const auto drawPoint = [&](const std::size_t& pointIndex) -> void {
+            const auto center       = getPixelPosition(pointIndex);
+            const auto radius       = getRadius(pointIndex);
+            const auto opacity      = std::clamp(settings._opacityMapping.map(opacitySources != nullptr ? (*opacitySources)[pointIndex] : 0.0f, isSelected(pointIndex)), 0.0f, 1.0f);
+            const auto pointColor   = pointColorSampler(pointIndex);
+
+            if (!isSelected(pointIndex)) {
+                drawRing(center, 0.0f, radius, toColor(pointColor, opacity), false);
+                return;
+            }
+
+            // Selected points are drawn in the selection color...
+            if (!hasOutline) {
+                drawRing(center, 0.0f, radius, toColor(selectionOutlineColor, opacity), false);
+                return;
+            }
+
+            // ...or with an outline around the point
+            const auto outlineColor = settings._selectionOutlineOverride ? selectionOutlineColor : pointColor;
+
+            drawRing(center, radius, getOuterRadius(pointIndex), toColor(outlineColor, std::clamp(settings._selectionOutlineOpacity, 0.0f, 1.0f)), settings._selectionHaloEnabled);
+            drawRing(center, 0.0f, radius, toColor(pointColor, opacity), false);
+        };
+
+        // Draw the unselected points first so that the selected points are on top
+        for (auto entryIndex = tileOffsets[tileIndex]; entryIndex < tileOffsets[tileIndex + 1]; entryIndex++)
+            if (!isSelected(tileEntries[entryIndex]))
+                drawPoint(tileEntries[entryIndex]);
+
+        if (highlights != nullptr)
+            for (auto entryIndex = tileOffsets[tileIndex]; entryIndex < tileOffsets[tileIndex + 1]; entryIndex++)
+                if (isSelected(tileEntries[entryIndex]))
+                    drawPoint(tileEntries[entryIndex]);
+
+        // Write the tile back to the image
+        const auto toByte = [](const float& channel) -> int {
+            return static_cast<int>(std::clamp(channel, 0.0f, 1.0f) * 255.0f + 0.5f);
+        };
+
+        for (std::int32_t y = 0; y < tileHeight; y++) {
+            auto scanLine = reinterpret_cast<QRgb*>(imageBits + (tileTop + y) * bytesPerLine);
+
+            for (std::int32_t x = 0; x < tileWidth; x++) {
+                const auto& pixel = pixels[y * tileWidth + x];
+
+                scanLine[tileLeft + x] = qRgba(toByte(pixel._red), toByte(pixel._green), toByte(pixel._blue), toByte(pixel._alpha));
+            }
+        }
+    });
+}
+
+void SoftwarePointRenderer::paint(const SoftwarePoints& points, const SoftwarePointSettings& settings, QPainter& painter, const QRectF& dataRectangle, const float& pointScale, bool selectionOutlinesOnly /*= false*/)
+{
+    if (points._positions == nullptr || points._positions->empty() || settings._bounds.getWidth() <= 0.0f || settings._bounds.getHeight() <= 0.0f)
+        return;
+
+    const auto& positions       = *points._positions;
+    const auto numberOfPoints   = positions.size();
+
+    // Attributes which do not match the positions are ignored
+    const auto matches = [numberOfPoints](const auto* attribute) -> bool {
+        return attribute != nullptr && attribute->size() == numberOfPoints;
+    };
+
+    const auto sizeSources      = matches(points._sizeSources) ? points._sizeSources : nullptr;
+    const auto opacitySources   = matches(points._opacitySources) ? points._opacitySources : nullptr;
+    const auto highlights       = matches(points._highlights) ? points._highlights : nullptr;
+
+    const auto& bounds  = settings._bounds;
+    const auto scaleX   = dataRectangle.width() / bounds.getWidth();
+    const auto scaleY   = dataRectangle.height() / bounds.getHeight();
+
+    const auto isSelected = [highlights](const std::size_t& pointIndex) -> bool {
+        return highlights != nullptr && (*highlights)[pointIndex] != 0;
+    };
+
+    const auto hasOutline = settings._selectionDisplayMode == PointSelectionDisplayMode::Outline;
+
+    const PointColorSampler pointColorSampler(points, settings);
+
+    const auto selectionOutlineColor = QColor::fromRgbF(settings._selectionOutlineColor.x, settings._selectionOutlineColor.y, settings._selectionOutlineColor.z);
+
+    painter.save();
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    // Paint a point as a disk (and its outline as a ring around the disk, the halo is not faded)
+    const auto paintPoint = [&](const std::size_t& pointIndex) -> void {
+        const auto& position = positions[pointIndex];
+
+        const QPointF center(dataRectangle.left() + (position.x - bounds.getLeft()) * scaleX, dataRectangle.top() + (bounds.getTop() - position.y) * scaleY);
+
+        const auto radius   = 0.5 * pointScale * std::max(0.0f, settings._sizeMapping.map(sizeSources != nullptr ? (*sizeSources)[pointIndex] : 0.0f, isSelected(pointIndex)));
+        const auto opacity  = std::clamp(settings._opacityMapping.map(opacitySources != nullptr ? (*opacitySources)[pointIndex] : 0.0f, isSelected(pointIndex)), 0.0f, 1.0f);
+
+        if (!std::isfinite(center.x()) || !std::isfinite(center.y()) || radius <= 0.0)
+            return;
+
+        auto pointColor = QColor::fromRgb(pointColorSampler(pointIndex));
+
+        if (isSelected(pointIndex)) {
+
+            // Selected points are drawn in the selection color...
+            if (!hasOutline) {
+                pointColor = selectionOutlineColor;
+            }
+
+            // ...or with an outline around the point
+            else {
+                const auto outlineWidth = radius * std::max(0.0f, settings._selectionOutlineScale);
+
+                auto outlineColor = settings._selectionOutlineOverride ? selectionOutlineColor : pointColor;
+
+                outlineColor.setAlphaF(std::clamp(settings._selectionOutlineOpacity, 0.0f, 1.0f));
+
+                if (outlineWidth > 0.0) {
+                    painter.setPen(QPen(outlineColor, outlineWidth));
+                    painter.setBrush(Qt::NoBrush);
+                    painter.drawEllipse(center, radius + 0.5 * outlineWidth, radius + 0.5 * outlineWidth);
+                }
+            }
+        }
+
+        if (selectionOutlinesOnly)
+            return;
+
+        pointColor.setAlphaF(opacity);
+
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(pointColor);
+        painter.drawEllipse(center, radius, radius);
+    };
+
+    // Paint the unselected points first so that the selected points are on top
+    if (!selectionOutlinesOnly)
+        for (std::size_t pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+            if (!isSelected(pointIndex))
+                paintPoint(pointIndex);
+
+    if (highlights != nullptr && (hasOutline || !selectionOutlinesOnly))
+        for (std::size_t pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+            if (isSelected(pointIndex))
+                paintPoint(pointIndex);
+
+    painter.restore();
+}
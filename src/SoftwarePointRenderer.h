@@ -0,0 +1,87 @@
+#pragma once
+
+#include "PointScalarMapping.h"
+
+#include "renderers/PointRenderer.h"
+
+#include "graphics/Vector2f.h"
+#include "graphics/Vector3f.h"
+#include "graphics/Bounds.h"
+
+#include <QImage>
+#include <QPainter>
+#include <QRectF>
+
+#include <cstdint>
+#include <vector>
+
+using namespace hdps;
+using namespace hdps::gui;
+
+/** Per-point attributes drawn by the software point renderer (owned by the caller, vectors which do not match the positions are ignored) */
+struct SoftwarePoints
+{
+    const std::vector<Vector2f>*        _positions      = nullptr;      /** Point positions */
+    const std::vector<float>*           _colorScalars   = nullptr;      /** Color scalars (color map point effect) */
+    const std::vector<std::uint32_t>*   _colors         = nullptr;      /** Colors as 0xRRGGBB (no point effect) */
+    const std::vector<float>*           _sizeSources    = nullptr;      /** Source scalars of the point size mapping */
+    const std::vector<float>*           _opacitySources = nullptr;      /** Source scalars of the point opacity mapping */
+    const std::vector<char>*            _highlights     = nullptr;      /** Selection state per point */
+};
+
+/** Point appearance settings of the software and the OpenGL point renderer */
+struct SoftwarePointSettings
+{
+    Bounds                      _bounds;                                                            /** Data bounds covered by the data rectangle */
+    PointScalarMapping          _sizeMapping                = { 10.0f };                            /** Maps the size source scalars to point sizes (diameter in pixels) */
+    PointScalarMapping          _opacityMapping             = { 0.5f };                             /** Maps the opacity source scalars to point opacities */
+    PointEffect                 _effect                     = PointEffect::Color;                   /** What determines the point colors */
+    QImage                      _colorMapImage;                                                     /** Color map image (1D maps are sampled along the center row) */
+    Vector3f                    _colorMapRange              = Vector3f(0.0f, 1.0f, 1.0f);           /** Scalar range of the color map (minimum, maximum, length) */
+    PointSelectionDisplayMode   _selectionDisplayMode       = PointSelectionDisplayMode::Outline;   /** How selected points are distinguished */
+    Vector3f                    _selectionOutlineColor      = Vector3f(1.0f, 0.0f, 0.0f);           /** Selection outline color */
+    bool                        _selectionOutlineOverride   = true;                                 /** Whether the outline has the selection color (otherwise the point color) */
+    float                       _selectionOutlineScale      = 0.5f;                                 /** Outline width as a fraction of the point size */
+    float                       _selectionOutlineOpacity    = 0.5f;                                 /** Selection outline opacity */
+    bool                        _selectionHaloEnabled       = false;                                /** Whether the outline fades out (halo) */
+};
+
+/**
+ * Software point renderer class
+ *
+ * Multi-threaded CPU splatting of the points into an image, for environments without (hardware)
+ * OpenGL such as batch and CI nodes. The image is divided into square tiles; the points are
+ * bucketed into the tiles they overlap with a parallel counting sort (which keeps the point
+ * order within each tile) and each tile is rendered by one task, so no two tasks write the same
+ * pixel. Points are anti-aliased disks which are blended back to front, the selected points on
+ * top with their outline. The output approximates the OpenGL point renderer. The points can also
+ * be painted as vector shapes with a QPainter (for vector image export).
+ */
+class SoftwarePointRenderer
+{
+public:
+
+    /**
+     * Render \p points into \p image (blended over the current contents)
+     * @param points Per-point attributes
+     * @param settings Point appearance settings
+     * @param image Image to render into (converted to premultiplied ARGB32 when it has another format)
+     * @param dataRectangle Rectangle (in image pixels) which covers the data bounds
+     * @param pointScale Factor for the point sizes (e.g. the device pixel ratio)
+     */
+    static void render(const SoftwarePoints& points, const SoftwarePointSettings& settings, QImage& image, const QRectF& dataRectangle, const float& pointScale);
+
+    /**
+     * Paint \p points as vector shapes (disks and outline rings) with \p painter, e.g. for SVG and PDF export
+     * @param points Per-point attributes
+     * @param settings Point appearance settings
+     * @param painter Painter to paint with
+     * @param dataRectangle Rectangle (in painter coordinates) which covers the data bounds
+     * @param pointScale Factor for the point sizes
+     * @param selectionOutlinesOnly Only paint the outlines of the selected points (overlay of a rendered image of the points)
+     */
+    static void paint(const SoftwarePoints& points, const SoftwarePointSettings& settings, QPainter& painter, const QRectF& dataRectangle, const float& pointScale, bool selectionOutlinesOnly = false);
+
+public:
+    static constexpr std::int32_t   TILE_SIZE = 64;     /** Width and height of the image tiles (in pixels) */
+};
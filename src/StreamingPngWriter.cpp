@@ -0,0 +1,438 @@
+#include "StreamingPngWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace
+{
+    /** Fixed Huffman code of a symbol, bit reversed so that it can be written least significant bit first */
+    struct Code {
+        std::uint32_t   _bits   = 0;
+        std::uint32_t   _length = 0;
+    };
+
+    /**
+     * Reverse the order of the lowest \p length bits of \p bits
+     * @param bits Bits
+     * @param length Number of bits
+     * @return Reversed bits
+     */
+    std::uint32_t reverseBits(std::uint32_t bits, const std::uint32_t& length)
+    {
+        std::uint32_t reversed = 0;
+
+        for (std::uint32_t bitIndex = 0; bitIndex < length; bitIndex++) {
+            reversed = (reversed << 1) | (bits & 1);
+            bits >>= 1;
+        }
+
+        return reversed;
+    }
+
+    /** Fixed Huffman codes of the literal/length alphabet (RFC 1951, section 3.2.6) */
+    const std::array<Code, 288> literalLengthCodes = []() {
+        std::array<Code, 288> codes;
+
+        for (std::uint32_t symbol = 0; symbol < 288; symbol++) {
+            if (symbol < 144)
+                codes[symbol] = { reverseBits(0x30 + symbol, 8), 8 };
+            else if (symbol < 256)
+                codes[symbol] = { reverseBits(0x190 + symbol - 144, 9), 9 };
+            else if (symbol < 280)
+                codes[symbol] = { reverseBits(symbol - 256, 7), 7 };
+            else
+                codes[symbol] = { reverseBits(0xc0 + symbol - 280, 8), 8 };
+        }
+
+        return codes;
+    }();
+
+    /** Smallest match length per length symbol (257-285) and the number of extra bits */
+    const std::array<std::uint32_t, 29> lengthBases     = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    const std::array<std::uint32_t, 29> lengthExtraBits = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+    /** Smallest match distance per distance symbol (0-29) and the number of extra bits */
+    const std::array<std::uint32_t, 30> distanceBases       = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+    const std::array<std::uint32_t, 30> distanceExtraBits   = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+    /** Length symbol index (symbol minus 257) per match length (3-258) */
+    const std::array<std::uint8_t, 259> lengthSymbolIndices = []() {
+        std::array<std::uint8_t, 259> indices{};
+
+        for (std::uint32_t symbolIndex = 0; symbolIndex < lengthBases.size(); symbolIndex++)
+            for (auto length = lengthBases[symbolIndex]; length < (symbolIndex + 1 < lengthBases.size() ? lengthBases[symbolIndex + 1] : 259u); length++)
+                indices[length] = static_cast<std::uint8_t>(symbolIndex);
+
+        return indices;
+    }();
+
+    /** CRC-32 lookup table of the PNG chunk checksums */
+    const std::array<std::uint32_t, 256> crcTable = []() {
+        std::array<std::uint32_t, 256> table;
+
+        for (std::uint32_t index = 0; index < 256; index++) {
+            auto crc = index;
+
+            for (int bitIndex = 0; bitIndex < 8; bitIndex++)
+                crc = (crc & 1) ? 0xedb88320u ^ (crc >> 1) : crc >> 1;
+
+            table[index] = crc;
+        }
+
+        return table;
+    }();
+
+    /**
+     * Append \p value to \p data as four big endian bytes
+     * @param data Data to append to
+     * @param value Value
+     */
+    void appendBigEndian(std::vector<std::uint8_t>& data, const std::uint32_t& value)
+    {
+        data.push_back(static_cast<std::uint8_t>(value >> 24));
+        data.push_back(static_cast<std::uint8_t>(value >> 16));
+        data.push_back(static_cast<std::uint8_t>(value >> 8));
+        data.push_back(static_cast<std::uint8_t>(value));
+    }
+}
+
+StreamingPngWriter::~StreamingPngWriter()
+{
+    // Do not leave a truncated image behind
+    if (_file.isOpen()) {
+        _file.close();
+        _file.remove();
+    }
+}
+
+bool StreamingPngWriter::open(const QString& fileName, const std::uint32_t& width, const std::uint32_t& height, const std::uint32_t& numberOfFrames /*= 1*/, const std::uint16_t& frameDelay /*= 100*/)
+{
+    if (_file.isOpen() || width == 0 || height == 0 || numberOfFrames == 0)
+        return false;
+
+    _file.setFileName(fileName);
+
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    _width                  = width;
+    _height                 = height;
+    _numberOfFrames         = numberOfFrames;
+    _frameDelay             = frameDelay;
+    _numberOfWrittenRows    = 0;
+    _numberOfWrittenFrames  = 0;
+    _sequenceNumber         = 0;
+
+    const char signature[] = { '\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n' };
+
+    if (_file.write(signature, sizeof(signature)) != sizeof(signature))
+        return false;
+
+    // Image header: 8 bits per channel RGBA, deflate compression, adaptive filtering (always filter type none) and no interlacing
+    std::vector<std::uint8_t> header;
+
+    appendBigEndian(header, width);
+    appendBigEndian(header, height);
+
+    header.insert(header.end(), { 8, 6, 0, 0, 0 });
+
+    if (!writeChunk("IHDR", header))
+        return false;
+
+    if (!isAnimated())
+        return true;
+
+    // Animation control: number of frames, loop forever
+    std::vector<std::uint8_t> animationControl;
+
+    appendBigEndian(animationControl, numberOfFrames);
+    appendBigEndian(animationControl, 0);
+
+    return writeChunk("acTL", animationControl);
+}
+
+bool StreamingPngWriter::writeRows(const QImage& rows)
+{
+    if (!_file.isOpen() || rows.isNull() || static_cast<std::uint32_t>(rows.width()) != _width || _numberOfWrittenRows + static_cast<std::uint32_t>(rows.height()) > _height)
+        return false;
+
+    if (_numberOfWrittenFrames == _numberOfFrames)
+        return false;
+
+    if (_numberOfWrittenRows == 0 && !beginFrame())
+        return false;
+
+    const auto image = rows.format() == QImage::Format_ARGB32 ? rows : rows.convertToFormat(QImage::Format_ARGB32);
+
+    // Each row is preceded by its filter type (none)
+    std::vector<std::uint8_t> data(static_cast<std::size_t>(image.height()) * (4 * static_cast<std::size_t>(_width) + 1));
+
+    auto byte = data.begin();
+
+    for (int y = 0; y < image.height(); y++) {
+        const auto scanLine = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+
+        *byte++ = 0;
+
+        for (std::uint32_t x = 0; x < _width; x++) {
+            *byte++ = static_cast<std::uint8_t>(qRed(scanLine[x]));
+            *byte++ = static_cast<std::uint8_t>(qGreen(scanLine[x]));
+            *byte++ = static_cast<std::uint8_t>(qBlue(scanLine[x]));
+            *byte++ = static_cast<std::uint8_t>(qAlpha(scanLine[x]));
+        }
+    }
+
+    compress(data);
+
+    _numberOfWrittenRows += static_cast<std::uint32_t>(image.height());
+
+    if (_numberOfWrittenRows == _height)
+        return finishFrame();
+
+    if (_imageData.size() >= IMAGE_DATA_SIZE)
+        return writeImageData();
+
+    return true;
+}
+
+bool StreamingPngWriter::close()
+{
+    if (!_file.isOpen())
+        return false;
+
+    if (_numberOfWrittenFrames != _numberOfFrames)
+        return false;
+
+    if (!writeChunk("IEND", {}))
+        return false;
+
+    _file.close();
+
+    return _file.error() == QFileDevice::NoError;
+}
+
+std::uint32_t StreamingPngWriter::getNumberOfWrittenRows() const
+{
+    return _numberOfWrittenRows;
+}
+
+std::uint32_t StreamingPngWriter::getNumberOfWrittenFrames() const
+{
+    return _numberOfWrittenFrames;
+}
+
+bool StreamingPngWriter::isAnimated() const
+{
+    return _numberOfFrames > 1;
+}
+
+bool StreamingPngWriter::beginFrame()
+{
+    // Each frame is a separate zlib stream
+    _position       = 0;
+    _adlerA         = 1;
+    _adlerB         = 0;
+    _bitBuffer      = 0;
+    _numberOfBits   = 0;
+
+    _window.clear();
+    _imageData.clear();
+    _hashHeads.assign(std::size_t(1) << HASH_BITS, -1);
+
+    if (isAnimated()) {
+
+        // Frame control: the frame covers the image, its delay is in milliseconds, no disposal and the frame replaces the previous one
+        std::vector<std::uint8_t> frameControl;
+
+        appendBigEndian(frameControl, _sequenceNumber++);
+        appendBigEndian(frameControl, _width);
+        appendBigEndian(frameControl, _height);
+        appendBigEndian(frameControl, 0);
+        appendBigEndian(frameControl, 0);
+
+        frameControl.insert(frameControl.end(), { static_cast<std::uint8_t>(_frameDelay >> 8), static_cast<std::uint8_t>(_frameDelay), 1000 >> 8, 1000 & 0xff, 0, 0 });
+
+        if (!writeChunk("fcTL", frameControl))
+            return false;
+    }
+
+    // Zlib header (deflate with a 32 KB window, fastest compression) followed by the header of the final (and only) fixed Huffman block
+    _imageData.insert(_imageData.end(), { 0x78, 0x01 });
+
+    writeBits(1, 1);
+    writeBits(1, 2);
+
+    return true;
+}
+
+bool StreamingPngWriter::finishFrame()
+{
+    // End of block symbol, pad the last byte and append the Adler-32 checksum
+    writeBits(literalLengthCodes[256]._bits, literalLengthCodes[256]._length);
+
+    if (_numberOfBits > 0)
+        writeBits(0, 8 - _numberOfBits);
+
+    appendBigEndian(_imageData, (_adlerB << 16) | _adlerA);
+
+    if (!writeImageData())
+        return false;
+
+    _numberOfWrittenRows = 0;
+    _numberOfWrittenFrames++;
+
+    return true;
+}
+
+void StreamingPngWriter::compress(const std::vector<std::uint8_t>& data)
+{
+    // Update the Adler-32 checksum (the sums are reduced before they can overflow)
+    for (std::size_t first = 0; first < data.size(); first += 5552) {
+        const auto last = std::min(data.size(), first + 5552);
+
+        for (auto index = first; index < last; index++) {
+            _adlerA += data[index];
+            _adlerB += _adlerA;
+        }
+
+        _adlerA %= 65521;
+        _adlerB %= 65521;
+    }
+
+    // Matches may refer to the window which precedes the data
+    std::vector<std::uint8_t> input(_window);
+
+    input.insert(input.end(), data.begin(), data.end());
+
+    const auto inputSize        = static_cast<std::int64_t>(input.size());
+    const auto inputPosition    = _position - static_cast<std::int64_t>(_window.size());
+
+    const auto getHash = [&input](const std::int64_t& index) -> std::size_t {
+        const auto value = (static_cast<std::uint32_t>(input[index]) << 16) | (static_cast<std::uint32_t>(input[index + 1]) << 8) | input[index + 2];
+
+        return static_cast<std::size_t>((value * 2654435761u) >> (32 - HASH_BITS));
+    };
+
+    auto index = static_cast<std::int64_t>(_window.size());
+
+    while (index < inputSize) {
+        std::int64_t matchLength    = 0;
+        std::int64_t matchDistance  = 0;
+
+        if (index + 3 <= inputSize) {
+            auto& hashHead = _hashHeads[getHash(index)];
+
+            const auto candidate = hashHead;
+
+            hashHead = inputPosition + index;
+
+            // Extend the match with the most recent position which has the same hash
+            if (candidate >= inputPosition && inputPosition + index - candidate <= WINDOW_SIZE) {
+                const auto candidateIndex   = candidate - inputPosition;
+                const auto maximumLength    = std::min<std::int64_t>(258, inputSize - index);
+
+                while (matchLength < maximumLength && input[candidateIndex + matchLength] == input[index + matchLength])
+                    matchLength++;
+
+                matchDistance = index - candidateIndex;
+            }
+        }
+
+        if (matchLength < 3) {
+            const auto& code = literalLengthCodes[input[index]];
+
+            writeBits(code._bits, code._length);
+
+            index++;
+            continue;
+        }
+
+        const auto lengthSymbolIndex = lengthSymbolIndices[matchLength];
+
+        writeBits(literalLengthCodes[257 + lengthSymbolIndex]._bits, literalLengthCodes[257 + lengthSymbolIndex]._length);
+        writeBits(static_cast<std::uint32_t>(matchLength) - lengthBases[lengthSymbolIndex], lengthExtraBits[lengthSymbolIndex]);
+
+        auto distanceSymbol = static_cast<std::uint32_t>(distanceBases.size() - 1);
+
+        while (distanceBases[distanceSymbol] > matchDistance)
+            distanceSymbol--;
+
+        writeBits(reverseBits(distanceSymbol, 5), 5);
+        writeBits(static_cast<std::uint32_t>(matchDistance) - distanceBases[distanceSymbol], distanceExtraBits[distanceSymbol]);
+
+        // Hash the last positions of the match, so that short periodic patterns (e.g. pixels) keep matching
+        for (auto matchIndex = index + std::max<std::int64_t>(1, matchLength - 4); matchIndex < index + matchLength && matchIndex + 3 <= inputSize; matchIndex++)
+            _hashHeads[getHash(matchIndex)] = inputPosition + matchIndex;
+
+        index += matchLength;
+    }
+
+    _position += static_cast<std::int64_t>(data.size());
+
+    // Keep the last window of uncompressed data
+    _window.assign(input.end() - std::min<std::int64_t>(WINDOW_SIZE, inputSize), input.end());
+}
+
+void StreamingPngWriter::writeBits(const std::uint32_t& bits, const std::uint32_t& numberOfBits)
+{
+    _bitBuffer      |= static_cast<std::uint64_t>(bits) << _numberOfBits;
+    _numberOfBits   += numberOfBits;
+
+    while (_numberOfBits >= 8) {
+        _imageData.push_back(static_cast<std::uint8_t>(_bitBuffer));
+
+        _bitBuffer      >>= 8;
+        _numberOfBits   -= 8;
+    }
+}
+
+bool StreamingPngWriter::writeChunk(const char* type, const std::vector<std::uint8_t>& data)
+{
+    std::vector<std::uint8_t> chunk;
+
+    chunk.reserve(data.size() + 12);
+
+    appendBigEndian(chunk, static_cast<std::uint32_t>(data.size()));
+
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+
+    // The checksum covers the chunk type and data
+    std::uint32_t crc = 0xffffffffu;
+
+    for (auto byte = chunk.begin() + 4; byte != chunk.end(); byte++)
+        crc = crcTable[(crc ^ *byte) & 0xff] ^ (crc >> 8);
+
+    appendBigEndian(chunk, crc ^ 0xffffffffu);
+
+    return _file.write(reinterpret_cast<const char*>(chunk.data()), static_cast<qint64>(chunk.size())) == static_cast<qint64>(chunk.size());
+}
+
+bool StreamingPngWriter::writeImageData()
+{
+    if (_imageData.empty())
+        return true;
+
+    // The first frame is the default image, the data of later frames is preceded by a sequence number
+    auto written = false;
+
+    if (_numberOfWrittenFrames == 0) {
+        written = writeChunk("IDAT", _imageData);
+    }
+    else {
+        std::vector<std::uint8_t> frameData;
+
+        frameData.reserve(_imageData.size() + 4);
+
+        appendBigEndian(frameData, _sequenceNumber++);
+
+        frameData.insert(frameData.end(), _imageData.begin(), _imageData.end());
+
+        written = writeChunk("fdAT", frameData);
+    }
+
+    _imageData.clear();
+
+    return written;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <QFile>
+#include <QImage>
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Streaming PNG writer class
+ *
+ * Writes a (non-interlaced, 8-bit RGBA) PNG image band by band, so that images which do not fit
+ * in memory (e.g. poster size exports) can be encoded while they are rendered. With more than one
+ * frame an animated PNG (APNG) is written, frame after frame, so frames go straight to disk. Qt image writers
+ * require the complete image, hence the image data is compressed here: a single fixed Huffman
+ * deflate block with greedy LZ77 matching (one hash candidate per position), which compresses the
+ * large uniform areas of plots well at a fraction of the cost of optimal compression. Only the
+ * last window (32 KB) of uncompressed data and the pending compressed data are kept in memory.
+ * Each frame is a separate zlib stream.
+ */
+class StreamingPngWriter
+{
+public:
+
+    /** Closes the file (an incomplete image is removed) */
+    ~StreamingPngWriter();
+
+    /**
+     * Create the PNG file and write the header
+     * @param fileName Path of the PNG file
+     * @param width Width of the image (in pixels)
+     * @param height Height of the image (in pixels)
+     * @param numberOfFrames Number of frames (an animated PNG is written when there is more than one)
+     * @param frameDelay Time each frame is shown (in milliseconds, animated PNG only)
+     * @return Whether the file was created
+     */
+    bool open(const QString& fileName, const std::uint32_t& width, const std::uint32_t& height, const std::uint32_t& numberOfFrames = 1, const std::uint16_t& frameDelay = 100);
+
+    /**
+     * Append rows to the current frame (top-down), the frame is finished when all its rows are written
+     * @param rows Image with the rows (its width must match the image width)
+     * @return Whether the rows were written
+     */
+    bool writeRows(const QImage& rows);
+
+    /**
+     * Finish the image and close the file
+     * @return Whether all frames were written and the file was finished
+     */
+    bool close();
+
+    /** Get the number of rows of the current frame which were written so far */
+    std::uint32_t getNumberOfWrittenRows() const;
+
+    /** Get the number of frames which were written so far */
+    std::uint32_t getNumberOfWrittenFrames() const;
+
+    /** Get whether an animated PNG is written */
+    bool isAnimated() const;
+
+protected:
+
+    /**
+     * Start the zlib stream of the next frame (preceded by its frame control chunk in an animated PNG)
+     * @return Whether the frame was started
+     */
+    bool beginFrame();
+
+    /**
+     * Finish the zlib stream of the current frame and write its remaining data
+     * @return Whether the frame was finished
+     */
+    bool finishFrame();
+
+    /**
+     * Compress uncompressed image data (filter bytes and pixels) into the pending IDAT data
+     * @param data Uncompressed data
+     */
+    void compress(const std::vector<std::uint8_t>& data);
+
+    /**
+     * Append bits to the compressed data (least significant bit first)
+     * @param bits Bits to append
+     * @param numberOfBits Number of bits to append
+     */
+    void writeBits(const std::uint32_t& bits, const std::uint32_t& numberOfBits);
+
+    /**
+     * Write a PNG chunk
+     * @param type Chunk type (four characters)
+     * @param data Chunk data
+     * @return Whether the chunk was written
+     */
+    bool writeChunk(const char* type, const std::vector<std::uint8_t>& data);
+
+    /**
+     * Write the pending compressed data as an IDAT chunk (fdAT chunk for the later frames of an animated PNG)
+     * @return Whether the chunk was written
+     */
+    bool writeImageData();
+
+protected:
+    QFile                       _file;                      /** Output file */
+    std::uint32_t               _width = 0;                 /** Width of the image (in pixels) */
+    std::uint32_t               _height = 0;                /** Height of the image (in pixels) */
+    std::uint32_t               _numberOfFrames = 1;        /** Number of frames */
+    std::uint16_t               _frameDelay = 100;          /** Time each frame is shown (in milliseconds) */
+    std::uint32_t               _numberOfWrittenRows = 0;   /** Number of rows of the current frame written so far */
+    std::uint32_t               _numberOfWrittenFrames = 0; /** Number of frames written so far */
+    std::uint32_t               _sequenceNumber = 0;        /** Sequence number of the next animation chunk (fcTL/fdAT) */
+    std::vector<std::uint8_t>   _window;                    /** Last (at most WINDOW_SIZE) bytes of uncompressed data (LZ77 history) */
+    std::vector<std::int64_t>   _hashHeads;                 /** Most recent stream position per hash of three bytes (-1 when there is none) */
+    std::int64_t                _position = 0;              /** Number of uncompressed bytes of the current frame compressed so far */
+    std::uint32_t               _adlerA = 1;                /** Adler-32 checksum of the uncompressed data (low sum) */
+    std::uint32_t               _adlerB = 0;                /** Adler-32 checksum of the uncompressed data (high sum) */
+    std::uint64_t               _bitBuffer = 0;             /** Compressed bits which do not form a full byte yet */
+    std::uint32_t               _numberOfBits = 0;          /** Number of bits in the bit buffer */
+    std::vector<std::uint8_t>   _imageData;                 /** Compressed data which is not written yet */
+
+    static constexpr std::int64_t   WINDOW_SIZE         = 32768;            /** Maximum LZ77 match distance */
+    static constexpr std::uint32_t  HASH_BITS           = 15;               /** Number of bits of the three byte hashes */
+    static constexpr std::size_t    IMAGE_DATA_SIZE     = 1024 * 1024;      /** Size of the IDAT chunks */
+};
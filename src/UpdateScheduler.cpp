@@ -0,0 +1,92 @@
+#include "UpdateScheduler.h"
+
+UpdateScheduler::UpdateScheduler(QObject* parent /*= nullptr*/) :
+    QObject(parent),
+    _dirty(),
+    _updateFunctions(),
+    _timer(),
+    _flushing(false)
+{
+    _timer.setSingleShot(true);
+    _timer.setInterval(0);
+
+    // Run the update pass once control returns to the event loop
+    connect(&_timer, &QTimer::timeout, this, [this]() -> void {
+        flush();
+    });
+}
+
+void UpdateScheduler::setUpdateFunction(const Buffer& buffer, const UpdateFunction& updateFunction)
+{
+    _updateFunctions[buffer] = updateFunction;
+}
+
+void UpdateScheduler::markDirty(const Buffers& buffers)
+{
+    // Add the buffers and their dependents to the dirty set
+    for (const auto& buffer : { Buffer::Positions, Buffer::Highlights, Buffer::Colors, Buffer::PointSizes, Buffer::PointOpacities, Buffer::Density })
+        if (buffers.testFlag(buffer)) {
+            _dirty |= buffer;
+            _dirty |= getDependentBuffers(buffer);
+        }
+
+    // Dirty buffers which are marked during an update pass are picked up by that same pass
+    if (!_flushing && !_timer.isActive())
+        _timer.start();
+}
+
+bool UpdateScheduler::isDirty(const Buffers& buffers) const
+{
+    return (_dirty & buffers).toInt() != 0;
+}
+
+void UpdateScheduler::flush()
+{
+    flush(Buffer::All);
+}
+
+void UpdateScheduler::flush(const Buffers& buffers)
+{
+    // Prevent re-entrant update passes
+    if (_flushing)
+        return;
+
+    _timer.stop();
+
+    _flushing = true;
+    {
+        // Update the dirty buffers in dependency order
+        for (const auto& buffer : { Buffer::Positions, Buffer::Highlights, Buffer::Colors, Buffer::PointSizes, Buffer::PointOpacities, Buffer::Density }) {
+            if (!buffers.testFlag(buffer) || !_dirty.testFlag(buffer))
+                continue;
+
+            // Clear the flag before updating so that the update function can mark the buffer dirty again
+            _dirty &= ~Buffers(buffer);
+
+            if (_updateFunctions.count(buffer) == 0)
+                continue;
+
+            _updateFunctions[buffer]();
+        }
+    }
+    _flushing = false;
+
+    // Schedule another pass for the buffers which were not flushed or were marked dirty after their turn in this pass
+    if (_dirty.toInt() != 0)
+        _timer.start();
+}
+
+UpdateScheduler::Buffers UpdateScheduler::getDependentBuffers(const Buffer& buffer)
+{
+    switch (buffer)
+    {
+        // The density map is estimated from the point positions, and the number of points can change with them (so the per-point buffers need to be rebuilt)
+        case Buffer::Positions:
+            return Buffer::Highlights | Buffer::PointSizes | Buffer::PointOpacities | Buffer::Density;
+
+        default:
+            break;
+    }
+
+    return Buffers();
+}
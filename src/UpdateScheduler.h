@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QFlags>
+
+#include <functional>
+#include <map>
+
+/**
+ * Update scheduler class
+ *
+ * Coalesces updates of the derived buffers of the scatter plot (positions, colors, point sizes etc.).
+ * Instead of recomputing a buffer directly, callers mark it dirty. All dirty buffers are updated
+ * at most once in a single pass on the next event loop iteration (or earlier with an explicit flush).
+ */
+class UpdateScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /** Derived buffers which can be scheduled for update (in update order) */
+    enum class Buffer {
+        Positions       = 0x0001,       /** Point positions */
+        Highlights      = 0x0002,       /** Point selection highlights */
+        Colors          = 0x0004,       /** Point colors (or color scalars) */
+        PointSizes      = 0x0008,       /** Point size mapping (and its source scalars) */
+        PointOpacities  = 0x0010,       /** Point opacity mapping (and its source scalars) */
+        Density         = 0x0020,       /** Density map */
+
+        All = Positions | Highlights | Colors | PointSizes | PointOpacities | Density
+    };
+
+    Q_DECLARE_FLAGS(Buffers, Buffer)
+
+    /** Update function for a buffer */
+    using UpdateFunction = std::function<void()>;
+
+public:
+
+    /**
+     * Constructor
+     * @param parent Pointer to parent object
+     */
+    UpdateScheduler(QObject* parent = nullptr);
+
+    /**
+     * Set the function which updates \p buffer
+     * @param buffer Buffer to set the update function for
+     * @param updateFunction Function which updates the buffer
+     */
+    void setUpdateFunction(const Buffer& buffer, const UpdateFunction& updateFunction);
+
+    /**
+     * Mark \p buffers (and the buffers that depend on them) dirty and schedule an update pass
+     * @param buffers Buffers to mark dirty
+     */
+    void markDirty(const Buffers& buffers);
+
+    /**
+     * Get whether any of \p buffers is dirty
+     * @param buffers Buffers to check
+     * @return Boolean indicating whether any of the buffers is dirty
+     */
+    bool isDirty(const Buffers& buffers) const;
+
+    /** Update all dirty buffers immediately (e.g. before rendering a screenshot) */
+    void flush();
+
+    /**
+     * Update only the dirty buffers in \p buffers immediately, the other dirty buffers remain scheduled
+     * @param buffers Buffers to update (e.g. the positions and highlights before selecting points)
+     */
+    void flush(const Buffers& buffers);
+
+protected:
+
+    /**
+     * Get the buffers which need to be updated when \p buffer changes
+     * @param buffer Buffer
+     * @return Dependent buffers
+     */
+    static Buffers getDependentBuffers(const Buffer& buffer);
+
+private:
+    Buffers                             _dirty;                 /** Buffers which are scheduled for update */
+    std::map<Buffer, UpdateFunction>    _updateFunctions;       /** Update function per buffer */
+    QTimer                              _timer;                 /** Single shot timer which triggers the update pass on the next event loop iteration */
+    bool                                _flushing;              /** Whether an update pass is in progress */
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(UpdateScheduler::Buffers)
@@ -25,7 +25,9 @@
 
 #include <algorithm>
 #include <functional>
+#include <iterator>
 #include <limits>
+#include <numeric>
 #include <set>
 #include <vector>
 
@@ -39,7 +41,11 @@ ViewerScatterplotPlugin::ViewerScatterplotPlugin(const PluginFactory* factory) :
     _positionDataset(),
     _positionSourceDataset(),
     _positions(),
+    _highlights(),
+    _selectedIndices(),
     _numPoints(0),
+    _positionsVersion(0),
+    _updateScheduler(),
     _scatterPlotWidget(new ViewerScatterplotWidget()),
     _dropWidget(nullptr),
     _settingsAction(this),
@@ -47,6 +53,15 @@ ViewerScatterplotPlugin::ViewerScatterplotPlugin(const PluginFactory* factory) :
 {
     setObjectName("ViewerScatterplot");
 
+    // Positions and highlights are updated in a single pass per event loop iteration
+    _updateScheduler.setUpdateFunction(UpdateScheduler::Buffer::Positions, [this]() -> void {
+        updateData();
+    });
+
+    _updateScheduler.setUpdateFunction(UpdateScheduler::Buffer::Highlights, [this]() -> void {
+        updateSelection();
+    });
+
     _dropWidget = new DropWidget(_scatterPlotWidget);
 
     //getWidget().setFocusPolicy(Qt::ClickFocus);
@@ -232,7 +247,7 @@ void ViewerScatterplotPlugin::init()
     getWidget().setLayout(layout);
 
     // Update the data when the scatter plot widget is initialized
-    connect(_scatterPlotWidget, &ViewerScatterplotWidget::initialized, this, &ViewerScatterplotPlugin::updateData);
+    connect(_scatterPlotWidget, &ViewerScatterplotWidget::initialized, this, &ViewerScatterplotPlugin::updatePositions);
 
     // Update the selection when the pixel selection tool selected area changed
     connect(&_scatterPlotWidget->getPixelSelectionTool(), &PixelSelectionTool::areaChanged, [this]() {
@@ -242,6 +257,9 @@ void ViewerScatterplotPlugin::init()
         }
     });
 
+    // Select the density region under the cursor when it is clicked
+    connect(_scatterPlotWidget, &ViewerScatterplotWidget::densityRegionClicked, this, &ViewerScatterplotPlugin::selectDensityRegion);
+
     // Update the selection when the pixel selection process ended
     connect(&_scatterPlotWidget->getPixelSelectionTool(), &PixelSelectionTool::ended, [this]() {
         if (_scatterPlotWidget->getPixelSelectionTool().isNotifyDuringSelection())
@@ -254,11 +272,15 @@ void ViewerScatterplotPlugin::init()
     // Load points when the pointer to the position dataset changes
     connect(&_positionDataset, &Dataset<Points>::changed, this, &ViewerScatterplotPlugin::positionDatasetChanged);
 
-    // Update points when the position dataset data changes
-    connect(&_positionDataset, &Dataset<Points>::dataChanged, this, &ViewerScatterplotPlugin::updateData);
+    // Schedule a points update when the position dataset data changes
+    connect(&_positionDataset, &Dataset<Points>::dataChanged, this, [this]() -> void {
+        _updateScheduler.markDirty(UpdateScheduler::Buffer::Positions);
+    });
 
-    // Update point selection when the position dataset data changes
-    connect(&_positionDataset, &Dataset<Points>::dataSelectionChanged, this, &ViewerScatterplotPlugin::updateSelection);
+    // Schedule a point selection update when the position dataset selection changes
+    connect(&_positionDataset, &Dataset<Points>::dataSelectionChanged, this, [this]() -> void {
+        _updateScheduler.markDirty(UpdateScheduler::Buffer::Highlights);
+    });
 
     // Update the window title when the GUI name of the position dataset changes
     connect(&_positionDataset, &Dataset<Points>::dataGuiNameChanged, this, &ViewerScatterplotPlugin::updateWindowTitle);
@@ -305,14 +327,18 @@ void ViewerScatterplotPlugin::selectPoints()
     if (!_positionDataset.isValid() || !_scatterPlotWidget->getPixelSelectionTool().isActive())
         return;
 
+    // Clicks select density regions instead (prevents a second notification with an empty selection area)
+    if (_scatterPlotWidget->isDensityRegionSelectionEnabled())
+        return;
+
+    // Apply pending position and selection updates (only), so that the positions match the indices of the dataset
+    _updateScheduler.flush(UpdateScheduler::Buffer::Positions | UpdateScheduler::Buffer::Highlights);
+
     //qDebug() << _positionDataset->getGuiName() << "selectPoints";
 
     // Get binary selection area image from the pixel selection tool
     auto selectionAreaImage = _scatterPlotWidget->getPixelSelectionTool().getAreaPixmap().toImage();
 
-    // Get smart pointer to the position selection dataset
-    auto selectionSet = _positionDataset->getSelection<Points>();
-
     // Create vector for target selection indices
     std::vector<std::uint32_t> targetSelectionIndices;
 
@@ -344,6 +370,43 @@ void ViewerScatterplotPlugin::selectPoints()
     // Selection should be subtracted when the selection process was aborted by the user (e.g. by pressing the escape key)
     const auto selectionModifier = _scatterPlotWidget->getPixelSelectionTool().isAborted() ? PixelSelectionModifierType::Remove : _scatterPlotWidget->getPixelSelectionTool().getModifier();
 
+    applySelection(targetSelectionIndices, selectionModifier);
+}
+
+void ViewerScatterplotPlugin::selectDensityRegion(const QPoint& viewportPosition)
+{
+    if (!_positionDataset.isValid())
+        return;
+
+    // Apply pending position and selection updates (only), so that the positions match the indices of the dataset
+    _updateScheduler.flush(UpdateScheduler::Buffer::Positions | UpdateScheduler::Buffer::Highlights);
+
+    // Local indices of the points in the clicked density region
+    std::vector<std::uint32_t> localIndices;
+
+    if (!_scatterPlotWidget->getDensityRegionPoints(viewportPosition, localIndices))
+        return;
+
+    // Mapping from local to global indices
+    std::vector<std::uint32_t> localGlobalIndices;
+
+    _positionDataset->getGlobalIndices(localGlobalIndices);
+
+    std::vector<std::uint32_t> targetSelectionIndices;
+
+    targetSelectionIndices.reserve(localIndices.size());
+
+    for (const auto& localIndex : localIndices)
+        targetSelectionIndices.push_back(localGlobalIndices[localIndex]);
+
+    applySelection(targetSelectionIndices, _scatterPlotWidget->getPixelSelectionTool().getModifier());
+}
+
+void ViewerScatterplotPlugin::applySelection(std::vector<std::uint32_t>& targetSelectionIndices, const PixelSelectionModifierType& selectionModifier)
+{
+    // Get smart pointer to the position selection dataset
+    auto selectionSet = _positionDataset->getSelection<Points>();
+
     switch (selectionModifier)
     {
         case PixelSelectionModifierType::Replace:
@@ -438,8 +501,8 @@ void ViewerScatterplotPlugin::positionDatasetChanged()
     // Do not show the drop indicator if there is a valid point positions dataset
     _dropWidget->setShowDropIndicator(!_positionDataset.isValid());
 
-    // Update positions data
-    updateData();
+    // Update positions data (the buffers which depend on the positions follow in the next update pass)
+    updatePositions();
 
     // Update the window title to reflect the position dataset change
     updateWindowTitle();
@@ -518,6 +581,12 @@ ViewerScatterplotWidget& ViewerScatterplotPlugin::getViewerScatterplotWidget()
     return *_scatterPlotWidget;
 }
 
+void ViewerScatterplotPlugin::updatePositions()
+{
+    _updateScheduler.markDirty(UpdateScheduler::Buffer::Positions);
+    _updateScheduler.flush(UpdateScheduler::Buffer::Positions);
+}
+
 void ViewerScatterplotPlugin::updateData()
 {
     // Check if the scatter plot is initialized, if not, don't do anything
@@ -535,27 +604,21 @@ void ViewerScatterplotPlugin::updateData()
         if (xDim < 0 || yDim < 0)
             return;
 
-        // Ensure that if positionDataset has now more points, the additional points are plotted
-        if (_numPoints != _positionDataset->getNumPoints())
-        {
-            _settingsAction.getPlotAction().getPointPlotAction().updateScatterPlotWidgetPointSizeScalars();
-            _settingsAction.getPlotAction().getPointPlotAction().updateScatterPlotWidgetPointOpacityScalars();
-        }
-
         // Determine number of points depending on if its a full dataset or a subset
         _numPoints = _positionDataset->getNumPoints();
 
         // Extract 2-dimensional points from the data set based on the selected dimensions
         calculatePositions(*_positionDataset);
 
-        // Pass the 2D points to the scatter plot widget
-        _scatterPlotWidget->setData(&_positions);
+        _positionsVersion++;
 
-        updateSelection();
+        // Pass the 2D points to the scatter plot widget
+        _scatterPlotWidget->setData(&_positions, _positionsVersion);
     }
     else {
         _positions.clear();
-        _scatterPlotWidget->setData(&_positions);
+        _positionsVersion++;
+        _scatterPlotWidget->setData(&_positions, _positionsVersion);
     }
 }
 
@@ -573,17 +636,70 @@ void ViewerScatterplotPlugin::updateSelection()
 
     auto selection = _positionDataset->getSelection<Points>();
 
-    std::vector<bool> selected;
-    std::vector<char> highlights;
+    const auto numberOfPoints = _positionDataset->getNumPoints();
+
+    // Sorted local indices of the selected points
+    std::vector<std::uint32_t> selectedIndices;
+
+    if (_positionDataset->isFull()) {
+
+        // The selection indices are the local indices, so only the selected points are visited
+        selectedIndices.reserve(selection->indices.size());
+
+        for (const auto& index : selection->indices)
+            if (index < numberOfPoints)
+                selectedIndices.push_back(index);
+
+        std::sort(selectedIndices.begin(), selectedIndices.end());
+
+        selectedIndices.erase(std::unique(selectedIndices.begin(), selectedIndices.end()), selectedIndices.end());
+    }
+    else {
+
+        // The global selection indices of a subset are mapped per point
+        std::vector<bool> selected;
+
+        _positionDataset->selectedLocalIndices(selection->indices, selected);
+
+        for (std::uint32_t i = 0; i < std::min<std::size_t>(selected.size(), numberOfPoints); i++)
+            if (selected[i])
+                selectedIndices.push_back(i);
+    }
+
+    // Local indices of the points for which the selection state changed
+    std::vector<std::uint32_t> changedIndices;
+
+    if (_highlights.size() != numberOfPoints) {
+
+        // All points are considered changed when the number of points changed
+        _highlights.assign(numberOfPoints, 0);
+
+        for (const auto& index : selectedIndices)
+            _highlights[index] = 1;
 
-    _positionDataset->selectedLocalIndices(selection->indices, selected);
+        changedIndices.resize(numberOfPoints);
 
-    highlights.resize(_positionDataset->getNumPoints(), 0);
+        std::iota(changedIndices.begin(), changedIndices.end(), 0);
+    }
+    else {
+
+        // The points which are in either the previous or the current selection (not both) changed
+        std::set_symmetric_difference(_selectedIndices.begin(), _selectedIndices.end(), selectedIndices.begin(), selectedIndices.end(), std::back_inserter(changedIndices));
+
+        for (const auto& index : changedIndices)
+            _highlights[index] = _highlights[index] ? 0 : 1;
+    }
 
-    for (int i = 0; i < selected.size(); i++)
-        highlights[i] = selected[i] ? 1 : 0;
+    _selectedIndices = std::move(selectedIndices);
 
-    _scatterPlotWidget->setHighlights(highlights, static_cast<std::int32_t>(selection->indices.size()));
+    _scatterPlotWidget->setHighlights(_highlights, static_cast<std::int32_t>(selection->indices.size()), changedIndices);
+
+    emit highlightsChanged(_highlights, changedIndices);
+}
+
+const std::vector<char>& ViewerScatterplotPlugin::getHighlights() const
+{
+    return _highlights;
 }
 
 void ViewerScatterplotPlugin::fromVariantMap(const QVariantMap& variantMap)
@@ -614,12 +730,12 @@ std::uint32_t ViewerScatterplotPlugin::getNumberOfPoints() const
 
 void ViewerScatterplotPlugin::setXDimension(const std::int32_t& dimensionIndex)
 {
-    updateData();
+    _updateScheduler.markDirty(UpdateScheduler::Buffer::Positions);
 }
 
 void ViewerScatterplotPlugin::setYDimension(const std::int32_t& dimensionIndex)
 {
-    updateData();
+    _updateScheduler.markDirty(UpdateScheduler::Buffer::Positions);
 }
 
 QIcon ViewerScatterplotPluginFactory::getIcon(const QColor& color /*= Qt::black*/) const
@@ -8,6 +8,7 @@
 #include "Common.h"
 
 #include "SettingsAction.h"
+#include "UpdateScheduler.h"
 
 #include <QTimer>
 
@@ -86,11 +87,30 @@ public: // Miscellaneous
     /** Use the pixel selection tool to select data points */
     void selectPoints();
 
+    /**
+     * Select the points in the connected density region under \p viewportPosition
+     * @param viewportPosition Position in viewport coordinates
+     */
+    void selectDensityRegion(const QPoint& viewportPosition);
+
+    /**
+     * Get the selection state of the points in the position dataset
+     * @return Selection state per local point index (one when selected, zero otherwise)
+     */
+    const std::vector<char>& getHighlights() const;
+
 protected:
 
     /** Updates the window title (displays the name of the view and the GUI name of the loaded points dataset) */
     void updateWindowTitle();
 
+    /**
+     * Combine the target selection with the current selection and notify others
+     * @param targetSelectionIndices Global indices of the points to select
+     * @param selectionModifier Whether to replace, add to or remove from the current selection
+     */
+    void applySelection(std::vector<std::uint32_t>& targetSelectionIndices, const PixelSelectionModifierType& selectionModifier);
+
 public:
 
     /** Get reference to the scatter plot widget */
@@ -98,11 +118,27 @@ public:
 
     SettingsAction& getSettingsAction() { return _settingsAction; }
 
+    /** Get reference to the scheduler which coalesces updates of the derived buffers */
+    UpdateScheduler& getUpdateScheduler() { return _updateScheduler; }
+
 private:
+
+    /** Mark the positions (and the buffers which depend on them) dirty and update the positions immediately */
+    void updatePositions();
+
     void updateData();
     void calculatePositions(const Points& points);
     void updateSelection();
 
+signals:
+
+    /**
+     * Signals that the selection state of the points in the position dataset changed
+     * @param highlights Selection state per local point index (one when selected, zero otherwise)
+     * @param changedIndices Local indices of the points for which the selection state changed
+     */
+    void highlightsChanged(const std::vector<char>& highlights, const std::vector<std::uint32_t>& changedIndices);
+
 public: // Serialization
 
     /**
@@ -121,8 +157,12 @@ private:
     Dataset<Points>                 _positionDataset;           /** Smart pointer to points dataset for point position */
     Dataset<Points>                 _positionSourceDataset;     /** Smart pointer to source of the points dataset for point position (if any) */
     std::vector<hdps::Vector2f>     _positions;                 /** Point positions */
+    std::vector<char>               _highlights;                /** Selection state per point */
+    std::vector<std::uint32_t>      _selectedIndices;           /** Sorted local indices of the selected points (diffed with the next selection to establish which points changed) */
     unsigned int                    _numPoints;                 /** Number of point positions */
+    std::uint64_t                   _positionsVersion;          /** Incremented each time the positions are extracted (so the widget does not have to compare them) */
     QTimer                          _selectPointsTimer;         /** Timer to limit the refresh rate of selection updates */
+    UpdateScheduler                 _updateScheduler;           /** Coalesces updates of the derived buffers (needs to be constructed before the settings action) */
 
     static const std::int32_t LAZY_UPDATE_INTERVAL = 2;
 
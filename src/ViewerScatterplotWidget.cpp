@@ -1,16 +1,22 @@
 #include "ViewerScatterplotWidget.h"
+#include "KernelDensityEstimator.h"
 #include "Application.h"
 
 #include "util/PixelSelectionTool.h"
 #include "util/Math.h"
 #include "util/Exception.h"
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
+#include <QApplication>
+#include <QCryptographicHash>
 #include <QSize>
 #include <QPainter>
 #include <QDebug>
 #include <QOpenGLFramebufferObject>
+#include <QOpenGLShaderProgram>
 
 #include <math.h>
 
@@ -36,7 +42,8 @@ ViewerScatterplotWidget::ViewerScatterplotWidget() :
     _densityRenderer(DensityRenderer::RenderMode::DENSITY),
     _backgroundColor(1, 1, 1),
     _pointRenderer(),
-    _pixelSelectionTool(this)
+    _pixelSelectionTool(this),
+    _imageExporter(*this)
 {
     //setContextMenuPolicy(Qt::CustomContextMenu);
     //setAcceptDrops(true);
@@ -47,7 +54,10 @@ ViewerScatterplotWidget::ViewerScatterplotWidget() :
     setMouseTracking(false);
     setFocusPolicy(Qt::NoFocus);
 
-    _pointRenderer.setPointScaling(Absolute);
+    // Forward the progress of the CPU density computation and draw its densities
+    QObject::connect(&_densityComputation, &DensityComputation::started, this, &ViewerScatterplotWidget::densityComputationStarted);
+    QObject::connect(&_densityComputation, &DensityComputation::ended, this, &ViewerScatterplotWidget::densityComputationEnded);
+    QObject::connect(&_densityComputation, &DensityComputation::densityChanged, this, &ViewerScatterplotWidget::applyDensityGrid);
 
     // Configure pixel selection tool
     //_pixelSelectionTool.setEnabled(true);
@@ -100,26 +110,16 @@ void ViewerScatterplotWidget::setRenderMode(const RenderMode& renderMode)
     if (renderMode == _renderMode)
         return;
 
+    const auto pointDataRetained = isPointDataRetained();
+
     _renderMode = renderMode;
 
     emit renderModeChanged(_renderMode);
 
-    switch (_renderMode)
-    {
-        case ViewerScatterplotWidget::SCATTERPLOT:
-            break;
-        
-        case ViewerScatterplotWidget::DENSITY:
-            computeDensity();
-            break;
-
-        case ViewerScatterplotWidget::LANDSCAPE:
-            computeDensity();
-            break;
+    updatePointDataRetention(pointDataRetained);
 
-        default:
-            break;
-    }
+    // The density (if out of date) is computed when the next frame is drawn, only the image depends on the mode
+    _densityImage = QImage();
 
     update();
 }
@@ -136,6 +136,9 @@ void ViewerScatterplotWidget::setColoringMode(const ColoringMode& coloringMode)
 
     _coloringMode = coloringMode;
 
+    // The shaded pixels might no longer take the point colors/scalars
+    _shadedImage = QImage();
+
     emit coloringModeChanged(_coloringMode);
 }
 
@@ -146,11 +149,98 @@ PixelSelectionTool& ViewerScatterplotWidget::getPixelSelectionTool()
 
 void ViewerScatterplotWidget::computeDensity()
 {
-    emit densityComputationStarted();
+    _computedDensityInputs = getDensityInputs();
+
+    switch (_densityBackend)
+    {
+        case DensityBackend::GPU:
+        {
+            emit densityComputationStarted();
+
+            _densityRenderer.computeDensity();
+
+            emit densityComputationEnded();
+
+            emit densityChanged();
+
+            update();
+
+            break;
+        }
+
+        case DensityBackend::CPU:
+        {
+            _densityComputation.compute();
+            break;
+        }
+    }
+}
+
+void ViewerScatterplotWidget::computeInteractiveDensity()
+{
+    _computedDensityInputs = getDensityInputs();
+
+    _densityComputation.computeInteractive();
+}
+
+ViewerScatterplotWidget::DensityInputs ViewerScatterplotWidget::getDensityInputs() const
+{
+    // The GPU density renderer estimates the unweighted density of all points, so weight and selection changes must not trigger a recomputation
+    if (_densityBackend == DensityBackend::GPU)
+        return { _positionsVersion, 0, _dataBounds.getLeft(), _dataBounds.getRight(), _dataBounds.getBottom(), _dataBounds.getTop(), _sigma, _densityBackend, DensitySource::All, 0 };
+
+    return { _positionsVersion, _densityComputation.getWeightsVersion(), _dataBounds.getLeft(), _dataBounds.getRight(), _dataBounds.getBottom(), _dataBounds.getTop(), _sigma, _densityBackend, _densityComputation.getSource(), _densityComputation.getSelectionVersion() };
+}
+
+bool ViewerScatterplotWidget::isDensityOutOfDate() const
+{
+    return !(getDensityInputs() == _computedDensityInputs);
+}
+
+void ViewerScatterplotWidget::updateDensity()
+{
+    // Only density and landscape frames need the density
+    if (!isDensityRenderMode() || !isDensityOutOfDate())
+        return;
+
+    const auto densityInputs = getDensityInputs();
+
+    // Sigma (slider drag) and selection (linked brushing) changes are typically interactive, so the CPU backend previews at reduced resolution first
+    auto interactiveInputs = _computedDensityInputs;
 
-    _densityRenderer.computeDensity();
+    interactiveInputs._sigma            = densityInputs._sigma;
+    interactiveInputs._selectionVersion = densityInputs._selectionVersion;
 
-    emit densityComputationEnded();
+    const auto onlyInteractiveInputsChanged = densityInputs == interactiveInputs;
+
+    if (_densityBackend == DensityBackend::CPU && onlyInteractiveInputsChanged)
+        computeInteractiveDensity();
+    else
+        computeDensity();
+}
+
+std::shared_ptr<const DensityGrid> ViewerScatterplotWidget::getDensityGrid()
+{
+    return _densityComputation.getFullResolutionDensity();
+}
+
+void ViewerScatterplotWidget::applyDensityGrid()
+{
+    _densityGrid = _densityComputation.getDensity();
+
+    if (!_densityGrid)
+        return;
+
+    // Reset the landscape color map range to the density range (which includes negative values for the difference density)
+    const auto minimum = std::min(0.0f, _densityGrid->getMinimum());
+    const auto maximum = _densityGrid->getMaximum();
+
+    _densityColorMapRange = Vector3f(minimum, maximum, maximum - minimum);
+
+    // The cached density image is out of date
+    _densityImage = QImage();
+
+    emit densityChanged();
 
     update();
 }
@@ -158,7 +248,7 @@ void ViewerScatterplotWidget::computeDensity()
 // Positions need to be passed as a pointer as we need to store them locally in order
 // to be able to find the subset of data that's part of a selection. If passed
 // by reference then we can upload the data to the GPU, but not store it in the widget.
-void ViewerScatterplotWidget::setData(const std::vector<Vector2f>* points)
+void ViewerScatterplotWidget::setData(const std::vector<Vector2f>* points, const std::uint64_t& positionsVersion)
 {
     auto dataBounds = getDataBounds(*points);
 
@@ -169,108 +259,684 @@ void ViewerScatterplotWidget::setData(const std::vector<Vector2f>* points)
     _dataBounds = dataBounds;
 
     // Pass bounds and data to renderers
-    _pointRenderer.setBounds(_dataBounds);
     _densityRenderer.setBounds(_dataBounds);
 
-    _pointRenderer.setData(*points);
+    _softwarePointSettings._bounds = _dataBounds;
+
+    makePointRendererCurrent();
+
+    _pointRenderer.setPositions(*points);
     _densityRenderer.setData(points);
 
-    switch (_renderMode)
-    {
-        case ViewerScatterplotWidget::SCATTERPLOT:
-            break;
-        
-        case ViewerScatterplotWidget::DENSITY:
-        case ViewerScatterplotWidget::LANDSCAPE:
-        {
-            _densityRenderer.computeDensity();
-            break;
+    // Keep a pointer to the positions for the CPU density and point backends
+    _positions          = points;
+    _positionsVersion   = positionsVersion;
+
+    _densityComputation.setPositions(points, positionsVersion, _dataBounds);
+
+    // The density (if out of date) is computed when the next frame is drawn
+   // _pointRenderer.setSelectionOutlineColor(Vector3f(1, 0, 0));
+
+    updatePointLayer();
+}
+
+QColor ViewerScatterplotWidget::getBackgroundColor()
+{
+    return _backgroundColor;
+}
+
+void ViewerScatterplotWidget::setBackgroundColor(QColor color)
+{
+    _backgroundColor = color;
+
+    // A point layer which is not premultiplied includes the background
+    if (!_pointLayerPremultiplied)
+        _pointLayerOutOfDate = true;
+
+    update();
+}
+
+void ViewerScatterplotWidget::setHighlights(const std::vector<char>& highlights, const std::int32_t& numSelectedPoints, const std::vector<std::uint32_t>& changedIndices)
+{
+    makePointRendererCurrent();
+
+    // Only upload the parts of the highlights which changed
+    _pointRenderer.updateHighlights(highlights, common::getContiguousRanges(changedIndices, HIGHLIGHT_UPLOAD_GAP));
+
+    // Reference the selection for the software point renderer (owned by the plugin, so it is not copied)
+    _pointHighlights = &highlights;
+
+    updatePointLayer();
+}
+
+void ViewerScatterplotWidget::setScalars(const std::vector<float>& scalars)
+{
+    makePointRendererCurrent();
+
+    _pointRenderer.setColorScalars(scalars);
+
+    // Keep the scalars for the shaded render mode and the software point renderer (only while they are used)
+    if (isPointDataRetained())
+        _pointScalars = scalars;
+
+    // The colors are replaced by the scalars
+    std::vector<std::uint32_t>().swap(_pointColors);
+
+    _pointShading = PixelAggregator::Shading::Scalar;
+
+    _pointColorsVersion++;
+    
+    updatePointLayer();
+}
+
+void ViewerScatterplotWidget::setColors(const std::vector<Vector3f>& colors)
+{
+    _softwarePointSettings._effect = None;
+
+    // The point renderer takes packed colors
+    std::vector<std::uint32_t> packedColors(colors.size());
+
+    std::transform(colors.begin(), colors.end(), packedColors.begin(), [](const Vector3f& color) -> std::uint32_t {
+        const auto toByte = [](const float& channel) -> std::uint32_t {
+            return static_cast<std::uint32_t>(std::clamp(channel, 0.0f, 1.0f) * 255.0f + 0.5f);
+        };
+
+        return (toByte(color.x) << 16) | (toByte(color.y) << 8) | toByte(color.z);
+    });
+
+    makePointRendererCurrent();
+
+    _pointRenderer.setColors(packedColors);
+
+    // Keep the colors for the shaded render mode and the software point renderer (only while they are used)
+    if (isPointDataRetained())
+        _pointColors = std::move(packedColors);
+
+    // The scalars are replaced by the colors
+    std::vector<float>().swap(_pointScalars);
+
+    _pointShading = PixelAggregator::Shading::Color;
+
+    _pointColorsVersion++;
+
+    updatePointLayer();
+}
+
+void ViewerScatterplotWidget::setPointSizeSources(const std::vector<float>& pointSizeSources)
+{
+    makePointRendererCurrent();
+
+    _pointRenderer.setSizeSources(pointSizeSources);
+
+    // Reference the sources for the software point renderer (owned by the point plot action, so they are not copied)
+    _pointSizeSources = pointSizeSources.empty() ? nullptr : &pointSizeSources;
+
+    updatePointLayer();
+}
+
+void ViewerScatterplotWidget::setPointOpacitySources(const std::vector<float>& pointOpacitySources)
+{
+    makePointRendererCurrent();
+
+    _pointRenderer.setOpacitySources(pointOpacitySources);
+
+    // Reference the sources for the software point renderer (owned by the point plot action, so they are not copied)
+    _pointOpacitySources = pointOpacitySources.empty() ? nullptr : &pointOpacitySources;
+
+    updatePointLayer();
+}
+
+void ViewerScatterplotWidget::setPointSizeMapping(const PointScalarMapping& pointSizeMapping)
+{
+    if (pointSizeMapping == _softwarePointSettings._sizeMapping)
+        return;
+
+    _softwarePointSettings._sizeMapping = pointSizeMapping;
+
+    updatePointLayer();
+}
+
+void ViewerScatterplotWidget::setPointOpacityMapping(const PointScalarMapping& pointOpacityMapping)
+{
+    if (pointOpacityMapping == _softwarePointSettings._opacityMapping)
+        return;
+
+    _softwarePointSettings._opacityMapping = pointOpacityMapping;
+
+    updatePointLayer();
+}
+
+void ViewerScatterplotWidget::setPointSize(const float& pointSize)
+{
+    // Release the point size sources when switching from per-point sizes
+    if (_pointSizeSources != nullptr)
+        setPointSizeSources(std::vector<float>());
+
+    setPointSizeMapping({ pointSize });
+}
+
+void ViewerScatterplotWidget::setPointOpacity(const float& pointOpacity)
+{
+    // Release the point opacity sources when switching from per-point opacities
+    if (_pointOpacitySources != nullptr)
+        setPointOpacitySources(std::vector<float>());
+
+    setPointOpacityMapping({ pointOpacity });
+}
+
+ViewerScatterplotWidget::PointBackend ViewerScatterplotWidget::getPointBackend() const
+{
+    return _pointBackend;
+}
+
+void ViewerScatterplotWidget::setPointBackend(const PointBackend& pointBackend)
+{
+    if (pointBackend == _pointBackend)
+        return;
+
+    const auto pointDataRetained = isPointDataRetained();
+
+    _pointBackend = pointBackend;
+
+    updatePointDataRetention(pointDataRetained);
+
+    updatePointLayer();
+}
+
+void ViewerScatterplotWidget::setScalarEffect(PointEffect effect)
+{
+    _softwarePointSettings._effect = effect;
+
+    updatePointLayer();
+}
+
+void ViewerScatterplotWidget::setSigma(const float sigma)
+{
+    _sigma = sigma;
+
+    _densityRenderer.setSigma(sigma);
+    _densityComputation.setSigma(sigma);
+
+    // The density (if out of date) is computed when the next frame is drawn
+    update();
+}
+
+ViewerScatterplotWidget::DensityBackend ViewerScatterplotWidget::getDensityBackend() const
+{
+    return _densityBackend;
+}
+
+void ViewerScatterplotWidget::setDensityBackend(const DensityBackend& densityBackend)
+{
+    if (densityBackend == _densityBackend)
+        return;
+
+    _densityBackend = densityBackend;
+
+    // Release the CPU density grid when it is no longer used
+    if (_densityBackend == DensityBackend::GPU) {
+        _densityComputation.reset();
+
+        _densityGrid.reset();
+        _densityImage = QImage();
+    }
+
+    // The density is computed with the new backend when the next frame is drawn
+    update();
+}
+
+void ViewerScatterplotWidget::setDensityWeights(const std::vector<float>& weights)
+{
+    _densityComputation.setWeights(weights);
+
+    // The density (if out of date) is computed when the next frame is drawn
+    update();
+}
+
+void ViewerScatterplotWidget::clearDensityWeights()
+{
+    if (!_densityComputation.hasWeights())
+        return;
+
+    _densityComputation.clearWeights();
+
+    update();
+}
+
+bool ViewerScatterplotWidget::hasDensityWeights() const
+{
+    return _densityComputation.hasWeights();
+}
+
+ViewerScatterplotWidget::DensitySource ViewerScatterplotWidget::getDensitySource() const
+{
+    return _densityComputation.getSource();
+}
+
+void ViewerScatterplotWidget::setDensitySource(const DensitySource& densitySource)
+{
+    if (densitySource == _densityComputation.getSource())
+        return;
+
+    _densityComputation.setSource(densitySource);
+
+    // The density (if out of date) is computed when the next frame is drawn
+    update();
+}
+
+void ViewerScatterplotWidget::updateDensityHighlights(const std::vector<char>& highlights, const std::vector<std::uint32_t>& changedIndices)
+{
+    _densityComputation.updateHighlights(highlights, changedIndices);
+
+    if (_densityComputation.getSource() != DensitySource::All && isDensityRenderMode())
+        update();
+}
+
+std::uint32_t ViewerScatterplotWidget::getNumberOfContourLevels() const
+{
+    return _numberOfContourLevels;
+}
+
+void ViewerScatterplotWidget::setNumberOfContourLevels(const std::uint32_t& numberOfContourLevels)
+{
+    if (numberOfContourLevels == _numberOfContourLevels)
+        return;
+
+    _numberOfContourLevels = numberOfContourLevels;
+
+    update();
+}
+
+std::shared_ptr<const Contours> ViewerScatterplotWidget::getContours()
+{
+    // Without a CPU density there is nothing to extract contours from
+    if (_densityBackend != DensityBackend::CPU || !_densityGrid || _numberOfContourLevels == 0) {
+        if (!_contours || !_contours->empty()) {
+            _contours = std::make_shared<const Contours>();
+            _contoursDensityGrid.reset();
+            _contoursPath = QPainterPath();
         }
 
-        default:
-            break;
+        return _contours;
     }
-   // _pointRenderer.setSelectionOutlineColor(Vector3f(1, 0, 0));
+
+    // Extract the contours at most once per density grid and number of levels
+    if (_contours && _contoursDensityGrid == _densityGrid && _contoursNumberOfLevels == _numberOfContourLevels)
+        return _contours;
+
+    _contours               = std::make_shared<const Contours>(ContourExtractor::extract(*_densityGrid, _dataBounds, ContourExtractor::getLevels(*_densityGrid, _numberOfContourLevels)));
+    _contoursDensityGrid    = _densityGrid;
+    _contoursNumberOfLevels = _numberOfContourLevels;
+    _contoursPath           = QPainterPath();
+
+    for (const auto& contour : *_contours) {
+        for (const auto& polyline : contour._polylines) {
+            if (polyline.empty())
+                continue;
+
+            _contoursPath.moveTo(polyline.front().x, polyline.front().y);
+
+            for (std::size_t pointIndex = 1; pointIndex < polyline.size(); pointIndex++)
+                _contoursPath.lineTo(polyline[pointIndex].x, polyline[pointIndex].y);
+        }
+    }
+
+    return _contours;
+}
+
+bool ViewerScatterplotWidget::isDensityRegionSelectionEnabled() const
+{
+    return _densityRegionSelectionEnabled;
+}
+
+void ViewerScatterplotWidget::setDensityRegionSelectionEnabled(bool densityRegionSelectionEnabled)
+{
+    if (densityRegionSelectionEnabled == _densityRegionSelectionEnabled)
+        return;
+
+    _densityRegionSelectionEnabled = densityRegionSelectionEnabled;
+
+    // Suspend the pixel selection tool while clicks select density regions (otherwise a click also ends an empty pixel selection)
+    if (_densityRegionSelectionEnabled) {
+        _pixelSelectionToolSuspended = _pixelSelectionTool.isEnabled();
+        _pixelSelectionTool.setEnabled(false);
+    }
+    else {
+        if (_pixelSelectionToolSuspended)
+            _pixelSelectionTool.setEnabled(true);
+
+        _pixelSelectionToolSuspended = false;
+    }
+
+    update();
+}
+
+bool ViewerScatterplotWidget::getDensityRegionPoints(const QPoint& viewportPosition, std::vector<std::uint32_t>& localIndices)
+{
+    localIndices.clear();
+
+    if (_densityBackend != DensityBackend::CPU || !isDensityRenderMode() || !_densityGrid || !_densityGrid->isValid() || _positions == nullptr)
+        return false;
+
+    // Establish the clicked grid cell
+    bool invertible = false;
+
+    const auto dataPosition = getDataToViewportTransform(size()).inverted(&invertible).map(QPointF(viewportPosition));
+
+    if (!invertible)
+        return false;
+
+    const auto resolution = _densityGrid->getResolution();
+
+    std::size_t clickedCellIndex = 0;
+
+    if (!KernelDensityEstimator::getCellIndex(Vector2f(dataPosition.x(), dataPosition.y()), _dataBounds, resolution, clickedCellIndex))
+        return false;
+
+    auto level = _densityGrid->getValues()[clickedCellIndex];
+
+    // Nothing to select in empty space
+    if (level <= 0.0f)
+        return false;
+
+    // Snap to the drawn contour which encloses the clicked position
+    if (_numberOfContourLevels > 0) {
+        const auto contourLevels = ContourExtractor::getLevels(*_densityGrid, _numberOfContourLevels);
+        const auto it = std::upper_bound(contourLevels.begin(), contourLevels.end(), level);
+
+        if (it != contourLevels.begin())
+            level = *std::prev(it);
+    }
+
+    // Label the connected regions once per level, then classify the points with a grid lookup
+    const auto labels       = _densityRegionLabels.getLabels(_densityGrid, level);
+    const auto clickedLabel = (*labels)[clickedCellIndex];
+
+    if (clickedLabel == DensityRegionLabels::NO_REGION)
+        return false;
+
+    for (std::uint32_t pointIndex = 0; pointIndex < _positions->size(); pointIndex++) {
+        std::size_t cellIndex = 0;
+
+        if (KernelDensityEstimator::getCellIndex((*_positions)[pointIndex], _dataBounds, resolution, cellIndex) && (*labels)[cellIndex] == clickedLabel)
+            localIndices.push_back(pointIndex);
+    }
+
+    return true;
+}
+
+void ViewerScatterplotWidget::mousePressEvent(QMouseEvent* mouseEvent)
+{
+    if (mouseEvent->button() == Qt::LeftButton)
+        _mousePressPosition = mouseEvent->pos();
+
+    QOpenGLWidget::mousePressEvent(mouseEvent);
+}
+
+void ViewerScatterplotWidget::mouseReleaseEvent(QMouseEvent* mouseEvent)
+{
+    const auto isClick = (mouseEvent->pos() - _mousePressPosition).manhattanLength() < QApplication::startDragDistance();
+
+    if (_densityRegionSelectionEnabled && mouseEvent->button() == Qt::LeftButton && isClick)
+        emit densityRegionClicked(mouseEvent->pos());
+
+    QOpenGLWidget::mouseReleaseEvent(mouseEvent);
+}
+
+std::int32_t ViewerScatterplotWidget::clusterDensityPeaks(const float& minimumDensity, std::vector<std::int32_t>& pointLabels)
+{
+    pointLabels.clear();
+
+    if (_positions == nullptr)
+        return 0;
+
+    const auto densityGrid = getDensityGrid();
+
+    // Cluster the grid cells first, the points follow their cell
+    std::vector<std::int32_t> cellLabels;
+
+    const auto peaks = DensityPeakClustering::clusterGrid(*densityGrid, minimumDensity * densityGrid->getMaximum(), cellLabels);
+
+    DensityPeakClustering::labelPoints(*_positions, _dataBounds, densityGrid->getResolution(), cellLabels, pointLabels);
+
+    return static_cast<std::int32_t>(peaks.size());
+}
+
+Bins::Shape ViewerScatterplotWidget::getBinShape() const
+{
+    return _binShape;
+}
+
+void ViewerScatterplotWidget::setBinShape(const Bins::Shape& binShape)
+{
+    if (binShape == _binShape)
+        return;
+
+    _binShape = binShape;
+
+    // The bins (if out of date) are aggregated when the next frame is drawn
+    update();
+}
+
+std::uint32_t ViewerScatterplotWidget::getBinResolution() const
+{
+    return _binResolution;
+}
+
+void ViewerScatterplotWidget::setBinResolution(const std::uint32_t& binResolution)
+{
+    if (binResolution == _binResolution)
+        return;
+
+    _binResolution = binResolution;
+
+    update();
+}
+
+BinAggregator::Statistic ViewerScatterplotWidget::getBinStatistic() const
+{
+    return _binStatistic;
+}
+
+void ViewerScatterplotWidget::setBinStatistic(const BinAggregator::Statistic& binStatistic)
+{
+    if (binStatistic == _binStatistic)
+        return;
+
+    _binStatistic = binStatistic;
+
+    update();
+}
+
+void ViewerScatterplotWidget::setBinValues(const std::vector<float>& values)
+{
+    _binValues = values;
+
+    // Each set of values gets a new version (version zero is reserved for no values)
+    _binValuesVersion = ++_numberOfBinValuesUpdates;
+
+    update();
+}
+
+void ViewerScatterplotWidget::clearBinValues()
+{
+    if (_binValuesVersion == 0)
+        return;
+
+    _binValues.clear();
+    _binValuesVersion = 0;
+
+    update();
+}
+
+bool ViewerScatterplotWidget::hasBinValues() const
+{
+    return _binValuesVersion > 0;
+}
+
+ViewerScatterplotWidget::BinInputs ViewerScatterplotWidget::getBinInputs() const
+{
+    return { _positionsVersion, _binValuesVersion, _dataBounds.getLeft(), _dataBounds.getRight(), _dataBounds.getBottom(), _dataBounds.getTop(), _binShape, _binResolution, _binStatistic };
+}
+
+std::shared_ptr<const Bins> ViewerScatterplotWidget::getBins()
+{
+    const auto binInputs = getBinInputs();
+
+    if (_bins && binInputs == _binsInputs)
+        return _bins;
+
+    auto bins = std::make_shared<Bins>();
+
+    if (_positions != nullptr)
+        BinAggregator::aggregate(*_positions, _dataBounds, _binShape, _binResolution, _binStatistic, _binValuesVersion > 0 ? &_binValues : nullptr, *bins);
+
+    _bins       = bins;
+    _binsInputs = binInputs;
+
+    // Color the full range of the new bins until the color map range is set
+    _binColorMapRange = Vector3f(_bins->_minimum, _bins->_maximum, _bins->_maximum - _bins->_minimum);
+
+    emit binsChanged();
+
+    return _bins;
+}
+
+PixelAggregator::Normalization ViewerScatterplotWidget::getPixelNormalization() const
+{
+    return _pixelNormalization;
+}
+
+void ViewerScatterplotWidget::setPixelNormalization(const PixelAggregator::Normalization& pixelNormalization)
+{
+    if (pixelNormalization == _pixelNormalization)
+        return;
+
+    _pixelNormalization = pixelNormalization;
+
+    // Only the shading depends on the normalization
+    _shadedImage = QImage();
 
     update();
 }
 
-QColor ViewerScatterplotWidget::getBackgroundColor()
+bool ViewerScatterplotWidget::getPixelPointColors() const
 {
-    return _backgroundColor;
+    return _pixelPointColors;
 }
 
-void ViewerScatterplotWidget::setBackgroundColor(QColor color)
+void ViewerScatterplotWidget::setPixelPointColors(bool pixelPointColors)
 {
-    _backgroundColor = color;
+    if (pixelPointColors == _pixelPointColors)
+        return;
+
+    _pixelPointColors = pixelPointColors;
 
     update();
 }
 
-void ViewerScatterplotWidget::setHighlights(const std::vector<char>& highlights, const std::int32_t& numSelectedPoints)
+void ViewerScatterplotWidget::setRetainPointData(bool retainPointData)
 {
-    _pointRenderer.setHighlights(highlights, numSelectedPoints);
+    if (retainPointData == _retainPointData)
+        return;
 
-    update();
+    const auto pointDataRetained = isPointDataRetained();
+
+    _retainPointData = retainPointData;
+
+    updatePointDataRetention(pointDataRetained);
 }
 
-void ViewerScatterplotWidget::setScalars(const std::vector<float>& scalars)
+bool ViewerScatterplotWidget::isPointDataRetained() const
 {
-    _pointRenderer.setColorChannelScalars(scalars);
-    
-    update();
+    return _renderMode == SHADED || _pointBackend == PointBackend::CPU || _retainPointData;
 }
 
-void ViewerScatterplotWidget::setColors(const std::vector<Vector3f>& colors)
+void ViewerScatterplotWidget::updatePointDataRetention(bool pointDataRetained)
 {
-    _pointRenderer.setColors(colors);
-    _pointRenderer.setScalarEffect(None);
+    if (isPointDataRetained() == pointDataRetained)
+        return;
 
-    update();
+    // The colors/scalars were not kept, so they have to be set again
+    if (isPointDataRetained()) {
+        emit pointDataRequired();
+        return;
+    }
+
+    // Release the copies of the colors/scalars
+    std::vector<float>().swap(_pointScalars);
+    std::vector<std::uint32_t>().swap(_pointColors);
+
+    _pointColorsVersion++;
 }
 
-void ViewerScatterplotWidget::setPointSizeScalars(const std::vector<float>& pointSizeScalars)
+SoftwarePoints ViewerScatterplotWidget::getSoftwarePoints() const
 {
-    _pointRenderer.setSizeChannelScalars(pointSizeScalars);
-    _pointRenderer.setPointSize(*std::max_element(pointSizeScalars.begin(), pointSizeScalars.end()));
+    SoftwarePoints softwarePoints;
 
-    update();
+    softwarePoints._positions       = _positions;
+    softwarePoints._colorScalars    = &_pointScalars;
+    softwarePoints._colors          = &_pointColors;
+    softwarePoints._sizeSources     = _pointSizeSources;
+    softwarePoints._opacitySources  = _pointOpacitySources;
+    softwarePoints._highlights      = _pointHighlights;
+
+    return softwarePoints;
 }
 
-void ViewerScatterplotWidget::setPointOpacityScalars(const std::vector<float>& pointOpacityScalars)
+PixelAggregator::Shading ViewerScatterplotWidget::getPixelShading() const
 {
-    _pointRenderer.setOpacityChannelScalars(pointOpacityScalars);
+    if (!_pixelPointColors || _coloringMode != ColoringMode::Data)
+        return PixelAggregator::Shading::Count;
 
-    update();
+    return _pointShading;
 }
 
-void ViewerScatterplotWidget::setPointScaling(hdps::gui::PointScaling scalingMode)
+float ViewerScatterplotWidget::getMinDensity() const
 {
-    _pointRenderer.setPointScaling(scalingMode);
+    switch (_densityBackend)
+    {
+        case DensityBackend::GPU:
+            return 0.0f;
+
+        case DensityBackend::CPU:
+            return _densityGrid ? _densityGrid->getMinimum() : 0.0f;
+    }
+
+    return 0.0f;
 }
 
-void ViewerScatterplotWidget::setScalarEffect(PointEffect effect)
+float ViewerScatterplotWidget::getMaxDensity() const
 {
-    _pointRenderer.setScalarEffect(effect);
+    switch (_densityBackend)
+    {
+        case DensityBackend::GPU:
+            return _densityRenderer.getMaxDensity();
 
-    update();
+        case DensityBackend::CPU:
+            return _densityGrid ? _densityGrid->getMaximum() : 0.0f;
+    }
+
+    return 0.0f;
 }
 
-void ViewerScatterplotWidget::setSigma(const float sigma)
+bool ViewerScatterplotWidget::isSoftwareRenderer() const
 {
-    _densityRenderer.setSigma(sigma);
-
-    update();
+    return _isSoftwareRenderer;
 }
 
 hdps::Vector3f ViewerScatterplotWidget::getColorMapRange() const
 {
     switch (_renderMode) {
         case SCATTERPLOT:
-            return _pointRenderer.getColorMapRange();
+        case SHADED:
+            return _softwarePointSettings._colorMapRange;
 
         case LANDSCAPE:
-            return _densityRenderer.getColorMapRange();
+            return _densityBackend == DensityBackend::CPU ? _densityColorMapRange : _densityRenderer.getColorMapRange();
+
+        case BINNED:
+            return _binColorMapRange;
 
         default:
             break;
@@ -284,13 +950,35 @@ void ViewerScatterplotWidget::setColorMapRange(const float& min, const float& ma
     switch (_renderMode) {
         case SCATTERPLOT:
         {
-            _pointRenderer.setColorMapRange(min, max);
+            _softwarePointSettings._colorMapRange = Vector3f(min, max, max - min);
+            _pointLayerOutOfDate = true;
+            break;
+        }
+
+        case SHADED:
+        {
+            _softwarePointSettings._colorMapRange = Vector3f(min, max, max - min);
+            _shadedImage = QImage();
+            _pointLayerOutOfDate = true;
             break;
         }
 
         case LANDSCAPE:
         {
-            _densityRenderer.setColorMapRange(min, max);
+            if (_densityBackend == DensityBackend::CPU) {
+                _densityColorMapRange   = Vector3f(min, max, max - min);
+                _densityImage           = QImage();
+            }
+            else {
+                _densityRenderer.setColorMapRange(min, max);
+            }
+
+            break;
+        }
+
+        case BINNED:
+        {
+            _binColorMapRange = Vector3f(min, max, max - min);
             break;
         }
 
@@ -301,160 +989,125 @@ void ViewerScatterplotWidget::setColorMapRange(const float& min, const float& ma
     update();
 }
 
-void ViewerScatterplotWidget::createScreenshot(std::int32_t width, std::int32_t height, const QString& fileName, const QColor& backgroundColor)
+PlotImageExporter& ViewerScatterplotWidget::getImageExporter()
 {
-    // Exit if the viewer is not initialized
-    if (!_isInitialized)
-        return;
-
-    // Exit prematurely if the file name is invalid
-    if (fileName.isEmpty())
-        return;
-
-    makeCurrent();
-
-    try {
-
-        // Use custom FBO format
-        QOpenGLFramebufferObjectFormat fboFormat;
-        
-        fboFormat.setTextureTarget(GL_TEXTURE_2D);
-        fboFormat.setInternalTextureFormat(GL_RGB);
+    return _imageExporter;
+}
 
-        QOpenGLFramebufferObject fbo(width, height, fboFormat);
+QByteArray ViewerScatterplotWidget::getImageDataHash() const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
 
-        // Bind the FBO and render into it when successfully bound
-        if (fbo.bind()) {
+    // Add the raw bytes of a vector (without copying them)
+    const auto addVector = [&hash](const auto& values) -> void {
+        hash.addData(QByteArray::fromRawData(reinterpret_cast<const char*>(values.data()), static_cast<qsizetype>(values.size() * sizeof(values.front()))));
+    };
 
-            // Clear the widget to the background color
-            glClearColor(backgroundColor.redF(), backgroundColor.greenF(), backgroundColor.blueF(), backgroundColor.alphaF());
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    const std::vector<float> bounds{ _dataBounds.getLeft(), _dataBounds.getRight(), _dataBounds.getBottom(), _dataBounds.getTop() };
 
-            // Reset the blending function
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    hash.addData(QByteArray::number(static_cast<int>(_renderMode)));
+    hash.addData(QByteArray::fromRawData(reinterpret_cast<const char*>(_colorMapImage.constBits()), _colorMapImage.sizeInBytes()));
 
-            // Resize OpenGL to intended screenshot size
-            resizeGL(width, height);
+    addVector(bounds);
 
-            switch (_renderMode)
-            {
-                case SCATTERPLOT:
-                {
-                    _pointRenderer.setPointScaling(Relative);
-                    _pointRenderer.render();
-                    _pointRenderer.setPointScaling(Absolute);
+    if (_positions != nullptr)
+        addVector(*_positions);
 
-                    break;
-                }
+    addVector(_pointColors);
 
-                case DENSITY:
-                case LANDSCAPE:
-                    _densityRenderer.setRenderMode(_renderMode == DENSITY ? DensityRenderer::DENSITY : DensityRenderer::LANDSCAPE);
-                    _densityRenderer.render();
-                    break;
-            }
+    if (_pointHighlights != nullptr)
+        addVector(*_pointHighlights);
 
-            // Save FBO image to disk
-            //fbo.toImage(false, QImage::Format_RGB32).convertToFormat(QImage::Format_RGB32).save(fileName);
-            //fbo.toImage(false, QImage::Format_ARGB32).save(fileName);
+    const auto& sizeMapping     = _softwarePointSettings._sizeMapping;
+    const auto& opacityMapping  = _softwarePointSettings._opacityMapping;
 
-            QImage fboImage(fbo.toImage());
-            QImage image(fboImage.constBits(), fboImage.width(), fboImage.height(), QImage::Format_ARGB32);
+    addVector(std::vector<float>{ sizeMapping._offset, sizeMapping._scale, sizeMapping._selectionOffset, opacityMapping._offset, opacityMapping._scale, opacityMapping._selectionOffset });
 
-            image.save(fileName);
+    if (_pointSizeSources != nullptr)
+        addVector(*_pointSizeSources);
 
-            // Resize OpenGL back to original OpenGL widget size
-            resizeGL(this->width(), this->height());
+    if (_pointOpacitySources != nullptr)
+        addVector(*_pointOpacitySources);
 
-            fbo.release();
-        }
-    }
-    catch (std::exception& e)
-    {
-        exceptionMessageBox("Rendering failed", e);
-    }
-    catch (...) {
-        exceptionMessageBox("Rendering failed");
-    }
+    return hash.result();
 }
 
 PointSelectionDisplayMode ViewerScatterplotWidget::getSelectionDisplayMode() const
 {
-    return _pointRenderer.getSelectionDisplayMode();
+    return _softwarePointSettings._selectionDisplayMode;
 }
 
 void ViewerScatterplotWidget::setSelectionDisplayMode(PointSelectionDisplayMode selectionDisplayMode)
 {
-    _pointRenderer.setSelectionDisplayMode(selectionDisplayMode);
+    _softwarePointSettings._selectionDisplayMode = selectionDisplayMode;
 
-    update();
+    updatePointLayer();
 }
 
 QColor ViewerScatterplotWidget::getSelectionOutlineColor() const
 {
     QColor haloColor;
 
-    haloColor.setRedF(_pointRenderer.getSelectionOutlineColor().x);
-    haloColor.setGreenF(_pointRenderer.getSelectionOutlineColor().y);
-    haloColor.setBlueF(_pointRenderer.getSelectionOutlineColor().z);
+    haloColor.setRedF(_softwarePointSettings._selectionOutlineColor.x);
+    haloColor.setGreenF(_softwarePointSettings._selectionOutlineColor.y);
+    haloColor.setBlueF(_softwarePointSettings._selectionOutlineColor.z);
 
     return haloColor;
 }
 
 void ViewerScatterplotWidget::setSelectionOutlineColor(const QColor& selectionOutlineColor)
 {
-    _pointRenderer.setSelectionOutlineColor(Vector3f(selectionOutlineColor.redF(), selectionOutlineColor.greenF(), selectionOutlineColor.blueF()));
+    _softwarePointSettings._selectionOutlineColor = Vector3f(selectionOutlineColor.redF(), selectionOutlineColor.greenF(), selectionOutlineColor.blueF());
 
-    update();
+    updatePointLayer();
 }
 
 bool ViewerScatterplotWidget::getSelectionOutlineOverrideColor() const
 {
-    return _pointRenderer.getSelectionOutlineOverrideColor();
+    return _softwarePointSettings._selectionOutlineOverride;
 }
 
 void ViewerScatterplotWidget::setSelectionOutlineOverrideColor(bool selectionOutlineOverrideColor)
 {
-    _pointRenderer.setSelectionOutlineOverrideColor(selectionOutlineOverrideColor);
+    _softwarePointSettings._selectionOutlineOverride = selectionOutlineOverrideColor;
 
-    update();
+    updatePointLayer();
 }
 
 float ViewerScatterplotWidget::getSelectionOutlineScale() const
 {
-    return _pointRenderer.getSelectionOutlineScale();
+    return _softwarePointSettings._selectionOutlineScale;
 }
 
 void ViewerScatterplotWidget::setSelectionOutlineScale(float selectionOutlineScale)
 {
-    _pointRenderer.setSelectionOutlineScale(selectionOutlineScale);
+    _softwarePointSettings._selectionOutlineScale = selectionOutlineScale;
 
-    update();
+    updatePointLayer();
 }
 
 float ViewerScatterplotWidget::getSelectionOutlineOpacity() const
 {
-    return _pointRenderer.getSelectionOutlineOpacity();
+    return _softwarePointSettings._selectionOutlineOpacity;
 }
 
 void ViewerScatterplotWidget::setSelectionOutlineOpacity(float selectionOutlineOpacity)
 {
-    _pointRenderer.setSelectionOutlineOpacity(selectionOutlineOpacity);
+    _softwarePointSettings._selectionOutlineOpacity = selectionOutlineOpacity;
 
-    update();
+    updatePointLayer();
 }
 
 bool ViewerScatterplotWidget::getSelectionOutlineHaloEnabled() const
 {
-    return _pointRenderer.getSelectionHaloEnabled();
+    return _softwarePointSettings._selectionHaloEnabled;
 }
 
 void ViewerScatterplotWidget::setSelectionOutlineHaloEnabled(bool selectionOutlineHaloEnabled)
 {
-    _pointRenderer.setSelectionHaloEnabled(selectionOutlineHaloEnabled);
+    _softwarePointSettings._selectionHaloEnabled = selectionOutlineHaloEnabled;
 
-    update();
+    updatePointLayer();
 }
 
 void ViewerScatterplotWidget::initializeGL()
@@ -474,11 +1127,24 @@ void ViewerScatterplotWidget::initializeGL()
     // Initialize renderers
     _pointRenderer.init();
     _densityRenderer.init();
+    _imageExporter.init();
 
-    // Set a default color map for both renderers
-    _pointRenderer.setScalarEffect(PointEffect::Color);
+    // Build the program which composites the cached point layer (the points are rendered directly when it fails)
+    auto compositeProgram = std::make_unique<QOpenGLShaderProgram>();
 
-    _pointRenderer.setSelectionOutlineColor(Vector3f(1, 0, 0));
+    if (compositeProgram->addShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/Composite.vert") && compositeProgram->addShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/Composite.frag") && compositeProgram->link())
+        _compositeProgram = std::move(compositeProgram);
+    else
+        qWarning() << "Unable to build the point layer composite program, points are rendered each frame";
+
+    glGenVertexArrays(1, &_compositeVertexArray);
+
+    // Establish whether OpenGL is implemented in software
+    const auto rendererName = QString(reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+
+    for (const auto& softwareRendererName : QStringList({ "llvmpipe", "softpipe", "SwiftShader", "Software Rasterizer", "Microsoft Basic Render" }))
+        if (rendererName.contains(softwareRendererName, Qt::CaseInsensitive))
+            _isSoftwareRenderer = true;
 
     // OpenGL is initialized
     _isInitialized = true;
@@ -494,9 +1160,11 @@ void ViewerScatterplotWidget::resizeGL(int w, int h)
     _windowSize.setWidth(w);
     _windowSize.setHeight(h);
 
-    _pointRenderer.resize(QSize(w, h));
     _densityRenderer.resize(QSize(w, h));
 
+    // The point layer has the size of the viewport
+    _pointLayerOutOfDate = true;
+
     // Set matrix for normalizing from pixel coordinates to [0, 1]
     toNormalisedCoordinates = Matrix3f(1.0f / w, 0, 0, 1.0f / h, 0, 0);
 
@@ -514,6 +1182,15 @@ void ViewerScatterplotWidget::resizeGL(int w, int h)
 void ViewerScatterplotWidget::paintGL()
 {
     try {
+        // Compute the density lazily, only when a density frame is actually drawn and its inputs changed
+        if (isDensityRenderMode() && isDensityOutOfDate()) {
+            updateDensity();
+
+            // The density renderer renders into its own framebuffer, so restore the widget framebuffer and viewport
+            glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebufferObject());
+            glViewport(0, 0, static_cast<GLsizei>(width() * devicePixelRatioF()), static_cast<GLsizei>(height() * devicePixelRatioF()));
+        }
+
         const auto areaPixmap   = _pixelSelectionTool.getAreaPixmap();
         const auto shapePixmap  = _pixelSelectionTool.getShapePixmap();
 
@@ -540,18 +1217,51 @@ void ViewerScatterplotWidget::paintGL()
             switch (_renderMode)
             {
                 case SCATTERPLOT:
-                    _pointRenderer.render();
+                {
+                    // The CPU points are drawn with the painter below
+                    if (_pointBackend == PointBackend::GPU)
+                        drawPointLayer();
+
                     break;
+                }
 
                 case DENSITY:
                 case LANDSCAPE:
+                {
+                    // The CPU density is drawn with the painter below
+                    if (_densityBackend == DensityBackend::CPU)
+                        break;
+
                     _densityRenderer.setRenderMode(_renderMode == DENSITY ? DensityRenderer::DENSITY : DensityRenderer::LANDSCAPE);
                     _densityRenderer.render();
                     break;
+                }
+
+                // The aggregate bins are drawn with the painter below
+                default:
+                    break;
             }
                 
         }
         painter.endNativePainting();
+
+        // Draw the points rendered by the CPU backend
+        if (_renderMode == SCATTERPLOT && _pointBackend == PointBackend::CPU)
+            drawSoftwarePoints(painter, size(), rect(), 1.0f);
+
+        // Draw the density computed by the CPU backend
+        if (_densityBackend == DensityBackend::CPU && isDensityRenderMode()) {
+            drawDensityImage(painter, size());
+            drawContours(painter, size());
+        }
+
+        // Draw the aggregate bins
+        if (_renderMode == BINNED)
+            drawBins(painter, size());
+
+        // Draw the points aggregated per pixel
+        if (_renderMode == SHADED)
+            drawShadedImage(painter, size());
         
         // Draw the pixel selection tool overlays if the pixel selection tool is enabled
         if (_pixelSelectionTool.isEnabled()) {
@@ -570,6 +1280,310 @@ void ViewerScatterplotWidget::paintGL()
     }
 }
 
+void ViewerScatterplotWidget::updatePointLayer()
+{
+    _pointLayerOutOfDate = true;
+
+    update();
+}
+
+void ViewerScatterplotWidget::makePointRendererCurrent()
+{
+    if (_isInitialized)
+        makeCurrent();
+}
+
+void ViewerScatterplotWidget::drawPointLayer()
+{
+    // Render the points directly when the layer cannot be composited
+    const QSize layerSize(static_cast<int>(width() * devicePixelRatioF()), static_cast<int>(height() * devicePixelRatioF()));
+
+    // The points are rendered at the device pixel resolution
+    const auto dataRectangle = getDataRectangle(size());
+    const QRectF deviceDataRectangle(dataRectangle.left() * devicePixelRatioF(), dataRectangle.top() * devicePixelRatioF(), dataRectangle.width() * devicePixelRatioF(), dataRectangle.height() * devicePixelRatioF());
+
+    if (!_compositeProgram) {
+        _pointRenderer.render(_softwarePointSettings, layerSize, deviceDataRectangle, static_cast<float>(devicePixelRatioF()));
+        return;
+    }
+
+    // (Re)create the layer when the viewport size changed
+    if (!_pointLayerFramebuffer || _pointLayerFramebuffer->size() != layerSize) {
+
+        // The points are rendered with the anti-aliasing of the widget into a multisampled framebuffer
+        if (format().samples() > 0) {
+            QOpenGLFramebufferObjectFormat multisampleFormat;
+
+            multisampleFormat.setSamples(format().samples());
+            multisampleFormat.setInternalTextureFormat(GL_RGBA8);
+            multisampleFormat.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+
+            _pointLayerMultisampleFramebuffer = std::make_unique<QOpenGLFramebufferObject>(layerSize, multisampleFormat);
+        }
+        else {
+            _pointLayerMultisampleFramebuffer.reset();
+        }
+
+        // Which is resolved into the texture of the layer
+        QOpenGLFramebufferObjectFormat fboFormat;
+
+        fboFormat.setTextureTarget(GL_TEXTURE_2D);
+        fboFormat.setInternalTextureFormat(GL_RGBA8);
+        fboFormat.setAttachment(_pointLayerMultisampleFramebuffer ? QOpenGLFramebufferObject::NoAttachment : QOpenGLFramebufferObject::CombinedDepthStencil);
+
+        _pointLayerFramebuffer  = std::make_unique<QOpenGLFramebufferObject>(layerSize, fboFormat);
+        _pointLayerOutOfDate    = true;
+    }
+
+    auto& renderFramebuffer = _pointLayerMultisampleFramebuffer ? *_pointLayerMultisampleFramebuffer : *_pointLayerFramebuffer;
+
+    // Render the points into the layer, premultiplied (independent of the background) or over the background
+    const auto renderPointLayer = [this, &renderFramebuffer, &layerSize, &deviceDataRectangle]() -> void {
+        if (_pointLayerPremultiplied) {
+            glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            // Blend the alpha separately, so that the layer holds premultiplied colors which can be composited over any background
+            glEnable(GL_BLEND);
+            glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        }
+        else {
+            glClearColor(_backgroundColor.redF(), _backgroundColor.greenF(), _backgroundColor.blueF(), _backgroundColor.alphaF());
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        }
+
+        _pointRenderer.render(_softwarePointSettings, layerSize, deviceDataRectangle, static_cast<float>(devicePixelRatioF()));
+    };
+
+    // Only render the points when their inputs changed (not for overlay changes, nor for background changes of a premultiplied layer)
+    if (_pointLayerOutOfDate && renderFramebuffer.bind()) {
+        renderPointLayer();
+
+        // The layer is only premultiplied when the point renderer kept the blend function, otherwise it is rendered over the background
+        if (_pointLayerPremultiplied) {
+            GLint sourceAlpha = 0, destinationAlpha = 0;
+
+            glGetIntegerv(GL_BLEND_SRC_ALPHA, &sourceAlpha);
+            glGetIntegerv(GL_BLEND_DST_ALPHA, &destinationAlpha);
+
+            if (!glIsEnabled(GL_BLEND) || sourceAlpha != GL_ONE || destinationAlpha != GL_ONE_MINUS_SRC_ALPHA) {
+                qWarning() << "The point renderer changes the blend function, the point layer is rendered over the background";
+
+                _pointLayerPremultiplied = false;
+
+                renderPointLayer();
+            }
+        }
+
+        // Resolve the multisampled points into the layer texture
+        if (_pointLayerMultisampleFramebuffer)
+            QOpenGLFramebufferObject::blitFramebuffer(_pointLayerFramebuffer.get(), _pointLayerMultisampleFramebuffer.get());
+
+        glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebufferObject());
+
+        _pointLayerOutOfDate = false;
+    }
+
+    // Composite the premultiplied point layer over the background (or replace the background by the layer which includes it)
+    if (_pointLayerPremultiplied)
+        glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    else
+        glDisable(GL_BLEND);
+
+    _compositeProgram->bind();
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, _pointLayerFramebuffer->texture());
+
+    _compositeProgram->setUniformValue("layerTexture", 0);
+
+    // The vertices of the full screen quad are generated in the vertex shader
+    glBindVertexArray(_compositeVertexArray);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+    glBindVertexArray(0);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    _compositeProgram->release();
+
+    // Reset the blending function
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void ViewerScatterplotWidget::drawDensityImage(QPainter& painter, const QSize& viewportSize)
+{
+    if (!_densityGrid || !_densityGrid->isValid())
+        return;
+
+    // Convert the density grid to an image (only when the grid, color map or range changed)
+    if (_densityImage.isNull())
+        _densityImage = createDensityImage(*_densityGrid, _densityColorMapRange);
+
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.drawImage(getDataRectangle(viewportSize), _densityImage);
+}
+
+QImage ViewerScatterplotWidget::createDensityImage(const DensityGrid& densityGrid, const Vector3f& colorMapRange) const
+{
+    if (_renderMode == LANDSCAPE)
+        return densityGrid.toLandscapeImage(_colorMapImage, colorMapRange.x, colorMapRange.y);
+
+    if (_densityComputation.getSource() == DensitySource::Difference)
+        return densityGrid.toDifferenceImage(QColor(0, 90, 200), QColor(200, 30, 30));
+
+    return densityGrid.toDensityImage(QColor(Qt::black));
+}
+
+void ViewerScatterplotWidget::drawContours(QPainter& painter, const QSize& viewportSize)
+{
+    if (_numberOfContourLevels == 0 || getContours()->empty())
+        return;
+
+    painter.save();
+
+    // The path is in data coordinates, the cosmetic pen keeps the line width in pixels
+    QPen pen(QColor(0, 0, 0, 160), 1.0);
+
+    pen.setCosmetic(true);
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setTransform(getDataToViewportTransform(viewportSize), true);
+    painter.setPen(pen);
+    painter.setBrush(Qt::NoBrush);
+    painter.drawPath(_contoursPath);
+    painter.restore();
+}
+
+void ViewerScatterplotWidget::drawBins(QPainter& painter, const QSize& viewportSize)
+{
+    const auto bins = getBins();
+
+    if (!bins->isValid() || _colorMapImage.isNull())
+        return;
+
+    // Sample the color map along the center row (once per color map texel)
+    const auto colorMapWidth    = _colorMapImage.width();
+    const auto colorMapRow      = _colorMapImage.height() / 2;
+
+    std::vector<QColor> lookupTable(colorMapWidth);
+
+    for (int colorMapIndex = 0; colorMapIndex < colorMapWidth; colorMapIndex++)
+        lookupTable[colorMapIndex] = QColor(_colorMapImage.pixel(colorMapIndex, colorMapRow));
+
+    // Prevent zero division for an empty range
+    const auto normalization = _binColorMapRange.z > 0.0f ? 1.0f / _binColorMapRange.z : 0.0f;
+
+    painter.save();
+
+    // The bin polygons are in data coordinates
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.setTransform(getDataToViewportTransform(viewportSize), true);
+    painter.setPen(Qt::NoPen);
+
+    // Empty bins are not drawn, so the number of drawn polygons is bounded by the number of bins
+    for (std::size_t binIndex = 0; binIndex < bins->_counts.size(); binIndex++) {
+        if (bins->_counts[binIndex] == 0)
+            continue;
+
+        const auto normalizedValue  = std::clamp((bins->_values[binIndex] - _binColorMapRange.x) * normalization, 0.0f, 1.0f);
+        const auto colorMapIndex    = std::min(colorMapWidth - 1, static_cast<int>(normalizedValue * colorMapWidth));
+
+        painter.setBrush(lookupTable[colorMapIndex]);
+        painter.drawPolygon(bins->getPolygon(binIndex));
+    }
+
+    painter.restore();
+}
+
+void ViewerScatterplotWidget::drawShadedImage(QPainter& painter, const QSize& viewportSize)
+{
+    if (_positions == nullptr)
+        return;
+
+    const auto dataRectangle = getDataRectangle(viewportSize);
+
+    // One grid cell per device pixel of the data rectangle (limited for very large exports, the image is scaled up)
+    const auto devicePixelRatio = painter.device()->devicePixelRatioF();
+
+    const auto width    = std::min(MAXIMUM_PIXEL_AGGREGATE_SIZE, static_cast<std::uint32_t>(std::lround(dataRectangle.width() * devicePixelRatio)));
+    const auto height   = std::min(MAXIMUM_PIXEL_AGGREGATE_SIZE, static_cast<std::uint32_t>(std::lround(dataRectangle.height() * devicePixelRatio)));
+    const auto shading  = getPixelShading();
+
+    const PixelAggregateInputs pixelAggregateInputs{ _positionsVersion, _pointColorsVersion, _dataBounds.getLeft(), _dataBounds.getRight(), _dataBounds.getBottom(), _dataBounds.getTop(), width, height, shading };
+
+    // Aggregate the points again only when the positions, colors, bounds or viewport size changed
+    if (!(pixelAggregateInputs == _pixelAggregateInputs)) {
+        const auto scalars  = shading == PixelAggregator::Shading::Scalar ? &_pointScalars : nullptr;
+        const auto colors   = shading == PixelAggregator::Shading::Color ? &_pointColors : nullptr;
+
+        PixelAggregator::aggregate(*_positions, _dataBounds, width, height, scalars, colors, _pixelAggregate);
+
+        _pixelAggregateInputs   = pixelAggregateInputs;
+        _shadedImage            = QImage();
+    }
+
+    // Shade the aggregate (only when the aggregate, color map, range or normalization changed)
+    if (_shadedImage.isNull()) {
+        _shadedImage = PixelAggregator::shade(_pixelAggregate, shading, _pixelNormalization, _colorMapImage, _softwarePointSettings._colorMapRange);
+
+        _shadedImage.setDevicePixelRatio(devicePixelRatio);
+    }
+
+    painter.drawImage(dataRectangle, _shadedImage);
+}
+
+void ViewerScatterplotWidget::drawSoftwarePoints(QPainter& painter, const QSize& viewportSize, const QRect& viewportRegion, const float& pointScale)
+{
+    if (_positions == nullptr || viewportRegion.isEmpty())
+        return;
+
+    // Render the region at the device pixel resolution
+    const auto devicePixelRatio = painter.device()->devicePixelRatioF();
+    const auto dataRectangle    = getDataRectangle(viewportSize).translated(-viewportRegion.topLeft());
+
+    QImage image(viewportRegion.size() * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+
+    image.fill(Qt::transparent);
+
+    const QRectF deviceDataRectangle(dataRectangle.left() * devicePixelRatio, dataRectangle.top() * devicePixelRatio, dataRectangle.width() * devicePixelRatio, dataRectangle.height() * devicePixelRatio);
+
+    SoftwarePointRenderer::render(getSoftwarePoints(), _softwarePointSettings, image, deviceDataRectangle, static_cast<float>(devicePixelRatio) * pointScale);
+
+    image.setDevicePixelRatio(devicePixelRatio);
+
+    painter.drawImage(viewportRegion.topLeft(), image);
+}
+
+bool ViewerScatterplotWidget::isDensityRenderMode() const
+{
+    return _renderMode == DENSITY || _renderMode == LANDSCAPE;
+}
+
+QRect ViewerScatterplotWidget::getDataRectangle(const QSize& viewportSize) const
+{
+    // The (square) data bounds are centered in the viewport
+    const auto size = std::min(viewportSize.width(), viewportSize.height());
+
+    return QRect((viewportSize.width() - size) / 2, (viewportSize.height() - size) / 2, size, size);
+}
+
+QTransform ViewerScatterplotWidget::getDataToViewportTransform(const QSize& viewportSize) const
+{
+    const auto dataRectangle = getDataRectangle(viewportSize);
+
+    if (_dataBounds.getWidth() <= 0.0f || _dataBounds.getHeight() <= 0.0f)
+        return QTransform();
+
+    const auto scaleX = dataRectangle.width() / _dataBounds.getWidth();
+    const auto scaleY = dataRectangle.height() / _dataBounds.getHeight();
+
+    return QTransform(scaleX, 0.0, 0.0, -scaleY, dataRectangle.left() - _dataBounds.getLeft() * scaleX, dataRectangle.top() + _dataBounds.getTop() * scaleY);
+}
+
 void ViewerScatterplotWidget::cleanup()
 {
     qDebug() << "Deleting viewerscatterplot widget, performing clean up...";
@@ -578,12 +1592,26 @@ void ViewerScatterplotWidget::cleanup()
     makeCurrent();
     _pointRenderer.destroy();
     _densityRenderer.destroy();
+    _imageExporter.destroy();
+    _pointLayerFramebuffer.reset();
+    _pointLayerMultisampleFramebuffer.reset();
+    _compositeProgram.reset();
+
+    glDeleteVertexArrays(1, &_compositeVertexArray);
+
+    _compositeVertexArray = 0;
 }
 
 void ViewerScatterplotWidget::setColorMap(const QImage& colorMapImage)
 {
     _colorMapImage = colorMapImage;
 
+    _softwarePointSettings._colorMapImage = _colorMapImage;
+
+    // The cached density landscape and shaded images are out of date
+    _densityImage = QImage();
+    _shadedImage  = QImage();
+
     // Do not update color maps of the renderers when OpenGL is not initialized
     if (!_isInitialized)
         return;
@@ -592,11 +1620,11 @@ void ViewerScatterplotWidget::setColorMap(const QImage& colorMapImage)
     makeCurrent();
 
     // Apply color maps to renderers
-    _pointRenderer.setColormap(_colorMapImage);
+    _pointRenderer.setColorMap(_colorMapImage);
     _densityRenderer.setColormap(_colorMapImage);
 
     // Render
-    update();
+    updatePointLayer();
 }
 
 ViewerScatterplotWidget::~ViewerScatterplotWidget()
@@ -4,6 +4,17 @@
 #include "renderers/DensityRenderer.h"
 #include "util/PixelSelectionTool.h"
 
+#include "DensityGrid.h"
+#include "DensityComputation.h"
+#include "ContourExtractor.h"
+#include "DensityRegionLabels.h"
+#include "DensityPeakClustering.h"
+#include "BinAggregator.h"
+#include "PixelAggregator.h"
+#include "SoftwarePointRenderer.h"
+#include "MappedPointRenderer.h"
+#include "PlotImageExporter.h"
+
 #include "graphics/Vector2f.h"
 #include "graphics/Vector3f.h"
 #include "graphics/Matrix3f.h"
@@ -12,9 +23,16 @@
 
 #include <QOpenGLWidget>
 #include <QOpenGLFunctions_3_3_Core>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLShaderProgram>
 
 #include <QMouseEvent>
 #include <QMenu>
+#include <QPainter>
+#include <QPainterPath>
+#include <QTransform>
+
+#include <memory>
 
 using namespace hdps;
 using namespace hdps::gui;
@@ -28,7 +46,9 @@ public:
     enum RenderMode {
         SCATTERPLOT,
         DENSITY,
-        LANDSCAPE
+        LANDSCAPE,
+        BINNED,
+        SHADED
     };
 
     /** The way that point colors are determined */
@@ -38,6 +58,21 @@ public:
         Scatter,       /** Determined by scatter layout using a 2D colormap */
     };
 
+    /** Where the density (for the density and landscape render modes) is computed */
+    enum class DensityBackend {
+        GPU,           /** Density renderer (OpenGL) */
+        CPU,           /** Multi-threaded kernel density estimator */
+    };
+
+    /** Where the points (for the scatterplot render mode) are rendered */
+    enum class PointBackend {
+        GPU,           /** Point renderer (OpenGL) */
+        CPU,           /** Multi-threaded software point renderer */
+    };
+
+    /** Which points contribute to the density (other than All requires the CPU density backend) */
+    using DensitySource = DensityComputation::Source;
+
 public:
     ViewerScatterplotWidget();
     ~ViewerScatterplotWidget();
@@ -62,9 +97,18 @@ public:
 
     /**
      * Feed 2-dimensional data to the viewerscatterplot.
+     * @param data Point positions (owned by the caller)
+     * @param positionsVersion Version of the positions, changes when the positions change (cached densities of other versions are discarded)
+     */
+    void setData(const std::vector<Vector2f>* data, const std::uint64_t& positionsVersion);
+
+    /**
+     * Set the selection state per point
+     * @param highlights Selection state per point (referenced, not copied, by the software point renderer so it must outlive the widget)
+     * @param numSelectedPoints Number of selected points
+     * @param changedIndices Sorted local indices of the points for which the selection state changed (only these are uploaded)
      */
-    void setData(const std::vector<Vector2f>* data);
-    void setHighlights(const std::vector<char>& highlights, const std::int32_t& numSelectedPoints);
+    void setHighlights(const std::vector<char>& highlights, const std::int32_t& numSelectedPoints, const std::vector<std::uint32_t>& changedIndices);
     void setScalars(const std::vector<float>& scalars);
 
     /**
@@ -74,19 +118,46 @@ public:
     void setColors(const std::vector<Vector3f>& colors);
 
     /**
-     * Set point size scalars
-     * @param pointSizeScalars Point size scalars
+     * Set the source scalars of the point size mapping (uploaded once, see setPointSizeMapping)
+     * @param pointSizeSources Per-point source scalars, e.g. normalized dataset values (referenced, not copied, by the software point renderer so they must outlive the widget), empty when the sizes do not depend on per-point values
+     */
+    void setPointSizeSources(const std::vector<float>& pointSizeSources);
+
+    /**
+     * Set the source scalars of the point opacity mapping (uploaded once, see setPointOpacityMapping)
+     * @param pointOpacitySources Per-point source scalars, e.g. normalized dataset values (referenced, not copied, by the software point renderer so they must outlive the widget), empty when the opacities do not depend on per-point values
+     */
+    void setPointOpacitySources(const std::vector<float>& pointOpacitySources);
+
+    /**
+     * Set the mapping of the point size source scalars and the selection to point sizes (evaluated by the point renderers, so the per-point data is not touched)
+     * @param pointSizeMapping Point size mapping (in pixels)
      */
-    void setPointSizeScalars(const std::vector<float>& pointSizeScalars);
+    void setPointSizeMapping(const PointScalarMapping& pointSizeMapping);
 
     /**
-     * Set point opacity scalars
-     * @param pointOpacityScalars Point opacity scalars (assume the values are normalized)
+     * Set the mapping of the point opacity source scalars and the selection to point opacities (evaluated by the point renderers, so the per-point data is not touched)
+     * @param pointOpacityMapping Point opacity mapping (normalized opacities)
      */
-    void setPointOpacityScalars(const std::vector<float>& pointOpacityScalars);
+    void setPointOpacityMapping(const PointScalarMapping& pointOpacityMapping);
+
+    /**
+     * Set constant point size (releases the point size source scalars)
+     * @param pointSize Point size
+     */
+    void setPointSize(const float& pointSize);
+
+    /**
+     * Set constant point opacity (releases the point opacity source scalars)
+     * @param pointOpacity Point opacity (assume the value is normalized)
+     */
+    void setPointOpacity(const float& pointOpacity);
 
     void setScalarEffect(PointEffect effect);
-    void setPointScaling(hdps::gui::PointScaling scalingMode);
+
+    /** Get/set where the points are rendered */
+    PointBackend getPointBackend() const;
+    void setPointBackend(const PointBackend& pointBackend);
 
     /**
      * Set sigma value for kernel density esitmation.
@@ -94,6 +165,119 @@ public:
      */
     void setSigma(const float sigma);
 
+    /** Get/set where the density is computed */
+    DensityBackend getDensityBackend() const;
+    void setDensityBackend(const DensityBackend& densityBackend);
+
+    /**
+     * Weigh each point by a scalar in the density (e.g. the expression of a gene), only supported by the CPU density backend
+     * @param weights Per-point weights (same size as the positions)
+     */
+    void setDensityWeights(const std::vector<float>& weights);
+
+    /** Compute the unweighted (point) density again */
+    void clearDensityWeights();
+
+    /** Get whether the density is weighted */
+    bool hasDensityWeights() const;
+
+    /** Get/set which points contribute to the density */
+    DensitySource getDensitySource() const;
+    void setDensitySource(const DensitySource& densitySource);
+
+    /**
+     * Update the selection histogram incrementally (only the points for which the selection state changed are binned)
+     * @param highlights Selection state per point
+     * @param changedIndices Local indices of the points for which the selection state changed
+     */
+    void updateDensityHighlights(const std::vector<char>& highlights, const std::vector<std::uint32_t>& changedIndices);
+
+    /** Get/set the number of iso-contour levels drawn over the density (zero disables contours, CPU density backend only) */
+    std::uint32_t getNumberOfContourLevels() const;
+    void setNumberOfContourLevels(const std::uint32_t& numberOfContourLevels);
+
+    /**
+     * Get the iso-contours of the current CPU density (extracted once per density and number of levels)
+     * @return Contours in data coordinates (empty when contours are disabled or there is no CPU density)
+     */
+    std::shared_ptr<const Contours> getContours();
+
+    /** Get/set whether a click selects the connected density region under the cursor */
+    bool isDensityRegionSelectionEnabled() const;
+    void setDensityRegionSelectionEnabled(bool densityRegionSelectionEnabled);
+
+    /**
+     * Get the points in the connected density region under \p viewportPosition (CPU density backend only). The region
+     * consists of the cells at or above the clicked density, or at or above the highest contour level below it when
+     * contours are drawn.
+     * @param viewportPosition Position in viewport coordinates
+     * @param localIndices Local indices of the points in the region
+     * @return Whether there is a region under \p viewportPosition
+     */
+    bool getDensityRegionPoints(const QPoint& viewportPosition, std::vector<std::uint32_t>& localIndices);
+
+    /**
+     * Get the full resolution CPU density of the current positions, weights, density source and sigma (regardless of
+     * the density backend, computed synchronously when it is not cached)
+     * @return Density grid which covers the data bounds
+     */
+    std::shared_ptr<const DensityGrid> getDensityGrid();
+
+    /**
+     * Cluster the points by the peaks of the full resolution CPU density (see getDensityGrid)
+     * @param minimumDensity Fraction of the maximum density below which cells are not clustered
+     * @param pointLabels Cluster index per (local) point, DensityPeakClustering::NO_CLUSTER for unclustered points
+     * @return Number of clusters (ordered by descending peak density)
+     */
+    std::int32_t clusterDensityPeaks(const float& minimumDensity, std::vector<std::int32_t>& pointLabels);
+
+    /** Get/set the shape of the aggregate bins */
+    Bins::Shape getBinShape() const;
+    void setBinShape(const Bins::Shape& binShape);
+
+    /** Get/set the number of aggregate bins along the x-axis */
+    std::uint32_t getBinResolution() const;
+    void setBinResolution(const std::uint32_t& binResolution);
+
+    /** Get/set the value per aggregate bin (the mean and median require bin values) */
+    BinAggregator::Statistic getBinStatistic() const;
+    void setBinStatistic(const BinAggregator::Statistic& binStatistic);
+
+    /**
+     * Set the per-point values of which the aggregate bins take the mean/median (e.g. the expression of a gene)
+     * @param values Per-point values (same size as the positions)
+     */
+    void setBinValues(const std::vector<float>& values);
+
+    /** Aggregate the point count again */
+    void clearBinValues();
+
+    /** Get whether there are per-point bin values */
+    bool hasBinValues() const;
+
+    /**
+     * Get the aggregate bins of the current positions (aggregated when one of their inputs changed)
+     * @return Bins which cover the data bounds
+     */
+    std::shared_ptr<const Bins> getBins();
+
+    /** Get/set the mapping of the per-pixel point counts to opacity/color (shaded render mode) */
+    PixelAggregator::Normalization getPixelNormalization() const;
+    void setPixelNormalization(const PixelAggregator::Normalization& pixelNormalization);
+
+    /** Get/set whether the shaded pixels take the mean point color/scalar (otherwise the count is color mapped) */
+    bool getPixelPointColors() const;
+    void setPixelPointColors(bool pixelPointColors);
+
+    /** Get the minimum density (of the current density backend, negative for the difference density) */
+    float getMinDensity() const;
+
+    /** Get the maximum density (of the current density backend) */
+    float getMaxDensity() const;
+
+    /** Get whether OpenGL is implemented in software (e.g. llvmpipe on virtual machines), only valid after initialization */
+    bool isSoftwareRenderer() const;
+
     Bounds getBounds() const {
         return _dataBounds;
     }
@@ -101,13 +285,22 @@ public:
     Vector3f getColorMapRange() const;
     void setColorMapRange(const float& min, const float& max);
 
+    /** Get the exporter which renders the plot into images and files */
+    PlotImageExporter& getImageExporter();
+
+    /**
+     * Get a hash of the data which determines exported images, apart from the color scalars and the color map range (render
+     * mode, color map, data bounds, positions, point colors, selection and point size/opacity sources and mappings)
+     * @return SHA-1 hash
+     */
+    QByteArray getImageDataHash() const;
+
     /**
-     * Create screenshot
-     * @param width Width of the screen shot (in pixels)
-     * @param height Height of the screen shot (in pixels)
-     * @param backgroundColor Background color of the screen shot
+     * Keep copies of the point colors/scalars regardless of the render mode and backend, e.g. during an export (which
+     * might render with the CPU backends); otherwise they are only kept for the shaded render mode and the software point renderer
+     * @param retainPointData Whether to keep copies of the point colors/scalars
      */
-    void createScreenshot(std::int32_t width, std::int32_t height, const QString& fileName, const QColor& backgroundColor);
+    void setRetainPointData(bool retainPointData);
 
 public: // Selection
 
@@ -188,10 +381,186 @@ protected:
     void resizeGL(int w, int h) Q_DECL_OVERRIDE;
     void paintGL()              Q_DECL_OVERRIDE;
     void cleanup();
+
+    /** Record where a potential density region click starts */
+    void mousePressEvent(QMouseEvent* mouseEvent) Q_DECL_OVERRIDE;
+
+    /** Emit densityRegionClicked when the mouse is released (almost) where it was pressed */
+    void mouseReleaseEvent(QMouseEvent* mouseEvent) Q_DECL_OVERRIDE;
+
+    /**
+     * Get whether copies of the point colors/scalars are kept (the shaded render mode, the software point renderer and exports use them)
+     * @return Whether the point colors/scalars are copied when they are set
+     */
+    bool isPointDataRetained() const;
+
+    /**
+     * Release the copies of the point colors/scalars when they are no longer used, or request them when they are needed again
+     * @param pointDataRetained Whether the copies were kept before the render mode, backend or retain flag changed
+     */
+    void updatePointDataRetention(bool pointDataRetained);
+
+    /** Render the points into the point layer again in the next frame (their inputs changed) */
+    void updatePointLayer();
+
+    /** Make the OpenGL context current when OpenGL is initialized (the point renderer uploads per-point data right away) */
+    void makePointRendererCurrent();
+
+    /**
+     * Draw the points of the OpenGL point backend: the points are rendered into a cached layer (only when their inputs
+     * changed) which is composited over the background, so that overlay changes do not render all points again
+     */
+    void drawPointLayer();
+
+    /**
+     * Draw the CPU density grid as an image into the square (data bounds) area of the viewport
+     * @param painter Painter to draw with
+     * @param viewportSize Size of the viewport
+     */
+    void drawDensityImage(QPainter& painter, const QSize& viewportSize);
+
+    /**
+     * Create an image of a CPU density grid for the current render mode and density source
+     * @param densityGrid Density grid
+     * @param colorMapRange Color map range of the landscape (minimum, maximum, length)
+     * @return Density image
+     */
+    QImage createDensityImage(const DensityGrid& densityGrid, const Vector3f& colorMapRange) const;
+
+    /**
+     * Draw the iso-contours of the CPU density as lines
+     * @param painter Painter to draw with
+     * @param viewportSize Size of the viewport
+     */
+    void drawContours(QPainter& painter, const QSize& viewportSize);
+
+    /**
+     * Draw the aggregate bins, colored with the color map
+     * @param painter Painter to draw with
+     * @param viewportSize Size of the viewport
+     */
+    void drawBins(QPainter& painter, const QSize& viewportSize);
+
+    /**
+     * Draw the points aggregated per pixel of the square (data bounds) area of the viewport
+     * @param painter Painter to draw with (its device pixel ratio determines the pixel grid resolution)
+     * @param viewportSize Size of the viewport
+     */
+    void drawShadedImage(QPainter& painter, const QSize& viewportSize);
+
+    /**
+     * Render the points with the software point renderer and draw them into the viewport
+     * @param painter Painter to draw with (its device pixel ratio determines the image resolution)
+     * @param viewportSize Size of the viewport
+     * @param viewportRegion Part of the viewport which is rendered
+     * @param pointScale Factor for the point sizes (relative point scaling of screenshots)
+     */
+    void drawSoftwarePoints(QPainter& painter, const QSize& viewportSize, const QRect& viewportRegion, const float& pointScale);
+
+    /** Get the per-point attributes for the software point renderer */
+    SoftwarePoints getSoftwarePoints() const;
+
+    /** Get what determines the colors of the shaded pixels (depends on the coloring mode and the last assigned point colors/scalars) */
+    PixelAggregator::Shading getPixelShading() const;
+
+    /** Get whether the render mode shows the density (density or landscape) */
+    bool isDensityRenderMode() const;
+
+    /**
+     * Get the (square) viewport rectangle which covers the data bounds
+     * @param viewportSize Size of the viewport
+     * @return Rectangle centered in the viewport
+     */
+    QRect getDataRectangle(const QSize& viewportSize) const;
+
+    /**
+     * Get the transform from data coordinates to viewport coordinates
+     * @param viewportSize Size of the viewport
+     * @return Transform (the y-axis is flipped)
+     */
+    QTransform getDataToViewportTransform(const QSize& viewportSize) const;
+
+protected: // Density inputs
+
+    /** Inputs the density depends on (the density is recomputed only when they change) */
+    struct DensityInputs {
+        std::uint64_t   _positionsVersion   = 0;                        /** Version of the point positions */
+        std::uint64_t   _weightsVersion     = 0;                        /** Version of the point weights (zero when unweighted) */
+        float           _left               = 0.0f;                     /** Left of the data bounds */
+        float           _right              = 0.0f;                     /** Right of the data bounds */
+        float           _bottom             = 0.0f;                     /** Bottom of the data bounds */
+        float           _top                = 0.0f;                     /** Top of the data bounds */
+        float           _sigma              = -1.0f;                    /** Kernel width */
+        DensityBackend  _backend            = DensityBackend::GPU;      /** Where the density is computed */
+        DensitySource   _source             = DensitySource::All;       /** Which points contribute */
+        std::uint64_t   _selectionVersion   = 0;                        /** Version of the selection (zero when the density does not depend on it) */
+
+        bool operator==(const DensityInputs& other) const {
+            return _positionsVersion == other._positionsVersion && _weightsVersion == other._weightsVersion && _left == other._left && _right == other._right && _bottom == other._bottom && _top == other._top && _sigma == other._sigma && _backend == other._backend && _source == other._source && _selectionVersion == other._selectionVersion;
+        }
+    };
+
+    /** Get the current density inputs */
+    DensityInputs getDensityInputs() const;
+
+    /** Get whether the density inputs changed since the density was last computed */
+    bool isDensityOutOfDate() const;
+
+    /** Compute the density if it is out of date (and the render mode needs it) */
+    void updateDensity();
+
+protected: // Aggregate bins
+
+    /** Inputs the aggregate bins depend on (the bins are aggregated again only when they change) */
+    struct BinInputs {
+        std::uint64_t               _positionsVersion   = 0;                                    /** Version of the point positions */
+        std::uint64_t               _valuesVersion      = 0;                                    /** Version of the bin values (zero without values) */
+        float                       _left               = 0.0f;                                 /** Left of the data bounds */
+        float                       _right              = 0.0f;                                 /** Right of the data bounds */
+        float                       _bottom             = 0.0f;                                 /** Bottom of the data bounds */
+        float                       _top                = 0.0f;                                 /** Top of the data bounds */
+        Bins::Shape                 _shape              = Bins::Shape::Hexagon;                 /** Shape of the bins */
+        std::uint32_t               _resolution         = 0;                                    /** Number of bins along the x-axis */
+        BinAggregator::Statistic    _statistic          = BinAggregator::Statistic::Count;      /** Value per bin */
+
+        bool operator==(const BinInputs& other) const {
+            return _positionsVersion == other._positionsVersion && _valuesVersion == other._valuesVersion && _left == other._left && _right == other._right && _bottom == other._bottom && _top == other._top && _shape == other._shape && _resolution == other._resolution && _statistic == other._statistic;
+        }
+    };
+
+    /** Get the current aggregate bin inputs */
+    BinInputs getBinInputs() const;
+
+protected: // Pixel aggregate
+
+    /** Inputs the pixel aggregate depends on (the points are aggregated again only when they change) */
+    struct PixelAggregateInputs {
+        std::uint64_t               _positionsVersion       = 0;                                    /** Version of the point positions */
+        std::uint64_t               _pointColorsVersion     = 0;                                    /** Version of the point colors/scalars */
+        float                       _left                   = 0.0f;                                 /** Left of the data bounds */
+        float                       _right                  = 0.0f;                                 /** Right of the data bounds */
+        float                       _bottom                 = 0.0f;                                 /** Bottom of the data bounds */
+        float                       _top                    = 0.0f;                                 /** Top of the data bounds */
+        std::uint32_t               _width                  = 0;                                    /** Number of pixels along the x-axis */
+        std::uint32_t               _height                 = 0;                                    /** Number of pixels along the y-axis */
+        PixelAggregator::Shading    _shading                = PixelAggregator::Shading::Count;      /** What determines the pixel colors */
+
+        bool operator==(const PixelAggregateInputs& other) const {
+            return _positionsVersion == other._positionsVersion && _pointColorsVersion == other._pointColorsVersion && _left == other._left && _right == other._right && _bottom == other._bottom && _top == other._top && _width == other._width && _height == other._height && _shading == other._shading;
+        }
+    };
+
+protected: // CPU density
+
+    /** Compute a reduced resolution density now and the full resolution density once the interaction settles (CPU density backend) */
+    void computeInteractiveDensity();
+
+    /** Draw the density of the CPU density computation (resets the landscape color map range and the cached image) */
+    void applyDensityGrid();
     
 public: // Const access to renderers
 
-    const PointRenderer& getPointRenderer() const { 
+    const MappedPointRenderer& getPointRenderer() const {
         return _pointRenderer;
     }
 
@@ -219,12 +588,27 @@ signals:
      */
     void coloringModeChanged(const ColoringMode& coloringMode);
 
-    /** Signals that the density computation has started */
+    /** Signals that the density computation has started (not signaled again until it has ended) */
     void densityComputationStarted();
 
-    /** Signals that the density computation has ended */
+    /** Signals that the density computation has ended (exactly once after it started, also when it was canceled) */
     void densityComputationEnded();
 
+    /** Signals that a new density was computed or taken from the cache (its range might have changed) */
+    void densityChanged();
+
+    /** Signals that the aggregate bins were aggregated again (their value range might have changed) */
+    void binsChanged();
+
+    /** Signals that copies of the point colors/scalars are required (they are not kept while unused), so they have to be set again */
+    void pointDataRequired();
+
+    /**
+     * Signals that a density region was clicked (density region selection only)
+     * @param viewportPosition Clicked position in viewport coordinates
+     */
+    void densityRegionClicked(const QPoint& viewportPosition);
+
 public slots:
     void computeDensity();
 
@@ -236,10 +620,65 @@ private:
     RenderMode              _renderMode = SCATTERPLOT;
     QColor                  _backgroundColor;
     ColoringMode            _coloringMode = ColoringMode::Constant;
-    PointRenderer           _pointRenderer;                     
+    MappedPointRenderer     _pointRenderer;                     /** Renders the points of the OpenGL point backend */
     DensityRenderer         _densityRenderer;                   
     QSize                   _windowSize;                        /** Size of the viewerscatterplot widget */
     Bounds                  _dataBounds;                        /** Bounds of the loaded data */
     QImage                  _colorMapImage;
     PixelSelectionTool      _pixelSelectionTool;
+    const std::vector<Vector2f>*    _positions = nullptr;                   /** Pointer to the point positions (owned by the plugin) */
+    DensityBackend                  _densityBackend = DensityBackend::GPU;  /** Where the density is computed */
+    float                           _sigma = 0.15f;                         /** Kernel width as a fraction of the output square width */
+    std::shared_ptr<const DensityGrid>  _densityGrid;                       /** Density computed by the CPU backend which is drawn (shared with the density cache) */
+    QImage                          _densityImage;                          /** Cached image of the CPU density grid */
+    Vector3f                        _densityColorMapRange;                  /** Color map range of the CPU density landscape (minimum, maximum, length) */
+    bool                            _isSoftwareRenderer = false;            /** Whether OpenGL is implemented in software */
+    std::uint64_t                                   _positionsVersion = 0;                  /** Version of the current point positions (assigned by the plugin) */
+    std::uint32_t                                   _numberOfContourLevels = 0;             /** Number of iso-contour levels */
+    std::shared_ptr<const Contours>                 _contours;                              /** Cached iso-contours */
+    std::shared_ptr<const DensityGrid>              _contoursDensityGrid;                   /** Density grid the cached iso-contours were extracted from */
+    std::uint32_t                                   _contoursNumberOfLevels = 0;            /** Number of levels of the cached iso-contours */
+    QPainterPath                                    _contoursPath;                          /** Cached iso-contours as painter path (data coordinates) */
+    bool                                            _densityRegionSelectionEnabled = false; /** Whether a click selects a density region */
+    bool                                            _pixelSelectionToolSuspended = false;   /** Whether the pixel selection tool was enabled before density region selection suspended it */
+    QPoint                                          _mousePressPosition;                    /** Where the left mouse button was pressed */
+    DensityRegionLabels                             _densityRegionLabels;                   /** Cached connected region labels per level */
+    DensityInputs                                   _computedDensityInputs;                 /** Inputs of the most recently requested density */
+    Bins::Shape                                     _binShape = Bins::Shape::Hexagon;       /** Shape of the aggregate bins */
+    std::uint32_t                                   _binResolution = 64;                    /** Number of aggregate bins along the x-axis */
+    BinAggregator::Statistic                        _binStatistic = BinAggregator::Statistic::Count;    /** Value per aggregate bin */
+    std::vector<float>                              _binValues;                             /** Per-point values of which the bins take the mean/median */
+    std::uint64_t                                   _binValuesVersion = 0;                  /** Version of the bin values (zero without values) */
+    std::uint64_t                                   _numberOfBinValuesUpdates = 0;          /** Number of times bin values were set (source of bin values versions) */
+    std::shared_ptr<const Bins>                     _bins;                                  /** Cached aggregate bins */
+    BinInputs                                       _binsInputs;                            /** Inputs of the cached aggregate bins */
+    Vector3f                                        _binColorMapRange;                      /** Color map range of the aggregate bins (minimum, maximum, length) */
+    std::vector<float>                              _pointScalars;                          /** Per-point color scalars (only kept for the shaded render mode, CPU point backend and exports) */
+    std::vector<std::uint32_t>                      _pointColors;                           /** Per-point colors as 0xRRGGBB (only kept for the shaded render mode, CPU point backend and exports) */
+    PixelAggregator::Shading                        _pointShading = PixelAggregator::Shading::Count;    /** Whether the scalars or the colors were assigned last */
+    bool                                            _retainPointData = false;               /** Whether copies of the point colors/scalars are kept regardless of the render mode and backend */
+    std::uint64_t                                   _pointColorsVersion = 0;                /** Incremented each time point colors/scalars are set */
+    PixelAggregator::Normalization                  _pixelNormalization = PixelAggregator::Normalization::Equalize; /** Mapping of the per-pixel point counts */
+    bool                                            _pixelPointColors = true;               /** Whether shaded pixels take the mean point color/scalar */
+    PixelAggregate                                  _pixelAggregate;                        /** Points aggregated per pixel */
+    PixelAggregateInputs                            _pixelAggregateInputs;                  /** Inputs of the pixel aggregate */
+    QImage                                          _shadedImage;                           /** Cached image of the shaded pixel aggregate */
+    PointBackend                                    _pointBackend = PointBackend::GPU;      /** Where the points are rendered */
+    SoftwarePointSettings                           _softwarePointSettings;                 /** Point appearance settings of the (software and OpenGL) point renderers */
+    const std::vector<float>*                       _pointSizeSources = nullptr;            /** Source scalars of the point size mapping (owned by the point plot action, CPU point backend) */
+    const std::vector<float>*                       _pointOpacitySources = nullptr;         /** Source scalars of the point opacity mapping (owned by the point plot action, CPU point backend) */
+    const std::vector<char>*                        _pointHighlights = nullptr;             /** Selection state per point (owned by the plugin, CPU point backend) */
+    DensityComputation                              _densityComputation;                    /** Computes the density of the CPU density backend in the background */
+    std::unique_ptr<QOpenGLFramebufferObject>       _pointLayerFramebuffer;                 /** Cached point layer of the OpenGL point backend (texture which is composited) */
+    std::unique_ptr<QOpenGLFramebufferObject>       _pointLayerMultisampleFramebuffer;      /** Multisampled framebuffer the points are rendered into (resolved into the point layer) */
+    bool                                            _pointLayerOutOfDate = true;            /** Whether the points have to be rendered into the point layer again */
+    bool                                            _pointLayerPremultiplied = true;        /** Whether the point layer holds premultiplied colors (otherwise it includes the background) */
+    std::unique_ptr<QOpenGLShaderProgram>           _compositeProgram;                      /** Composites the point layer over the background (null when it could not be built) */
+    GLuint                                          _compositeVertexArray = 0;              /** Vertex array of the composite (the vertices are generated in the vertex shader) */
+    PlotImageExporter                               _imageExporter;                         /** Renders the plot into images and files */
+
+    static constexpr std::uint32_t  MAXIMUM_PIXEL_AGGREGATE_SIZE    = 4096;                 /** Maximum number of pixel aggregate cells along each axis */
+    static constexpr std::size_t    HIGHLIGHT_UPLOAD_GAP            = 256;                  /** Unchanged highlights between two changed ones which are uploaded along (saves upload calls) */
+
+    friend class PlotImageExporter;
 };
@@ -0,0 +1,183 @@
+#include "KernelDensityEstimator.h"
+
+#include "renderers/DensityRenderer.h"
+
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QtTest>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+
+using namespace hdps::gui;
+
+/**
+ * Density renderer test class
+ *
+ * Compares the CPU kernel density estimation with the density of the (GPU) density renderer for the same
+ * sigma, so that the mapping of sigma to the kernel (radius of sigma times the resolution, standard deviation
+ * of a third of the radius) stays in line with the density renderer. The density renderer is rendered with an
+ * offscreen context; the tests are skipped when no OpenGL 3.3 core context can be created (e.g. on CI nodes).
+ */
+class DensityRendererTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    /** Create the offscreen OpenGL context and initialize the density renderer (skipped without OpenGL) */
+    void initTestCase();
+
+    /** Release the OpenGL resources */
+    void cleanupTestCase();
+
+    /** Rows with different kernel widths */
+    void kernelMatchesDensityRenderer_data();
+
+    /** The density of a single point has the extent of the density of the density renderer */
+    void kernelMatchesDensityRenderer();
+
+private:
+
+    /**
+     * Get the number of pixels of \p image which differ from the (empty) corner by at least half the largest difference
+     * @param image Rendered density
+     * @return Number of pixels above half the maximum
+     */
+    static std::size_t getHalfMaximumArea(const QImage& image);
+
+    /**
+     * Get the number of cells of \p density with at least half the maximum density
+     * @param density Density grid
+     * @return Number of cells above half the maximum
+     */
+    static std::size_t getHalfMaximumArea(const DensityGrid& density);
+
+private:
+    QOffscreenSurface                   _surface;               /** Surface of the OpenGL context */
+    std::unique_ptr<QOpenGLContext>     _context;               /** Offscreen OpenGL context */
+    std::unique_ptr<DensityRenderer>    _densityRenderer;       /** GPU density renderer */
+    std::vector<Vector2f>               _positions;             /** Single point in the center of the data bounds */
+
+    static constexpr std::uint32_t  RESOLUTION  = KernelDensityEstimator::DEFAULT_RESOLUTION;     /** Density grid and viewport size (the viewport is covered by the data bounds) */
+};
+
+void DensityRendererTest::initTestCase()
+{
+    QSurfaceFormat surfaceFormat;
+
+    surfaceFormat.setVersion(3, 3);
+    surfaceFormat.setProfile(QSurfaceFormat::CoreProfile);
+
+    _surface.setFormat(surfaceFormat);
+    _surface.create();
+
+    _context = std::make_unique<QOpenGLContext>();
+    _context->setFormat(surfaceFormat);
+
+    if (!_context->create() || !_context->makeCurrent(&_surface) || _context->format().version() < qMakePair(3, 3))
+        QSKIP("No OpenGL 3.3 core context available");
+
+    // A single point in the center of a density grid cell
+    const auto cellSize = 2.0f / static_cast<float>(RESOLUTION);
+
+    _positions = { Vector2f(0.5f * cellSize, 0.5f * cellSize) };
+
+    _densityRenderer = std::make_unique<DensityRenderer>(DensityRenderer::RenderMode::DENSITY);
+
+    _densityRenderer->init();
+    _densityRenderer->setBounds(Bounds(-1.0f, 1.0f, -1.0f, 1.0f));
+    _densityRenderer->setData(&_positions);
+    _densityRenderer->resize(QSize(RESOLUTION, RESOLUTION));
+}
+
+void DensityRendererTest::cleanupTestCase()
+{
+    if (_densityRenderer && _context->makeCurrent(&_surface))
+        _densityRenderer->destroy();
+}
+
+void DensityRendererTest::kernelMatchesDensityRenderer_data()
+{
+    QTest::addColumn<float>("sigma");
+
+    QTest::newRow("Narrow") << 0.02f;
+    QTest::newRow("Default") << 0.05f;
+    QTest::newRow("Wide") << 0.15f;
+}
+
+void DensityRendererTest::kernelMatchesDensityRenderer()
+{
+    QFETCH(float, sigma);
+
+    // Render the density of the density renderer into a square viewport which is covered by the data bounds
+    QOpenGLFramebufferObject framebuffer(RESOLUTION, RESOLUTION);
+
+    QVERIFY(framebuffer.bind());
+
+    auto functions = _context->functions();
+
+    functions->glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    functions->glClear(GL_COLOR_BUFFER_BIT);
+
+    _densityRenderer->setSigma(sigma);
+    _densityRenderer->computeDensity();
+    _densityRenderer->render();
+
+    framebuffer.release();
+
+    DensityGrid density;
+
+    KernelDensityEstimator::compute(_positions, Bounds(-1.0f, 1.0f, -1.0f, 1.0f), sigma, RESOLUTION, density);
+
+    // The half maximum area grows with the square of the standard deviation, so a different sigma mapping stands out
+    const auto renderedArea     = static_cast<double>(getHalfMaximumArea(framebuffer.toImage()));
+    const auto estimatedArea    = static_cast<double>(getHalfMaximumArea(density));
+
+    QVERIFY2(renderedArea > 0.0, "The density renderer did not render the density");
+    QVERIFY2(std::abs(renderedArea - estimatedArea) <= 0.15 * renderedArea + 4.0, qPrintable(QString("Half maximum area of %1 cells instead of %2").arg(estimatedArea).arg(renderedArea)));
+}
+
+std::size_t DensityRendererTest::getHalfMaximumArea(const QImage& image)
+{
+    // The density is measured as the difference with the corner (which has no density) so that the color ramp does not matter
+    const auto corner = image.pixel(0, 0);
+
+    const auto getDifference = [&corner](const QRgb& pixel) -> int {
+        return std::max({ std::abs(qRed(pixel) - qRed(corner)), std::abs(qGreen(pixel) - qGreen(corner)), std::abs(qBlue(pixel) - qBlue(corner)), std::abs(qAlpha(pixel) - qAlpha(corner)) });
+    };
+
+    auto maximumDifference = 0;
+
+    for (int y = 0; y < image.height(); y++)
+        for (int x = 0; x < image.width(); x++)
+            maximumDifference = std::max(maximumDifference, getDifference(image.pixel(x, y)));
+
+    if (maximumDifference == 0)
+        return 0;
+
+    std::size_t area = 0;
+
+    for (int y = 0; y < image.height(); y++)
+        for (int x = 0; x < image.width(); x++)
+            if (2 * getDifference(image.pixel(x, y)) >= maximumDifference)
+                area++;
+
+    return area;
+}
+
+std::size_t DensityRendererTest::getHalfMaximumArea(const DensityGrid& density)
+{
+    const auto& values  = density.getValues();
+    const auto maximum  = *std::max_element(values.begin(), values.end());
+
+    return static_cast<std::size_t>(std::count_if(values.begin(), values.end(), [maximum](const float& value) -> bool {
+        return maximum > 0.0f && 2.0f * value >= maximum;
+    }));
+}
+
+QTEST_MAIN(DensityRendererTest)
+
+#include "DensityRendererTest.moc"
@@ -0,0 +1,146 @@
+#include "KernelDensityEstimator.h"
+
+#include <QtMath>
+#include <QtTest>
+
+#include <cmath>
+#include <numeric>
+#include <random>
+
+/**
+ * Kernel density estimator test class
+ *
+ * Regression tests of the CPU kernel density estimation: the smoothed grid must preserve the
+ * total (weighted) point count and a single point must spread out as the analytic Gaussian.
+ */
+class KernelDensityEstimatorTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    /** Binning preserves the number of points and the summed weights */
+    void histogramPreservesMass();
+
+    /** The convolution preserves the total mass of points away from the grid border */
+    void densityPreservesMass();
+
+    /** The density of a single point matches the analytic two-dimensional Gaussian */
+    void singlePointMatchesGaussian();
+
+private:
+
+    /**
+     * Get the sum of all values of \p grid (in double precision)
+     * @param grid Density grid
+     * @return Sum of the values
+     */
+    static double getSum(const DensityGrid& grid);
+
+    /**
+     * Get uniformly distributed positions in the center of the data bounds (away from the grid border)
+     * @param numberOfPoints Number of points
+     * @return Positions
+     */
+    static std::vector<Vector2f> getCenteredPositions(const std::size_t& numberOfPoints);
+
+private:
+    static constexpr std::uint32_t  RESOLUTION  = 256;      /** Number of grid cells along each axis */
+    static constexpr float          SIGMA       = 0.05f;    /** Kernel width as a fraction of the grid width */
+};
+
+double KernelDensityEstimatorTest::getSum(const DensityGrid& grid)
+{
+    const auto& values = grid.getValues();
+
+    return std::accumulate(values.begin(), values.end(), 0.0);
+}
+
+std::vector<Vector2f> KernelDensityEstimatorTest::getCenteredPositions(const std::size_t& numberOfPoints)
+{
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> distribution(-0.5f, 0.5f);
+
+    std::vector<Vector2f> positions(numberOfPoints);
+
+    for (auto& position : positions) {
+        position.x = distribution(generator);
+        position.y = distribution(generator);
+    }
+
+    return positions;
+}
+
+void KernelDensityEstimatorTest::histogramPreservesMass()
+{
+    const auto positions = getCenteredPositions(100000);
+    const Bounds bounds(-1.0f, 1.0f, -1.0f, 1.0f);
+
+    DensityGrid histogram;
+
+    KernelDensityEstimator::computeHistogram(positions, bounds, RESOLUTION, histogram);
+
+    QCOMPARE(getSum(histogram), static_cast<double>(positions.size()));
+
+    // Weighted binning sums the weights instead of counting the points
+    std::vector<float> weights(positions.size());
+
+    for (std::size_t pointIndex = 0; pointIndex < weights.size(); pointIndex++)
+        weights[pointIndex] = static_cast<float>(pointIndex % 4);
+
+    KernelDensityEstimator::computeHistogram(positions, bounds, RESOLUTION, histogram, &weights);
+
+    QCOMPARE(getSum(histogram), std::accumulate(weights.begin(), weights.end(), 0.0));
+}
+
+void KernelDensityEstimatorTest::densityPreservesMass()
+{
+    const auto positions = getCenteredPositions(100000);
+
+    DensityGrid density;
+
+    KernelDensityEstimator::compute(positions, Bounds(-1.0f, 1.0f, -1.0f, 1.0f), SIGMA, RESOLUTION, density);
+
+    const auto numberOfPoints = static_cast<double>(positions.size());
+
+    QVERIFY(std::abs(getSum(density) - numberOfPoints) < 1e-4 * numberOfPoints);
+}
+
+void KernelDensityEstimatorTest::singlePointMatchesGaussian()
+{
+    // Place the point in the center of a cell
+    const auto center = static_cast<std::int64_t>(RESOLUTION / 2);
+    const auto cellSize = 2.0f / static_cast<float>(RESOLUTION);
+    const auto position = Vector2f(-1.0f + (center + 0.5f) * cellSize, -1.0f + (center + 0.5f) * cellSize);
+
+    DensityGrid density;
+
+    KernelDensityEstimator::compute({ position }, Bounds(-1.0f, 1.0f, -1.0f, 1.0f), SIGMA, RESOLUTION, density);
+
+    // The kernel is truncated at three standard deviations (in cells)
+    const auto kernelRadius         = static_cast<std::int64_t>(std::round(SIGMA * RESOLUTION));
+    const auto standardDeviation    = static_cast<double>(kernelRadius) / 3.0;
+    const auto peak                 = 1.0 / (2.0 * M_PI * standardDeviation * standardDeviation);
+
+    for (std::int64_t y = center - kernelRadius - 2; y <= center + kernelRadius + 2; y++) {
+        for (std::int64_t x = center - kernelRadius - 2; x <= center + kernelRadius + 2; x++) {
+            const auto value = static_cast<double>(density.getValue(static_cast<std::uint32_t>(x), static_cast<std::uint32_t>(y)));
+
+            // Nothing spreads beyond the truncated kernel
+            if (std::abs(x - center) > kernelRadius || std::abs(y - center) > kernelRadius) {
+                QCOMPARE(value, 0.0);
+                continue;
+            }
+
+            const auto squaredDistance  = static_cast<double>((x - center) * (x - center) + (y - center) * (y - center));
+            const auto expected         = peak * std::exp(-0.5 * squaredDistance / (standardDeviation * standardDeviation));
+
+            // The truncated kernel is renormalized, which raises it slightly above the analytic Gaussian
+            QVERIFY2(std::abs(value - expected) < 0.01 * peak, qPrintable(QString("Cell (%1, %2): %3 instead of %4").arg(x).arg(y).arg(value).arg(expected)));
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(KernelDensityEstimatorTest)
+
+#include "KernelDensityEstimatorTest.moc"
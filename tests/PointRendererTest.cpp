@@ -0,0 +1,285 @@
+#include "MappedPointRenderer.h"
+#include "SoftwarePointRenderer.h"
+
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QtTest>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <random>
+
+/**
+ * Point renderer test class
+ *
+ * Compares the OpenGL (mapped) point renderer with the software point renderer: both must produce the same
+ * image for the same points and settings, also after only the size/opacity mapping changed (which the OpenGL
+ * renderer applies in the shader, without uploading per-point data). The OpenGL renderer is rendered with an
+ * offscreen context; the tests are skipped when no OpenGL 3.3 core context can be created (e.g. on CI nodes).
+ */
+class PointRendererTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    /** Create the offscreen OpenGL context and upload the points (skipped without OpenGL) */
+    void initTestCase();
+
+    /** Release the OpenGL resources */
+    void cleanupTestCase();
+
+    /** Rows with different point appearance settings */
+    void matchesSoftwareRenderer_data();
+
+    /** The OpenGL point renderer produces the image of the software point renderer */
+    void matchesSoftwareRenderer();
+
+    /** Changing the size/opacity mapping (without uploading per-point data) produces the image of the software point renderer */
+    void mappingChangeMatchesSoftwareRenderer();
+
+private:
+
+    /**
+     * Render the points with the OpenGL point renderer
+     * @param settings Point appearance settings
+     * @return Premultiplied image
+     */
+    QImage renderOpenGL(const SoftwarePointSettings& settings);
+
+    /**
+     * Render the points with the software point renderer
+     * @param settings Point appearance settings
+     * @return Premultiplied image
+     */
+    QImage renderSoftware(const SoftwarePointSettings& settings) const;
+
+    /**
+     * Get the largest channel difference of two images of the same size
+     * @param first First image
+     * @param second Second image
+     * @return Largest channel difference (0 - 255)
+     */
+    static int getMaximumDifference(const QImage& first, const QImage& second);
+
+    /** Get default settings for the test points */
+    SoftwarePointSettings getSettings() const;
+
+private:
+    QOffscreenSurface                   _surface;               /** Surface of the OpenGL context */
+    std::unique_ptr<QOpenGLContext>     _context;               /** Offscreen OpenGL context */
+    MappedPointRenderer                 _renderer;              /** OpenGL point renderer */
+    QImage                              _colorMapImage;         /** One-dimensional color map */
+    std::vector<Vector2f>               _positions;             /** Point positions */
+    std::vector<float>                  _colorScalars;          /** Color scalars */
+    std::vector<float>                  _sizeSources;           /** Source scalars of the point sizes */
+    std::vector<float>                  _opacitySources;        /** Source scalars of the point opacities */
+    std::vector<char>                   _highlights;            /** Selection state per point */
+
+    static constexpr std::int32_t   IMAGE_SIZE          = 256;      /** Width and height of the rendered images */
+    static constexpr std::size_t    NUMBER_OF_POINTS    = 200;      /** Number of test points */
+    static constexpr int            TOLERANCE           = 4;        /** Largest allowed channel difference (the OpenGL renderer blends in bytes) */
+};
+
+void PointRendererTest::initTestCase()
+{
+    QSurfaceFormat surfaceFormat;
+
+    surfaceFormat.setVersion(3, 3);
+    surfaceFormat.setProfile(QSurfaceFormat::CoreProfile);
+
+    _surface.setFormat(surfaceFormat);
+    _surface.create();
+
+    _context = std::make_unique<QOpenGLContext>();
+    _context->setFormat(surfaceFormat);
+
+    if (!_context->create() || !_context->makeCurrent(&_surface) || _context->format().version() < qMakePair(3, 3))
+        QSKIP("No OpenGL 3.3 core context available");
+
+    // Random points with random color, size and opacity scalars, a fifth of them selected
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+    _positions.resize(NUMBER_OF_POINTS);
+    _colorScalars.resize(NUMBER_OF_POINTS);
+    _sizeSources.resize(NUMBER_OF_POINTS);
+    _opacitySources.resize(NUMBER_OF_POINTS);
+    _highlights.resize(NUMBER_OF_POINTS);
+
+    for (std::size_t pointIndex = 0; pointIndex < NUMBER_OF_POINTS; pointIndex++) {
+        _positions[pointIndex]      = Vector2f(distribution(generator), distribution(generator));
+        _colorScalars[pointIndex]   = 10.0f * distribution(generator);
+        _sizeSources[pointIndex]    = distribution(generator);
+        _opacitySources[pointIndex] = distribution(generator);
+        _highlights[pointIndex]     = pointIndex % 5 == 0 ? 1 : 0;
+    }
+
+    // Color map from blue to yellow
+    _colorMapImage = QImage(256, 1, QImage::Format_ARGB32);
+
+    for (int x = 0; x < _colorMapImage.width(); x++)
+        _colorMapImage.setPixel(x, 0, qRgb(x, x, 255 - x));
+
+    // The per-point data is set before and after initialization (pending data is uploaded by init)
+    _renderer.setPositions(_positions);
+    _renderer.setColorScalars(_colorScalars);
+
+    _renderer.init();
+
+    QVERIFY(_renderer.isInitialized());
+
+    _renderer.setSizeSources(_sizeSources);
+    _renderer.setOpacitySources(_opacitySources);
+    _renderer.setHighlights(_highlights);
+    _renderer.setColorMap(_colorMapImage);
+}
+
+void PointRendererTest::cleanupTestCase()
+{
+    if (_context && _context->makeCurrent(&_surface))
+        _renderer.destroy();
+}
+
+void PointRendererTest::matchesSoftwareRenderer_data()
+{
+    QTest::addColumn<int>("selectionDisplayMode");
+    QTest::addColumn<bool>("outlineOverride");
+    QTest::addColumn<bool>("haloEnabled");
+    QTest::addColumn<bool>("mapped");
+
+    QTest::newRow("Constant") << static_cast<int>(PointSelectionDisplayMode::Outline) << true << false << false;
+    QTest::newRow("Mapped outline") << static_cast<int>(PointSelectionDisplayMode::Outline) << true << false << true;
+    QTest::newRow("Mapped outline in point color") << static_cast<int>(PointSelectionDisplayMode::Outline) << false << false << true;
+    QTest::newRow("Mapped halo") << static_cast<int>(PointSelectionDisplayMode::Outline) << true << true << true;
+    QTest::newRow("Mapped selection color") << static_cast<int>(PointSelectionDisplayMode::Override) << true << false << true;
+}
+
+void PointRendererTest::matchesSoftwareRenderer()
+{
+    QFETCH(int, selectionDisplayMode);
+    QFETCH(bool, outlineOverride);
+    QFETCH(bool, haloEnabled);
+    QFETCH(bool, mapped);
+
+    auto settings = getSettings();
+
+    settings._selectionDisplayMode      = static_cast<PointSelectionDisplayMode>(selectionDisplayMode);
+    settings._selectionOutlineOverride  = outlineOverride;
+    settings._selectionHaloEnabled      = haloEnabled;
+
+    // Sizes and opacities from the source scalars and the selection, or constant
+    if (mapped) {
+        settings._sizeMapping       = { 4.0f, 16.0f, 6.0f };
+        settings._opacityMapping    = { 0.2f, 0.6f, 0.2f };
+    }
+    else {
+        settings._sizeMapping       = { 12.0f };
+        settings._opacityMapping    = { 0.5f };
+    }
+
+    const auto difference = getMaximumDifference(renderOpenGL(settings), renderSoftware(settings));
+
+    QVERIFY2(difference <= TOLERANCE, qPrintable(QString("The images differ by %1").arg(difference)));
+}
+
+void PointRendererTest::mappingChangeMatchesSoftwareRenderer()
+{
+    auto settings = getSettings();
+
+    // Render once with the first mapping (the per-point data is not uploaded again below)
+    settings._sizeMapping = { 2.0f, 10.0f, 0.0f };
+
+    renderOpenGL(settings);
+
+    // Only the mapping changes, like when the magnitude or offset is dragged
+    settings._sizeMapping       = { 8.0f, 24.0f, 4.0f };
+    settings._opacityMapping    = { 0.1f, 0.8f, 0.1f };
+
+    const auto difference = getMaximumDifference(renderOpenGL(settings), renderSoftware(settings));
+
+    QVERIFY2(difference <= TOLERANCE, qPrintable(QString("The images differ by %1").arg(difference)));
+}
+
+QImage PointRendererTest::renderOpenGL(const SoftwarePointSettings& settings)
+{
+    QOpenGLFramebufferObjectFormat framebufferFormat;
+
+    framebufferFormat.setInternalTextureFormat(GL_RGBA8);
+
+    QOpenGLFramebufferObject framebuffer(IMAGE_SIZE, IMAGE_SIZE, framebufferFormat);
+
+    if (!framebuffer.bind())
+        return QImage();
+
+    auto functions = _context->functions();
+
+    functions->glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    functions->glClear(GL_COLOR_BUFFER_BIT);
+
+    _renderer.render(settings, QSize(IMAGE_SIZE, IMAGE_SIZE), QRectF(0.0, 0.0, IMAGE_SIZE, IMAGE_SIZE), 1.0f);
+
+    framebuffer.release();
+
+    // The framebuffer holds premultiplied colors
+    return framebuffer.toImage(false).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+QImage PointRendererTest::renderSoftware(const SoftwarePointSettings& settings) const
+{
+    QImage image(IMAGE_SIZE, IMAGE_SIZE, QImage::Format_ARGB32_Premultiplied);
+
+    image.fill(Qt::transparent);
+
+    SoftwarePoints points;
+
+    points._positions       = &_positions;
+    points._colorScalars    = &_colorScalars;
+    points._sizeSources     = &_sizeSources;
+    points._opacitySources  = &_opacitySources;
+    points._highlights      = &_highlights;
+
+    SoftwarePointRenderer::render(points, settings, image, QRectF(0.0, 0.0, IMAGE_SIZE, IMAGE_SIZE), 1.0f);
+
+    return image;
+}
+
+int PointRendererTest::getMaximumDifference(const QImage& first, const QImage& second)
+{
+    if (first.isNull() || first.size() != second.size())
+        return 255;
+
+    auto maximumDifference = 0;
+
+    for (int y = 0; y < first.height(); y++) {
+        const auto firstScanLine    = reinterpret_cast<const QRgb*>(first.constScanLine(y));
+        const auto secondScanLine   = reinterpret_cast<const QRgb*>(second.constScanLine(y));
+
+        for (int x = 0; x < first.width(); x++) {
+            const auto& firstPixel  = firstScanLine[x];
+            const auto& secondPixel = secondScanLine[x];
+
+            maximumDifference = std::max({ maximumDifference, std::abs(qRed(firstPixel) - qRed(secondPixel)), std::abs(qGreen(firstPixel) - qGreen(secondPixel)), std::abs(qBlue(firstPixel) - qBlue(secondPixel)), std::abs(qAlpha(firstPixel) - qAlpha(secondPixel)) });
+        }
+    }
+
+    return maximumDifference;
+}
+
+SoftwarePointSettings PointRendererTest::getSettings() const
+{
+    SoftwarePointSettings settings;
+
+    settings._bounds        = Bounds(-0.1f, 1.1f, -0.1f, 1.1f);
+    settings._effect        = PointEffect::Color;
+    settings._colorMapImage = _colorMapImage;
+    settings._colorMapRange = Vector3f(0.0f, 10.0f, 10.0f);
+
+    return settings;
+}
+
+QTEST_MAIN(PointRendererTest)
+
+#include "PointRendererTest.moc"